@@ -11,6 +11,12 @@ SCAN_DIR ?= package
 TARGET_STAMP:=$(TMP_DIR)/info/.files-$(SCAN_TARGET).stamp
 FILELIST:=$(TMP_DIR)/info/.files-$(SCAN_TARGET)-$(SCAN_COOKIE)
 
+# dump output of each package is kept under the hash of its inputs, so
+# touched but unchanged Makefiles are not dumped again; only the latest
+# dump of each package is kept
+SCAN_CACHE:=$(TMP_DIR)/info/.cache-$(SCAN_TARGET)
+SCAN_HASH:=(md5sum || md5) 2>/dev/null | awk '{print $$$$1}'
+
 ifeq ($(IS_TTY),1)
   define progress
 	printf "\033[M\r$(1)" >&2;
@@ -23,21 +29,29 @@ endif
 
 define PackageDir
   $(TMP_DIR)/.$(SCAN_TARGET): $(TMP_DIR)/info/.$(SCAN_TARGET)-$(1)
-  $(TMP_DIR)/info/.$(SCAN_TARGET)-$(1): $(SCAN_DIR)/$(2)/Makefile $(SCAN_STAMP) $(foreach DEP,$(DEPS_$(SCAN_DIR)/$(2)/Makefile) $(SCAN_DEPS),$(wildcard $(if $(filter /%,$(DEP)),$(DEP),$(SCAN_DIR)/$(2)/$(DEP))))
-	{ \
-		$$(call progress,Collecting $(SCAN_NAME) info: $(SCAN_DIR)/$(2)) \
-		echo Source-Makefile: $(SCAN_DIR)/$(2)/Makefile; \
-		$(NO_TRACE_MAKE) --no-print-dir -r DUMP=1 -C $(SCAN_DIR)/$(2) $(SCAN_MAKEOPTS) 2>/dev/null || { \
-			mkdir -p "$(TOPDIR)/logs/$(SCAN_DIR)/$(2)"; \
-			$(NO_TRACE_MAKE) --no-print-dir -r DUMP=1 -C $(SCAN_DIR)/$(2) $(SCAN_MAKEOPTS) > $(TOPDIR)/logs/$(SCAN_DIR)/$(2)/dump.txt 2>&1; \
-			$$(call progress,ERROR: please fix $(SCAN_DIR)/$(2)/Makefile - see logs/$(SCAN_DIR)/$(2)/dump.txt for details\n) \
-			rm -f $$@; \
-		}; \
-		echo; \
-	} > $$@ || true
+  $(TMP_DIR)/info/.$(SCAN_TARGET)-$(1): $(SCAN_DIR)/$(2)/Makefile $(foreach DEP,$(DEPS_$(SCAN_DIR)/$(2)/Makefile) $(SCAN_DEPS),$(wildcard $(if $(filter /%,$(DEP)),$(DEP),$(SCAN_DIR)/$(2)/$(DEP))))
+	HASH=$$$$( { echo "$(SCAN_DIR)/$(2) $(SCAN_MAKEOPTS)"; cat $$^; } | $(SCAN_HASH) ); \
+	if [ -n "$$$$HASH" -a -f "$(SCAN_CACHE)/$(1)/$$$$HASH" ]; then \
+		cp "$(SCAN_CACHE)/$(1)/$$$$HASH" $$@; \
+	else \
+		{ \
+			$$(call progress,Collecting $(SCAN_NAME) info: $(SCAN_DIR)/$(2)) \
+			echo Source-Makefile: $(SCAN_DIR)/$(2)/Makefile; \
+			$(NO_TRACE_MAKE) --no-print-dir -r DUMP=1 -C $(SCAN_DIR)/$(2) $(SCAN_MAKEOPTS) 2>/dev/null || { \
+				mkdir -p "$(TOPDIR)/logs/$(SCAN_DIR)/$(2)"; \
+				$(NO_TRACE_MAKE) --no-print-dir -r DUMP=1 -C $(SCAN_DIR)/$(2) $(SCAN_MAKEOPTS) > $(TOPDIR)/logs/$(SCAN_DIR)/$(2)/dump.txt 2>&1; \
+				$$(call progress,ERROR: please fix $(SCAN_DIR)/$(2)/Makefile - see logs/$(SCAN_DIR)/$(2)/dump.txt for details\n) \
+				rm -f $$@; \
+			}; \
+			echo; \
+		} > $$@ && [ -n "$$$$HASH" -a -f $$@ ] && \
+		rm -rf "$(SCAN_CACHE)/$(1)" && mkdir -p "$(SCAN_CACHE)/$(1)" && \
+		cp $$@ "$(SCAN_CACHE)/$(1)/$$$$HASH"; \
+	fi || true
 endef
 
 $(FILELIST):
+	mkdir -p $(SCAN_CACHE)
 	rm -f $(TMP_DIR)/info/.files-$(SCAN_TARGET)-*
 	$(call FIND_L, $(SCAN_DIR)) $(SCAN_EXTRA) -mindepth 1 $(if $(SCAN_DEPTH),-maxdepth $(SCAN_DEPTH)) -name Makefile | xargs grep -HE 'call (Build/DefaultTargets|Build(Package|Target)|.+Package)' | sed -e 's#^$(SCAN_DIR)/##' -e 's#/Makefile:.*##' | uniq > $@
 
@@ -65,7 +79,7 @@ $(TARGET_STAMP)::
 		} \
 	)
 
-$(TMP_DIR)/.$(SCAN_TARGET): $(TARGET_STAMP) $(SCAN_STAMP)
+$(TMP_DIR)/.$(SCAN_TARGET): $(TARGET_STAMP)
 	$(call progress,Collecting $(SCAN_NAME) info: merging...)
 	-cat $(FILELIST) | awk '{gsub(/\//, "_", $$0);print "$(TMP_DIR)/info/.$(SCAN_TARGET)-" $$0}' | xargs cat > $@ 2>/dev/null
 	$(call progress,Collecting $(SCAN_NAME) info: done)
@@ -73,4 +87,3 @@ $(TMP_DIR)/.$(SCAN_TARGET): $(TARGET_STAMP) $(SCAN_STAMP)
 
 FORCE:
 .PHONY: FORCE
-.NOTPARALLEL:
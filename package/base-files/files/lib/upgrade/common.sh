@@ -178,11 +178,44 @@ rootfs_type() {
 	/bin/mount | awk '($3 ~ /^\/$/) && ($5 !~ /rootfs/) { print $5 }'
 }
 
+image_probe() { # <source>
+	local from="$1"
+	local probe
+
+	[ -x /sbin/imgprobe ] || return 1
+
+	case "$from" in
+		http://*|ftp://*) probe="$(wget -O- -q "$from" | imgprobe - /tmp/sysupgrade.img)";;
+		*) probe="$(imgprobe "$from" /tmp/sysupgrade.img)";;
+	esac || return 1
+
+	eval "$probe"
+	export IMAGE_SOURCE="$from" IMAGE_FILE IMAGE_CACHED IMAGE_COMPRESSED
+	export IMAGE_SIZE IMAGE_MD5 IMAGE_HEAD
+}
+
+image_release() {
+	[ "$IMAGE_CACHED" = 1 ] && rm -f "$IMAGE_FILE"
+	unset IMAGE_SOURCE IMAGE_FILE IMAGE_CACHED IMAGE_HEAD
+}
+
+# IMAGE_HEAD is valid even if the image was too large to be cached
+image_probed() { # <source> [ <command> ]
+	[ -z "$2" -a -n "$IMAGE_SOURCE" -a "$1" = "$IMAGE_SOURCE" ]
+}
+
 get_image() { # <source> [ <command> ]
 	local from="$1"
 	local conc="$2"
 	local cmd
 
+	# already uncompressed by image_probe, unless the image did not fit
+	# into memory, then it is streamed through the decompressor again
+	image_probed "$@" && [ -n "$IMAGE_FILE" ] && {
+		cat "$IMAGE_FILE"
+		return
+	}
+
 	case "$from" in
 		http://*|ftp://*) cmd="wget -O- -q";;
 		*) cmd="cat";;
@@ -199,10 +232,18 @@ get_image() { # <source> [ <command> ]
 }
 
 get_magic_word() {
+	image_probed "$@" && {
+		echo "${IMAGE_HEAD%${IMAGE_HEAD#????}}"
+		return
+	}
 	(get_image "$@" | dd bs=2 count=1 | hexdump -v -n 2 -e '1/1 "%02x"') 2>/dev/null
 }
 
 get_magic_long() {
+	image_probed "$@" && {
+		echo "${IMAGE_HEAD%${IMAGE_HEAD#????????}}"
+		return
+	}
 	(get_image "$@" | dd bs=4 count=1 | hexdump -v -n 4 -e '1/1 "%02x"') 2>/dev/null
 }
 
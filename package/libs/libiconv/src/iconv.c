@@ -31,6 +31,9 @@
 #define TIS_620     011
 #define JIS_0201    012
 
+/* charmaps are valid as dest charset from here on */
+#define TO_CHARMAP  0100
+
 /* some programs like php need this */
 int _libiconv_version = _LIBICONV_VERSION;
 
@@ -99,7 +102,9 @@ iconv_t iconv_open(const char *to, const char *from)
 	unsigned f, t;
 	int m;
 
-	if ((t = find_charset(to)) > 8)
+	if ((t = find_charset(to)) == 255 && (m = find_charmap(to)) > -1)
+		t = TO_CHARMAP + m;
+	else if (t > 8)
 		return -1;
 
 	if ((f = find_charset(from)) < 255)
@@ -260,12 +265,44 @@ static inline char latin9_translit(wchar_t c)
 	}
 }
 
+static inline int charmap_rev_byte(const struct charmap_rev *rev,
+                                   const unsigned char *map, wchar_t c)
+{
+	uint32_t h = (uint32_t)c * rev->mul;
+	unsigned char b = rev->slot[((h >> 24) + rev->disp[(h >> 16) & 31]) & 255];
+
+	/* unmapped code points hash to arbitrary slots, verify the hit */
+	if (!b || c > 0xfffe || get_16(map + 4 + 2*(b-0x80), 0) != c)
+		return 0;
+
+	return b;
+}
+
+/* length of the leading pure ascii run in s */
+static size_t ascii_run(const unsigned char *s, size_t n)
+{
+	typedef size_t __attribute__((__may_alias__)) word;
+	const size_t high = (size_t)-1 / 0xff * 0x80;
+	const unsigned char *p = s;
+
+	for (; n && ((uintptr_t)p & (sizeof(word)-1)); p++, n--)
+		if (*p & 0x80) return p - s;
+
+	for (; n >= sizeof(word) && !(*(const word *)p & high);
+	     p += sizeof(word), n -= sizeof(word));
+
+	for (; n && !(*p & 0x80); p++, n--);
+
+	return p - s;
+}
+
 size_t iconv(iconv_t cd, char **in, size_t *inb, char **out, size_t *outb)
 {
 	size_t x=0;
 	unsigned char to = (cd>>1)&127;
 	unsigned char from = 255;
 	const unsigned char *map = 0;
+	const struct charmap *tmap = 0;
 	char tmp[MB_LEN_MAX];
 	wchar_t c, d;
 	size_t k, l;
@@ -278,7 +315,22 @@ size_t iconv(iconv_t cd, char **in, size_t *inb, char **out, size_t *outb)
 	else
 		from = cd>>8;
 
+	if (to >= TO_CHARMAP)
+		tmap = &charmaps[to - TO_CHARMAP];
+
 	for (; *inb; *in+=l, *inb-=l) {
+		/* ascii supersets on both sides, copy plain ascii runs as-is */
+		if (from >= UTF_8 && (to == UTF_8 || to == US_ASCII ||
+		                      to == LATIN_1 || to == LATIN_9 || tmap)) {
+			l = ascii_run(*(unsigned char **)in, *inb < *outb ? *inb : *outb);
+			if (l) {
+				memcpy(*out, *in, l);
+				*out += l;
+				*outb -= l;
+				continue;
+			}
+		}
+
 		c = *(unsigned char *)*in;
 		l = 1;
 		if (from >= UTF_8 && c < 0x80) goto charok;
@@ -416,7 +468,14 @@ charok:
 			*outb -= 4;
 			break;
 		default:
-			goto badf;
+			if (!tmap) goto badf;
+			if (!*outb) goto toobig;
+			if (c < 0x80) **out = c;
+			else if ((k = charmap_rev_byte(tmap->rev, tmap->map, c))) **out = k;
+			else x++, **out = '*';
+			++*out;
+			--*outb;
+			break;
 		}
 	}
 	return x;
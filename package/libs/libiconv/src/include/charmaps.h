@@ -1,3 +1,10 @@
+/* reverse (unicode -> byte) lookup, see mkrevmap.pl */
+struct charmap_rev {
+	uint32_t mul;
+	unsigned char disp[32];
+	unsigned char slot[256];
+};
+
 #include "charmaps/iso-8859-2.h"
 #include "charmaps/iso-8859-10.h"
 #include "charmaps/windows-874.h"
@@ -29,52 +36,53 @@
 struct charmap {
 	const char name[13];
 	const unsigned char *map;
+	const struct charmap_rev *rev;
 };
 
 static struct charmap charmaps[] = {
-	{ "ISO-8859-2",   map_iso_8859_2   },
-	{ "ISO-8859-10",  map_iso_8859_10  },
+	{ "ISO-8859-2",   map_iso_8859_2,    &rev_iso_8859_2   },
+	{ "ISO-8859-10",  map_iso_8859_10,   &rev_iso_8859_10  },
 
 #ifdef ALL_CHARSETS
-	{ "ISO-8859-3",   map_iso_8859_3   },
-	{ "ISO-8859-4",   map_iso_8859_4   },
-	{ "ISO-8859-5",   map_iso_8859_5   },
-	{ "ISO-8859-6",   map_iso_8859_6   },
-	{ "ISO-8859-7",   map_iso_8859_7   },
-	{ "ISO-8859-8",   map_iso_8859_8   },
-	{ "ISO-8859-9",   map_iso_8859_9   },
-	{ "ISO-8859-13",  map_iso_8859_13  },
-	{ "ISO-8859-14",  map_iso_8859_14  },
-	{ "ISO-8859-16",  map_iso_8859_16  },
+	{ "ISO-8859-3",   map_iso_8859_3,    &rev_iso_8859_3   },
+	{ "ISO-8859-4",   map_iso_8859_4,    &rev_iso_8859_4   },
+	{ "ISO-8859-5",   map_iso_8859_5,    &rev_iso_8859_5   },
+	{ "ISO-8859-6",   map_iso_8859_6,    &rev_iso_8859_6   },
+	{ "ISO-8859-7",   map_iso_8859_7,    &rev_iso_8859_7   },
+	{ "ISO-8859-8",   map_iso_8859_8,    &rev_iso_8859_8   },
+	{ "ISO-8859-9",   map_iso_8859_9,    &rev_iso_8859_9   },
+	{ "ISO-8859-13",  map_iso_8859_13,   &rev_iso_8859_13  },
+	{ "ISO-8859-14",  map_iso_8859_14,   &rev_iso_8859_14  },
+	{ "ISO-8859-16",  map_iso_8859_16,   &rev_iso_8859_16  },
 #endif
 
-	{ "WINDOWS-874",  map_windows_874  },
-	{ "WINDOWS-1250", map_windows_1250 },
+	{ "WINDOWS-874",  map_windows_874,   &rev_windows_874  },
+	{ "WINDOWS-1250", map_windows_1250,  &rev_windows_1250 },
 
 #ifdef ALL_CHARSETS
-	{ "WINDOWS-1251", map_windows_1251 },
-	{ "WINDOWS-1252", map_windows_1252 },
-	{ "WINDOWS-1253", map_windows_1253 },
-	{ "WINDOWS-1254", map_windows_1254 },
-	{ "WINDOWS-1255", map_windows_1255 },
-	{ "WINDOWS-1256", map_windows_1256 },
-	{ "WINDOWS-1257", map_windows_1257 },
-	{ "WINDOWS-1258", map_windows_1258 },
+	{ "WINDOWS-1251", map_windows_1251,  &rev_windows_1251 },
+	{ "WINDOWS-1252", map_windows_1252,  &rev_windows_1252 },
+	{ "WINDOWS-1253", map_windows_1253,  &rev_windows_1253 },
+	{ "WINDOWS-1254", map_windows_1254,  &rev_windows_1254 },
+	{ "WINDOWS-1255", map_windows_1255,  &rev_windows_1255 },
+	{ "WINDOWS-1256", map_windows_1256,  &rev_windows_1256 },
+	{ "WINDOWS-1257", map_windows_1257,  &rev_windows_1257 },
+	{ "WINDOWS-1258", map_windows_1258,  &rev_windows_1258 },
 #endif
 
-	{ "KOI8-R",       map_koi8_r       },
+	{ "KOI8-R",       map_koi8_r,        &rev_koi8_r       },
 
 	/* Aliases */
-	{ "LATIN2",       map_iso_8859_2   },
-	{ "LATIN6",       map_iso_8859_10  },
+	{ "LATIN2",       map_iso_8859_2,    &rev_iso_8859_2   },
+	{ "LATIN6",       map_iso_8859_10,   &rev_iso_8859_10  },
 
 #ifdef ALL_CHARSETS
-	{ "ARABIC",       map_iso_8859_6   },
-	{ "CYRILLIC",     map_iso_8859_5   },
-	{ "GREEK",        map_iso_8859_7   },
-	{ "HEBREW",       map_iso_8859_8   },
-	{ "LATIN3",       map_iso_8859_3   },
-	{ "LATIN4",       map_iso_8859_4   },
-	{ "LATIN5",       map_iso_8859_9   },
+	{ "ARABIC",       map_iso_8859_6,    &rev_iso_8859_6   },
+	{ "CYRILLIC",     map_iso_8859_5,    &rev_iso_8859_5   },
+	{ "GREEK",        map_iso_8859_7,    &rev_iso_8859_7   },
+	{ "HEBREW",       map_iso_8859_8,    &rev_iso_8859_8   },
+	{ "LATIN3",       map_iso_8859_3,    &rev_iso_8859_3   },
+	{ "LATIN4",       map_iso_8859_4,    &rev_iso_8859_4   },
+	{ "LATIN5",       map_iso_8859_9,    &rev_iso_8859_9   },
 #endif
 };
@@ -22,3 +22,37 @@ static const unsigned char map_iso_8859_10[] = {
 	0x00, 0xf6, 0x01, 0x69, 0x00, 0xf8, 0x01, 0x73, 0x00, 0xfa, 0x00, 0xfb,
 	0x00, 0xfc, 0x00, 0xfd, 0x00, 0xfe, 0x01, 0x38
 };
+
+/* reverse map, generated by mkrevmap.pl */
+static const struct charmap_rev rev_iso_8859_10 = {
+	0x9e3779b1,
+	{
+		0x00, 0x00, 0x01, 0x00, 0x02, 0x03, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00,
+		0x00, 0x01, 0x01, 0x01, 0x00, 0x03, 0x03, 0x01, 0x10, 0x02, 0x00, 0x03,
+		0x04, 0x02, 0x00, 0x00, 0x04, 0x00, 0x01, 0x04
+	},
+	{
+		0xe9, 0x00, 0x00, 0x00, 0x00, 0xd4, 0x00, 0x00, 0x00, 0x00, 0xf6, 0x9d,
+		0x00, 0xca, 0xe1, 0x90, 0x00, 0x88, 0x00, 0x00, 0x00, 0x00, 0xbc, 0x95,
+		0xee, 0xb7, 0x00, 0x00, 0xf7, 0xa9, 0x00, 0x80, 0x00, 0x00, 0xfb, 0x00,
+		0xc4, 0x8d, 0x00, 0x00, 0xe6, 0x00, 0x00, 0xba, 0x00, 0xa4, 0x00, 0xf3,
+		0x00, 0x9a, 0xd2, 0x00, 0xde, 0x85, 0xa7, 0xb6, 0x00, 0xc0, 0xc9, 0x92,
+		0xeb, 0xa3, 0x00, 0x00, 0xe8, 0x00, 0x00, 0x00, 0xe7, 0xf8, 0xd6, 0x00,
+		0x00, 0x8a, 0xc1, 0xe3, 0xb8, 0xf9, 0x00, 0xb1, 0xce, 0xab, 0x00, 0x00,
+		0x9f, 0xf0, 0x97, 0xa2, 0x82, 0xbe, 0x00, 0xdb, 0x00, 0xfd, 0x00, 0xc6,
+		0x00, 0x00, 0x00, 0x00, 0x8f, 0x00, 0x00, 0x00, 0x00, 0xd3, 0x9c, 0x00,
+		0x00, 0x00, 0xf5, 0x87, 0xec, 0x00, 0x00, 0x00, 0x00, 0xcb, 0x00, 0x00,
+		0xac, 0xed, 0x00, 0x94, 0xf1, 0x00, 0xd7, 0xd8, 0x00, 0x00, 0xfa, 0x00,
+		0xc3, 0x00, 0x8c, 0x00, 0x00, 0x00, 0x00, 0xe5, 0xaa, 0x00, 0x00, 0x99,
+		0xd0, 0xbf, 0xb5, 0x00, 0x84, 0x00, 0x00, 0xdd, 0xa6, 0x00, 0x00, 0x00,
+		0x00, 0x91, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc8, 0x00, 0xd5, 0x9e, 0x00,
+		0xc7, 0x00, 0x00, 0x89, 0xea, 0xd9, 0xe2, 0xa8, 0x00, 0x00, 0xcd, 0xa1,
+		0x96, 0xef, 0x00, 0x00, 0x00, 0x00, 0xb9, 0xda, 0x00, 0xae, 0xfc, 0x00,
+		0xc5, 0x00, 0x00, 0x00, 0x00, 0x8e, 0xb0, 0x00, 0x00, 0x81, 0xb4, 0x9b,
+		0x00, 0x00, 0x00, 0xf2, 0xf4, 0xcc, 0x86, 0xdf, 0x00, 0x00, 0x00, 0xff,
+		0xe0, 0x93, 0xb3, 0x00, 0x00, 0xd1, 0x00, 0xbb, 0x00, 0x00, 0xa0, 0x00,
+		0x00, 0x00, 0xc2, 0x00, 0x00, 0xbd, 0xe4, 0xad, 0x8b, 0x00, 0xcf, 0x00,
+		0x98, 0x00, 0xa5, 0x00, 0xaf, 0x00, 0x83, 0xdc, 0xb2, 0x00, 0x00, 0xfe,
+		0x00, 0x00, 0x00, 0x00
+	}
+};
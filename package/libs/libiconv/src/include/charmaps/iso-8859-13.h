@@ -22,3 +22,37 @@ static const unsigned char map_iso_8859_13[] = {
 	0x00, 0xf6, 0x00, 0xf7, 0x01, 0x73, 0x01, 0x42, 0x01, 0x5b, 0x01, 0x6b,
 	0x00, 0xfc, 0x01, 0x7c, 0x01, 0x7e, 0x20, 0x19
 };
+
+/* reverse map, generated by mkrevmap.pl */
+static const struct charmap_rev rev_iso_8859_13 = {
+	0x9e3779b1,
+	{
+		0x03, 0x00, 0x00, 0x00, 0x09, 0x00, 0x02, 0x00, 0x01, 0x01, 0x01, 0x09,
+		0x01, 0x00, 0x00, 0x00, 0x00, 0x02, 0x01, 0x08, 0x08, 0x02, 0x01, 0x00,
+		0x03, 0x01, 0x0c, 0x01, 0x00, 0x02, 0x00, 0x01
+	},
+	{
+		0xca, 0xf9, 0xe9, 0xb2, 0xba, 0x00, 0x00, 0x90, 0x9d, 0xf6, 0x00, 0x00,
+		0xc6, 0x00, 0x00, 0x00, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0x95,
+		0x00, 0xb7, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0xa2, 0x00, 0x00, 0xc4,
+		0x8d, 0xbf, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x9a, 0xf3,
+		0x00, 0xd4, 0xbc, 0x85, 0xce, 0x00, 0xa7, 0x00, 0xc2, 0xc9, 0xcc, 0x92,
+		0xdd, 0xb4, 0xed, 0xf1, 0x00, 0xe8, 0x00, 0xd6, 0xe1, 0x00, 0x00, 0xb8,
+		0x00, 0x8a, 0xf8, 0x00, 0x9f, 0xac, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x97, 0x00, 0xb9, 0xef, 0xfb, 0xc7, 0x00, 0xa4, 0x00, 0xaa, 0xaf,
+		0x8f, 0x82, 0xff, 0xd9, 0x00, 0xb1, 0x00, 0x00, 0xd3, 0x9c, 0x00, 0xf5,
+		0x00, 0x00, 0xbe, 0x87, 0xeb, 0x00, 0x00, 0xa9, 0x00, 0x00, 0x00, 0xfa,
+		0xde, 0x94, 0xa5, 0xb6, 0x00, 0x00, 0xa8, 0x00, 0x00, 0x00, 0x00, 0xf2,
+		0x00, 0x00, 0x00, 0x8c, 0xe5, 0x00, 0xe3, 0x00, 0xd0, 0x00, 0x00, 0x99,
+		0x00, 0xae, 0xbb, 0x00, 0x00, 0x00, 0x00, 0xcd, 0x00, 0x00, 0xa6, 0x00,
+		0x00, 0x00, 0xea, 0xd1, 0x84, 0xb3, 0x00, 0x00, 0x00, 0xd5, 0x91, 0xc1,
+		0x9e, 0xf7, 0xc8, 0x89, 0xd8, 0x00, 0xcf, 0xab, 0xc0, 0x00, 0x00, 0xe6,
+		0x96, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xdb, 0x00, 0x00, 0xa3, 0xfc,
+		0xc5, 0x81, 0x8e, 0x00, 0x00, 0x00, 0xb0, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x9b, 0x00, 0x00, 0xf4, 0xcb, 0x00, 0x86, 0xee, 0x00, 0x00, 0xbd, 0xe2,
+		0x00, 0xec, 0xdf, 0xa1, 0xd2, 0xfd, 0xb5, 0x00, 0xd7, 0x00, 0xda, 0xa0,
+		0x00, 0x93, 0x00, 0x00, 0x00, 0x8b, 0xe4, 0x00, 0x00, 0xad, 0xc3, 0x00,
+		0x98, 0x00, 0x00, 0x00, 0x00, 0xe7, 0x83, 0x00, 0xdc, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00
+	}
+};
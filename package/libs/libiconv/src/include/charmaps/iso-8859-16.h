@@ -22,3 +22,37 @@ static const unsigned char map_iso_8859_16[] = {
 	0x00, 0xf6, 0x01, 0x5b, 0x01, 0x71, 0x00, 0xf9, 0x00, 0xfa, 0x00, 0xfb,
 	0x00, 0xfc, 0x01, 0x19, 0x02, 0x1b, 0x00, 0xff
 };
+
+/* reverse map, generated by mkrevmap.pl */
+static const struct charmap_rev rev_iso_8859_16 = {
+	0x9e3779b1,
+	{
+		0x01, 0x04, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x01, 0x0c, 0x00,
+		0x05, 0x00, 0x00, 0x00, 0x00, 0x01, 0x08, 0x03, 0x04, 0x0b, 0x00, 0x00,
+		0x02, 0x01, 0x00, 0x01, 0x06, 0x00, 0x00, 0x00
+	},
+	{
+		0xe9, 0xb3, 0x00, 0x90, 0x00, 0xd4, 0x00, 0xac, 0x9d, 0xf6, 0x00, 0x00,
+		0xdd, 0xf8, 0x00, 0x88, 0x00, 0x00, 0xe1, 0xe3, 0x00, 0x00, 0xb8, 0x95,
+		0xcc, 0xb7, 0xee, 0xd0, 0x00, 0xd9, 0xfe, 0x00, 0x00, 0x80, 0xfb, 0xc4,
+		0x8d, 0xe6, 0x00, 0x00, 0x00, 0x00, 0xa8, 0x00, 0x00, 0x9a, 0x00, 0xf3,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa7, 0x00, 0x00, 0xc9, 0x85, 0x92,
+		0x00, 0xa4, 0xf1, 0x00, 0xaf, 0xeb, 0xd6, 0x00, 0xaa, 0x00, 0x00, 0xf5,
+		0x9f, 0x8a, 0x00, 0x00, 0xb9, 0x00, 0xa2, 0xc1, 0xce, 0x00, 0x00, 0x00,
+		0x97, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc6,
+		0x00, 0xbe, 0xe8, 0xa3, 0xdb, 0xb1, 0x8f, 0x00, 0xd3, 0x9c, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0xd8, 0x00, 0x00, 0xa9, 0x87, 0xc3, 0xcb, 0xf7, 0x00,
+		0xb4, 0xa5, 0xed, 0xb6, 0xe0, 0x00, 0x00, 0x00, 0x94, 0x00, 0x00, 0xbd,
+		0x00, 0x00, 0x8c, 0xfa, 0x00, 0x00, 0xe5, 0xde, 0xa6, 0x00, 0x00, 0x99,
+		0x00, 0xf2, 0xbb, 0x00, 0x84, 0x00, 0x00, 0x00, 0x00, 0xff, 0x00, 0xc8,
+		0x00, 0x91, 0xae, 0xd1, 0x00, 0x00, 0x00, 0x00, 0x00, 0xb2, 0x9e, 0x00,
+		0xd5, 0xea, 0xc0, 0x89, 0xfd, 0xe2, 0x00, 0xab, 0xa1, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0xcd, 0x96, 0x00, 0xf0, 0xda, 0x00, 0x81, 0x00, 0xfc,
+		0x00, 0xef, 0x8e, 0x00, 0xe7, 0x00, 0xb0, 0x00, 0x00, 0x00, 0x00, 0x9b,
+		0xf4, 0xd2, 0x00, 0x00, 0x00, 0x00, 0x86, 0x00, 0x00, 0xdf, 0xd7, 0xca,
+		0x00, 0x93, 0x00, 0xb5, 0xbf, 0xec, 0x00, 0x00, 0x00, 0x00, 0xba, 0x00,
+		0x00, 0xbc, 0x00, 0xa0, 0x8b, 0x00, 0xe4, 0xad, 0xc5, 0x00, 0xf9, 0xcf,
+		0x98, 0x00, 0xc2, 0x00, 0x00, 0x00, 0x83, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0xdc, 0xc7, 0x00, 0x00
+	}
+};
@@ -22,3 +22,37 @@ static const unsigned char map_iso_8859_6[] = {
 	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
 	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
 };
+
+/* reverse map, generated by mkrevmap.pl */
+static const struct charmap_rev rev_iso_8859_6 = {
+	0x9e3779b1,
+	{
+		0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02
+	},
+	{
+		0x00, 0x00, 0x00, 0x00, 0x00, 0xc8, 0x00, 0x00, 0x9d, 0xea, 0x00, 0x00,
+		0x00, 0x88, 0xd5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xe2,
+		0x95, 0x00, 0x00, 0x80, 0xcd, 0x00, 0x00, 0xef, 0x00, 0x00, 0x00, 0x00,
+		0x8d, 0xda, 0x00, 0x00, 0x00, 0x00, 0xc5, 0x00, 0x00, 0x00, 0xe7, 0x9a,
+		0x00, 0x00, 0x00, 0x85, 0xd2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x92, 0x00, 0x00, 0x00, 0x00, 0xca, 0x00, 0x00, 0x9f, 0x00, 0xec, 0x00,
+		0x00, 0x8a, 0xd7, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc2, 0x00, 0x97, 0xe4,
+		0x00, 0x00, 0x00, 0x00, 0x82, 0x00, 0x00, 0xcf, 0xf1, 0xa4, 0x00, 0x00,
+		0x8f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc7, 0x00, 0x9c, 0xe9, 0x00,
+		0x00, 0x00, 0x00, 0x87, 0xd4, 0x00, 0x00, 0x00, 0x00, 0xbf, 0x00, 0x00,
+		0xe1, 0x94, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcc, 0x00, 0xee, 0x00, 0x00,
+		0x00, 0x00, 0x8c, 0xd9, 0x00, 0x00, 0x00, 0x00, 0xc4, 0x00, 0x00, 0x99,
+		0xe6, 0x00, 0x00, 0x00, 0x84, 0xd1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x91, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc9, 0x00, 0x00, 0x9e, 0xeb,
+		0x00, 0x00, 0x00, 0x89, 0xd6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc1,
+		0x96, 0xe3, 0x00, 0x00, 0xac, 0x81, 0x00, 0xce, 0x00, 0x00, 0xf0, 0x00,
+		0x00, 0x00, 0x8e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc6, 0x00, 0x9b,
+		0xe8, 0x00, 0x00, 0x00, 0x00, 0xd3, 0x00, 0x86, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x93, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00, 0xcb, 0x00, 0xa0, 0x00,
+		0x00, 0xed, 0x00, 0x00, 0xd8, 0x00, 0x8b, 0xad, 0x00, 0x00, 0x00, 0xc3,
+		0x98, 0xe5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x83, 0xd0, 0x00, 0x00, 0x00,
+		0xf2, 0xbb, 0x00, 0x90
+	}
+};
@@ -22,3 +22,37 @@ static const unsigned char map_iso_8859_8[] = {
 	0x05, 0xe6, 0x05, 0xe7, 0x05, 0xe8, 0x05, 0xe9, 0x05, 0xea, 0xff, 0xff,
 	0xff, 0xff, 0x20, 0x0e, 0x20, 0x0f, 0xff, 0xff
 };
+
+/* reverse map, generated by mkrevmap.pl */
+static const struct charmap_rev rev_iso_8859_8 = {
+	0x9e3779b1,
+	{
+		0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x03, 0x00, 0x02, 0x00, 0x00, 0x01,
+		0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x03,
+		0x00, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00
+	},
+	{
+		0xf4, 0x00, 0xb2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9d, 0x00, 0x00, 0x00,
+		0x00, 0x88, 0xec, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf9, 0x95, 0x00,
+		0x00, 0xb7, 0x00, 0xe4, 0x80, 0x00, 0x00, 0x00, 0xa2, 0x00, 0x00, 0x00,
+		0x8d, 0xf1, 0xdf, 0xaf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9a, 0x00, 0x00,
+		0xbc, 0x00, 0x85, 0x00, 0xfe, 0xe9, 0xa7, 0x00, 0x00, 0x00, 0x00, 0x92,
+		0x00, 0x00, 0xf6, 0xb4, 0xe1, 0x00, 0x00, 0x00, 0x9f, 0x00, 0x00, 0x00,
+		0x00, 0x8a, 0xee, 0x00, 0x00, 0xac, 0x00, 0x00, 0x00, 0x00, 0x97, 0x00,
+		0x00, 0x00, 0xb9, 0xe6, 0x00, 0x82, 0x00, 0xa4, 0x00, 0x00, 0x00, 0x00,
+		0xf3, 0x8f, 0x00, 0x00, 0x00, 0xb1, 0x00, 0x00, 0x00, 0x9c, 0x00, 0x00,
+		0x00, 0xbe, 0x00, 0x87, 0xeb, 0x00, 0xa9, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x94, 0x00, 0xf8, 0xb6, 0x00, 0x00, 0xe3, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0xf0, 0x8c, 0x00, 0x00, 0xae, 0x00, 0x00, 0x00, 0x00, 0x00, 0x99,
+		0x00, 0x00, 0xbb, 0x00, 0xe8, 0x84, 0xfd, 0xa6, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0xf5, 0x91, 0x00, 0xb3, 0x00, 0xe0, 0x00, 0x00, 0x00, 0x9e, 0x00,
+		0x00, 0x00, 0xba, 0x89, 0xed, 0x00, 0x00, 0xab, 0x00, 0x00, 0x00, 0x00,
+		0x96, 0x00, 0xfa, 0xb8, 0x00, 0x81, 0x00, 0xe5, 0x00, 0xa3, 0x00, 0x00,
+		0x00, 0x00, 0x8e, 0xf2, 0x00, 0x00, 0xb0, 0x00, 0x00, 0x00, 0x00, 0x9b,
+		0x00, 0x00, 0xbd, 0x00, 0xea, 0x86, 0x00, 0x00, 0xa8, 0x00, 0x00, 0x00,
+		0x00, 0xf7, 0x93, 0x00, 0x00, 0x00, 0xb5, 0xe2, 0x00, 0x00, 0xa0, 0xaa,
+		0x00, 0x00, 0x00, 0xef, 0x8b, 0x00, 0x00, 0xad, 0x00, 0x00, 0x00, 0x00,
+		0x98, 0x00, 0x00, 0x00, 0x00, 0x00, 0x83, 0x00, 0xe7, 0xa5, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x90
+	}
+};
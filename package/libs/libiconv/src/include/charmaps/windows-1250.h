@@ -22,3 +22,37 @@ static const unsigned char map_windows_1250[] = {
 	0x00, 0xf6, 0x00, 0xf7, 0x01, 0x59, 0x01, 0x6f, 0x00, 0xfa, 0x01, 0x71,
 	0x00, 0xfc, 0x00, 0xfd, 0x01, 0x63, 0x02, 0xd9
 };
+
+/* reverse map, generated by mkrevmap.pl */
+static const struct charmap_rev rev_windows_1250 = {
+	0x9e3779b1,
+	{
+		0x00, 0x02, 0x03, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x04,
+		0x00, 0x02, 0x01, 0x00, 0x02, 0x01, 0x0c, 0x00, 0x00, 0x00, 0x02, 0x04,
+		0x09, 0x00, 0x00, 0x08, 0x00, 0x11, 0x00, 0x03
+	},
+	{
+		0xc7, 0xb3, 0x00, 0x00, 0x00, 0x8d, 0x00, 0xd4, 0xbd, 0x82, 0xf6, 0x8f,
+		0x00, 0x00, 0xca, 0xfb, 0xe1, 0xe9, 0xe3, 0x00, 0xe5, 0x00, 0x9e, 0xee,
+		0xd2, 0xb7, 0x00, 0xd0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc4, 0xc0,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x9a, 0x8b, 0x99, 0x00, 0xf3, 0x00,
+		0x00, 0x00, 0x00, 0xd9, 0x00, 0x00, 0x00, 0x00, 0xa7, 0x00, 0xc9, 0xf8,
+		0xeb, 0x93, 0xaf, 0x00, 0xf1, 0xb4, 0xe8, 0x00, 0x80, 0xd6, 0x00, 0xf5,
+		0x00, 0xcc, 0x00, 0x00, 0x00, 0xac, 0xb9, 0x97, 0x00, 0x00, 0x00, 0xc1,
+		0x87, 0xce, 0x00, 0x00, 0xaa, 0x00, 0x00, 0xa4, 0xfd, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0xa3, 0x92, 0x00, 0x00, 0xd3, 0xfe, 0x00, 0x00, 0x00,
+		0xb1, 0x00, 0x00, 0xdb, 0x00, 0xc5, 0x00, 0xc3, 0x00, 0xa9, 0x9c, 0x85,
+		0xa1, 0x00, 0x8e, 0x84, 0xef, 0xb6, 0x00, 0x00, 0x00, 0xed, 0xfa, 0x00,
+		0x00, 0x00, 0xcb, 0x00, 0xbe, 0xae, 0xe6, 0xff, 0x8a, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0xbb, 0x00, 0x00, 0xdd, 0x00, 0x00, 0x00, 0x89, 0x00, 0x00,
+		0x00, 0x9f, 0xd8, 0xd1, 0xa6, 0x00, 0xc8, 0x9d, 0x00, 0x00, 0x00, 0xf7,
+		0xd5, 0x00, 0xea, 0x00, 0xe2, 0x96, 0x00, 0x00, 0xab, 0x00, 0xcd, 0x00,
+		0xa5, 0x00, 0x86, 0xf2, 0x00, 0xf0, 0xb8, 0x00, 0x00, 0x00, 0x00, 0xe0,
+		0x00, 0x00, 0x00, 0x00, 0x91, 0xe7, 0xfc, 0x9b, 0xb2, 0x00, 0xde, 0xb0,
+		0xda, 0x00, 0x00, 0xf4, 0x00, 0xf9, 0xdf, 0x00, 0xa8, 0x00, 0x8c, 0x00,
+		0x00, 0x00, 0x00, 0x94, 0x00, 0xb5, 0x00, 0x00, 0x00, 0xcf, 0xa0, 0xbf,
+		0xd7, 0x00, 0x00, 0xec, 0xc2, 0xe4, 0x00, 0xbc, 0xc6, 0x00, 0xba, 0x00,
+		0xa2, 0x00, 0x95, 0x00, 0x00, 0x00, 0x00, 0xdc, 0x00, 0x00, 0x00, 0x00,
+		0xad, 0x00, 0x00, 0x00
+	}
+};
@@ -22,3 +22,37 @@ static const unsigned char map_windows_1251[] = {
 	0x04, 0x46, 0x04, 0x47, 0x04, 0x48, 0x04, 0x49, 0x04, 0x4a, 0x04, 0x4b,
 	0x04, 0x4c, 0x04, 0x4d, 0x04, 0x4e, 0x04, 0x4f
 };
+
+/* reverse map, generated by mkrevmap.pl */
+static const struct charmap_rev rev_windows_1251 = {
+	0x9e3779b1,
+	{
+		0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+		0x01, 0x00, 0x00, 0x01, 0x03, 0x01, 0x07, 0x02, 0x0a, 0x00, 0x03, 0x00,
+		0x04, 0x01, 0x02, 0x00, 0x00, 0x00, 0x05, 0x01
+	},
+	{
+		0x00, 0xe4, 0x00, 0x00, 0x82, 0xb3, 0x00, 0x00, 0x00, 0xf1, 0x00, 0xcf,
+		0x00, 0x8c, 0x00, 0x00, 0xdc, 0x00, 0xfe, 0x00, 0xc7, 0x00, 0x00, 0x00,
+		0xe9, 0xb7, 0x80, 0x00, 0x9e, 0x00, 0x00, 0xd4, 0x00, 0x00, 0x00, 0x8f,
+		0x00, 0x00, 0xe1, 0x00, 0xf6, 0x00, 0x99, 0x83, 0x8b, 0x00, 0x00, 0xcc,
+		0x00, 0xaf, 0xee, 0x00, 0x00, 0xd9, 0x00, 0x00, 0xfb, 0xa7, 0xc4, 0x00,
+		0x88, 0x93, 0x00, 0xe6, 0x00, 0x00, 0x00, 0xd1, 0xbc, 0x00, 0xf3, 0x00,
+		0x8d, 0x00, 0x00, 0x97, 0x00, 0xac, 0x00, 0x00, 0xde, 0x00, 0xc9, 0x00,
+		0x87, 0xeb, 0xaa, 0x00, 0x00, 0x00, 0xd6, 0x00, 0xa4, 0xf8, 0x00, 0xc1,
+		0x00, 0x00, 0x92, 0x00, 0xb1, 0x00, 0x00, 0x00, 0xce, 0x00, 0x00, 0xf0,
+		0xe3, 0xbe, 0x00, 0x8a, 0x00, 0x00, 0x85, 0xa9, 0x00, 0xdb, 0xc6, 0xfd,
+		0x00, 0x00, 0x00, 0xe8, 0x84, 0x9c, 0xb6, 0xd3, 0x00, 0xa8, 0xb4, 0x00,
+		0xf5, 0xa1, 0x00, 0x00, 0xe0, 0x00, 0x00, 0x90, 0x00, 0xcb, 0x00, 0x00,
+		0x00, 0x00, 0xbb, 0xae, 0x9f, 0xb2, 0xed, 0xd8, 0x00, 0x89, 0xfa, 0xa6,
+		0xc3, 0x00, 0x00, 0xe5, 0x00, 0x00, 0xbf, 0x00, 0xd0, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x8e, 0x00, 0x00, 0xdd, 0x00, 0xab, 0x00, 0xff, 0xf2, 0x00,
+		0x00, 0xc8, 0x86, 0x96, 0x81, 0x00, 0xea, 0xd5, 0x9d, 0x00, 0x00, 0x00,
+		0xf7, 0x00, 0x00, 0x00, 0xe2, 0x91, 0xc0, 0x9b, 0xb0, 0xb9, 0xba, 0xcd,
+		0x00, 0xef, 0x00, 0xa3, 0x00, 0x00, 0x00, 0xda, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0xc5, 0xfc, 0xe7, 0xa5, 0xb5, 0x00, 0x94, 0xd2, 0x9a, 0xa0,
+		0x00, 0x00, 0xf4, 0x00, 0x00, 0x00, 0x00, 0xad, 0x00, 0xdf, 0x00, 0x00,
+		0xca, 0x00, 0xec, 0x00, 0xbd, 0x00, 0xa2, 0xb8, 0x00, 0x00, 0xd7, 0x00,
+		0x95, 0xc2, 0x00, 0xf9
+	}
+};
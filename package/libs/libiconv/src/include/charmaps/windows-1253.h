@@ -22,3 +22,37 @@ static const unsigned char map_windows_1253[] = {
 	0x03, 0xc6, 0x03, 0xc7, 0x03, 0xc8, 0x03, 0xc9, 0x03, 0xca, 0x03, 0xcb,
 	0x03, 0xcc, 0x03, 0xcd, 0x03, 0xce, 0xff, 0xff
 };
+
+/* reverse map, generated by mkrevmap.pl */
+static const struct charmap_rev rev_windows_1253 = {
+	0x9e3779b1,
+	{
+		0x00, 0x00, 0x00, 0x0b, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+		0x07, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x04, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+	},
+	{
+		0x00, 0xd4, 0xb2, 0x00, 0x82, 0xf6, 0x00, 0xbf, 0x00, 0x00, 0xe1, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xcc, 0x00, 0x00, 0x00, 0xee, 0x00, 0x00, 0x00,
+		0x00, 0xb7, 0x00, 0x00, 0xfb, 0x00, 0xc4, 0x00, 0xd9, 0xe6, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0xd1, 0x00, 0x8b, 0x99, 0xf3, 0x00, 0x00, 0x00, 0x00,
+		0xde, 0x00, 0x00, 0x00, 0x00, 0xc9, 0xa7, 0xbc, 0xeb, 0x00, 0x00, 0xb4,
+		0x80, 0x93, 0x00, 0xd6, 0x00, 0xf8, 0x00, 0x00, 0xc1, 0x00, 0x00, 0xe3,
+		0x00, 0x00, 0x00, 0x97, 0xce, 0x00, 0xac, 0x00, 0xf0, 0x00, 0xb9, 0x00,
+		0x87, 0xdb, 0x00, 0x00, 0x00, 0xfd, 0x00, 0xc6, 0xa4, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x92, 0xd3, 0xb1, 0xe8, 0x00, 0xf5, 0x00, 0xbe, 0x00, 0x85,
+		0xe0, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa9, 0x83, 0x00, 0xed, 0x00, 0xa2,
+		0x00, 0x84, 0xd8, 0xb6, 0x00, 0xcb, 0xfa, 0x00, 0xc3, 0x00, 0x00, 0xe5,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0xae, 0xd0, 0x00, 0xf2, 0x00, 0x00, 0x00,
+		0x00, 0xdd, 0x00, 0xbb, 0x00, 0x00, 0x00, 0xc8, 0x00, 0x89, 0xea, 0xa6,
+		0x00, 0x00, 0x00, 0x00, 0xb3, 0xd5, 0x00, 0x00, 0x00, 0xc0, 0x00, 0x00,
+		0xe2, 0x00, 0xf7, 0x00, 0x00, 0x96, 0xcd, 0x00, 0xab, 0xef, 0x00, 0x00,
+		0xb8, 0x00, 0x00, 0x86, 0x00, 0x00, 0xfc, 0x00, 0xc5, 0xa3, 0x00, 0x00,
+		0xe7, 0x00, 0xda, 0x00, 0x00, 0x91, 0x00, 0x9b, 0xf4, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0xbd, 0xdf, 0x00, 0xb0, 0x00, 0x00, 0xa8, 0x00, 0x00, 0xec,
+		0x00, 0xa1, 0xca, 0x94, 0xd7, 0x00, 0xb5, 0xf9, 0x00, 0x00, 0xc2, 0x00,
+		0x00, 0x00, 0xe4, 0x00, 0x00, 0xa0, 0xcf, 0xad, 0x00, 0x00, 0xf1, 0x00,
+		0xba, 0x00, 0x95, 0xdc, 0xaf, 0x00, 0x00, 0xfe, 0x00, 0xa5, 0xc7, 0x00,
+		0xe9, 0x00, 0x00, 0x00
+	}
+};
@@ -22,3 +22,37 @@ static const unsigned char map_windows_1255[] = {
 	0x05, 0xe6, 0x05, 0xe7, 0x05, 0xe8, 0x05, 0xe9, 0x05, 0xea, 0xff, 0xff,
 	0xff, 0xff, 0x20, 0x0e, 0x20, 0x0f, 0xff, 0xff
 };
+
+/* reverse map, generated by mkrevmap.pl */
+static const struct charmap_rev rev_windows_1255 = {
+	0x85ebca6b,
+	{
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00,
+		0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x00, 0x06,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x01
+	},
+	{
+		0xce, 0x00, 0x00, 0x00, 0xfa, 0x00, 0xae, 0x91, 0xe5, 0x00, 0x00, 0xd0,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xb0, 0xe7, 0x82, 0x00, 0x00, 0xd2,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0xb2, 0x00, 0xe9, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x93, 0x00, 0x00, 0xd4, 0x00, 0xb4, 0x84, 0xeb, 0x00, 0x99, 0x00,
+		0x00, 0x00, 0xc1, 0xd6, 0x00, 0xb6, 0xba, 0xed, 0x86, 0x00, 0xa1, 0x00,
+		0x00, 0x00, 0xc3, 0xd8, 0x00, 0xb8, 0x00, 0xef, 0x00, 0xa3, 0x00, 0x95,
+		0x00, 0x00, 0x8b, 0xc5, 0x83, 0x00, 0x00, 0xf1, 0xa5, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0xc7, 0xfe, 0x00, 0xbc, 0x85, 0xf3, 0xa7, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0xc9, 0x00, 0x00, 0xbe, 0xf5, 0xa4, 0xa9, 0x96, 0xe0, 0x88,
+		0x00, 0x00, 0xcb, 0x00, 0x00, 0x00, 0x00, 0x80, 0xab, 0x00, 0xe2, 0x00,
+		0xf7, 0x00, 0xcd, 0xaa, 0x00, 0x00, 0x00, 0xf9, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0xcf, 0xad, 0x00, 0xe4, 0x00, 0x00, 0x00, 0x00, 0xaf, 0x92, 0xe6,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x89, 0x00, 0xd1, 0x00, 0x00, 0xb1, 0xe8,
+		0x00, 0x00, 0xd3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x94, 0x00, 0x00,
+		0xb3, 0x00, 0xea, 0x00, 0x00, 0xd5, 0xc0, 0xb5, 0x00, 0xec, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xa0, 0x00, 0xc2, 0xb7, 0x87, 0xee, 0x00, 0xa2,
+		0x00, 0xd7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc4, 0x00, 0x00,
+		0xfd, 0x00, 0x00, 0xb9, 0x9b, 0xf0, 0xc6, 0xbb, 0x00, 0xf2, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0xc8, 0x00, 0xa6, 0x00, 0xbd, 0xf4, 0xa8, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xbf, 0x00, 0xf6, 0x00, 0x98, 0x97,
+		0x00, 0xe1, 0x00, 0x00, 0xcc, 0x00, 0x00, 0x00, 0xf8, 0x00, 0xac, 0x00,
+		0xe3, 0x00, 0x00, 0x00
+	}
+};
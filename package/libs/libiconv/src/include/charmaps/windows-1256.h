@@ -22,3 +22,37 @@ static const unsigned char map_windows_1256[] = {
 	0x06, 0x50, 0x00, 0xf7, 0x06, 0x51, 0x00, 0xf9, 0x06, 0x52, 0x00, 0xfb,
 	0x00, 0xfc, 0x20, 0x0e, 0x20, 0x0f, 0x06, 0xd2
 };
+
+/* reverse map, generated by mkrevmap.pl */
+static const struct charmap_rev rev_windows_1256 = {
+	0x9e3779b1,
+	{
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x07, 0x00,
+		0x00, 0x02, 0x01, 0x06, 0x00, 0x01, 0x00, 0x0b, 0x00, 0x01, 0x00, 0x01,
+		0x00, 0x00, 0x02, 0x02, 0x00, 0x01, 0x00, 0x01
+	},
+	{
+		0x82, 0xe9, 0xb2, 0x00, 0x00, 0xc8, 0x00, 0xba, 0xed, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0xd5, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8a, 0x00, 0xde,
+		0xff, 0xb7, 0x00, 0x00, 0x00, 0x8d, 0xcd, 0xf5, 0xfb, 0xa2, 0xee, 0x00,
+		0x00, 0xdb, 0x00, 0xaf, 0x00, 0x8b, 0xc5, 0x00, 0x99, 0x81, 0xe5, 0x00,
+		0x00, 0xbc, 0x00, 0x00, 0xfe, 0x00, 0xa7, 0x00, 0x00, 0xd2, 0x00, 0x00,
+		0xeb, 0x93, 0x80, 0xb4, 0x00, 0xca, 0x9f, 0x00, 0x8e, 0xf1, 0x00, 0x00,
+		0x00, 0x00, 0xd8, 0x97, 0x00, 0xac, 0x00, 0x00, 0xc2, 0x00, 0x00, 0xe1,
+		0x87, 0x00, 0xb9, 0x00, 0x00, 0xcf, 0x8f, 0xa4, 0xf8, 0x00, 0x00, 0x9d,
+		0x00, 0x00, 0x92, 0xe8, 0x00, 0x00, 0xb1, 0x00, 0x00, 0xc7, 0xec, 0x85,
+		0x00, 0xbe, 0x00, 0x00, 0xd4, 0x00, 0x00, 0xa9, 0x83, 0x90, 0xbf, 0xe0,
+		0xdd, 0x84, 0x00, 0xb6, 0x00, 0x00, 0xcc, 0x00, 0x00, 0xf3, 0x00, 0x9c,
+		0x00, 0x00, 0x00, 0xda, 0x00, 0xae, 0x00, 0x00, 0xc4, 0x00, 0x00, 0x00,
+		0xe4, 0x00, 0xbb, 0x00, 0xc0, 0xd1, 0xfd, 0xa6, 0x00, 0x89, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0xea, 0x00, 0x00, 0x00, 0xc9, 0x00, 0x00, 0x00, 0xb3,
+		0xf7, 0xf0, 0x00, 0x00, 0xe2, 0x96, 0xd6, 0x00, 0xab, 0x00, 0xc1, 0x00,
+		0x00, 0xdf, 0x86, 0x00, 0xb8, 0x00, 0xce, 0xaa, 0xef, 0xa3, 0xf6, 0x98,
+		0xfc, 0x00, 0xa1, 0x00, 0x91, 0xe7, 0xb0, 0x9b, 0x00, 0xc6, 0x00, 0x00,
+		0xe6, 0xf4, 0xbd, 0x88, 0x00, 0xd3, 0x00, 0x00, 0xa8, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0xdc, 0x94, 0x00, 0xb5, 0x00, 0x00, 0xcb, 0xd7, 0xa0, 0xf2,
+		0xf9, 0x8c, 0x00, 0x00, 0xd9, 0x00, 0x00, 0x9a, 0xad, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x95, 0xe3, 0xc3, 0x00, 0x00, 0xd0, 0x9e, 0xa5, 0x00, 0xfa,
+		0x00, 0x00, 0x00, 0x00
+	}
+};
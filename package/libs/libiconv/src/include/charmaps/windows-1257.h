@@ -22,3 +22,37 @@ static const unsigned char map_windows_1257[] = {
 	0x00, 0xf6, 0x00, 0xf7, 0x01, 0x73, 0x01, 0x42, 0x01, 0x5b, 0x01, 0x6b,
 	0x00, 0xfc, 0x01, 0x7c, 0x01, 0x7e, 0x02, 0xd9
 };
+
+/* reverse map, generated by mkrevmap.pl */
+static const struct charmap_rev rev_windows_1257 = {
+	0x9e3779b1,
+	{
+		0x00, 0x02, 0x02, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x06, 0x00,
+		0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x01, 0x01, 0x06, 0x02,
+		0x05, 0x00, 0x00, 0x04, 0x01, 0x00, 0x03, 0x00
+	},
+	{
+		0xe9, 0xf9, 0xb2, 0x00, 0x00, 0x82, 0x00, 0x00, 0x00, 0xf6, 0x00, 0x00,
+		0xc6, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0x00,
+		0x00, 0xb7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xc4, 0xa2,
+		0x00, 0x00, 0x00, 0xbf, 0x9d, 0x8b, 0x99, 0x00, 0x00, 0xf0, 0xf3, 0xd4,
+		0xbc, 0xce, 0x00, 0x00, 0x00, 0xed, 0xa7, 0xc2, 0x00, 0xc9, 0x00, 0x00,
+		0xcc, 0x93, 0xdd, 0x00, 0x80, 0xb4, 0xd6, 0xe1, 0xf1, 0xb8, 0xe8, 0x00,
+		0x00, 0x00, 0xf8, 0x97, 0xef, 0xac, 0xe0, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x87, 0x00, 0xc7, 0xfb, 0x00, 0x00, 0xa4, 0xb9, 0x00, 0xaf, 0xaa,
+		0x00, 0x00, 0x00, 0xd9, 0x92, 0x00, 0x00, 0xd3, 0xb1, 0x00, 0x00, 0x85,
+		0x8e, 0xf5, 0xbe, 0xeb, 0x00, 0x00, 0xa9, 0x00, 0x00, 0xfa, 0x00, 0x00,
+		0xde, 0x00, 0xf2, 0xb6, 0x00, 0x00, 0xa8, 0x84, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0xe5, 0x00, 0x00, 0xae, 0xff, 0xd0, 0xe3, 0x00, 0x00,
+		0x00, 0x00, 0xbb, 0x00, 0x00, 0x00, 0x00, 0xcd, 0x00, 0x00, 0x89, 0x00,
+		0xa6, 0xea, 0x00, 0x00, 0x00, 0x00, 0xd1, 0x00, 0xd5, 0xc1, 0xb3, 0xc8,
+		0xf7, 0x00, 0xe6, 0x00, 0xd8, 0x00, 0x96, 0xab, 0xcf, 0x00, 0xc0, 0x00,
+		0x00, 0x00, 0x86, 0x8f, 0x00, 0x00, 0xdb, 0x00, 0x00, 0xa3, 0x00, 0x00,
+		0xc5, 0x00, 0xfc, 0x00, 0x91, 0x00, 0xb0, 0x9b, 0x9e, 0x00, 0xee, 0x00,
+		0x00, 0x00, 0xf4, 0xbd, 0x00, 0x00, 0x00, 0xcb, 0x8d, 0xe2, 0xda, 0xdf,
+		0x00, 0xec, 0x00, 0x00, 0xd2, 0xb5, 0x94, 0xfd, 0x00, 0x00, 0xd7, 0xa0,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0xe4, 0x00, 0xad, 0x00, 0xc3, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x95, 0x00, 0x00, 0x00, 0xe7, 0xdc, 0x00, 0x00, 0x00,
+		0x00, 0xba, 0x00, 0xca
+	}
+};
@@ -0,0 +1,108 @@
+#!/usr/bin/env perl
+#
+# Generate the reverse (unicode -> byte) lookup tables for the 8-bit
+# charmaps in include/charmaps/ and append them to the headers.
+#
+#   perl mkrevmap.pl include/charmaps/*.h
+#
+# The table is a hash-and-displace perfect hash: a code point c is
+# looked up as
+#
+#   h    = (uint32_t)c * mul
+#   slot = ((h >> 24) + disp[(h >> 16) & 31]) & 255
+#
+# and slot[] holds the byte that maps to c, or 0 if c is not mapped.
+# The result must still be checked against the forward map, since
+# unmapped code points land on arbitrary slots.
+#
+use strict;
+use warnings;
+
+my @multipliers = (
+	0x9E3779B1, 0x85EBCA6B, 0xC2B2AE35, 0x27D4EB2F,
+	0x165667B1, 0xD3A2646C, 0xFD7046C5, 0xB55A4F09
+);
+
+sub build($@) {
+	my ($mul, @codes) = @_;
+	my (@buckets, @disp, @slot);
+
+	for my $i (0 .. 127) {
+		next unless defined $codes[$i];
+		my $h = ($codes[$i] * $mul) & 0xFFFFFFFF;
+		push @{$buckets[($h >> 16) & 31]}, [ $h >> 24, $i + 128 ];
+	}
+
+	@disp = (0) x 32;
+	@slot = (0) x 256;
+
+	# place the largest buckets first
+	for my $i (sort { @{$buckets[$b] || []} <=> @{$buckets[$a] || []} } 0 .. 31) {
+		my $keys = $buckets[$i] or next;
+		my $found;
+
+		DISP: for my $d (0 .. 255) {
+			my %used;
+			for my $k (@$keys) {
+				my $s = ($k->[0] + $d) & 255;
+				next DISP if $slot[$s] or $used{$s}++;
+			}
+			$slot[($_->[0] + $d) & 255] = $_->[1] for @$keys;
+			$disp[$i] = $d;
+			$found = 1;
+			last;
+		}
+
+		return unless $found;
+	}
+
+	return (\@disp, \@slot);
+}
+
+sub hexlist(@) {
+	my @v = map { sprintf "0x%02x", $_ } @_;
+	my $out = "";
+	while (my @line = splice @v, 0, 12) {
+		$out .= "\t\t" . join(", ", @line) . ",\n";
+	}
+	$out =~ s/,\n$/\n/;
+	return $out;
+}
+
+foreach my $file (@ARGV) {
+	open my $fh, '<', $file or die "Cannot open $file: $!\n";
+	my $src = do { local $/; <$fh> };
+	close $fh;
+
+	$src =~ s/\n\/\* reverse map, generated by mkrevmap\.pl \*\/.*//s;
+
+	$src =~ /static const unsigned char map_(\w+)\[\] = \{(.*?)\};/s
+		or die "No charmap found in $file\n";
+
+	my $name = $1;
+	my @bytes = map { hex } ($2 =~ /0x([0-9a-fA-F]{2})/g);
+	my (@codes, $disp, $slot, $mul);
+
+	die "$file is not an 8-bit charmap\n" if @bytes != 4 + 2 * 128 or $bytes[0] != 0;
+
+	for my $i (0 .. 127) {
+		my $c = $bytes[4 + 2 * $i] << 8 | $bytes[5 + 2 * $i];
+		$codes[$i] = $c unless $c == 0xFFFF;
+	}
+
+	foreach my $m (@multipliers) {
+		($disp, $slot) = build($m, @codes);
+		$mul = $m, last if $disp;
+	}
+
+	die "Unable to build a reverse map for $file\n" unless $disp;
+
+	$src =~ s/\n*$/\n/;
+	$src .= sprintf "\n/* reverse map, generated by mkrevmap.pl */\n" .
+		"static const struct charmap_rev rev_%s = {\n\t0x%08x,\n\t{\n%s\t},\n\t{\n%s\t}\n};\n",
+		$name, $mul, hexlist(@$disp), hexlist(@$slot);
+
+	open $fh, '>', $file or die "Cannot write $file: $!\n";
+	print $fh $src;
+	close $fh;
+}
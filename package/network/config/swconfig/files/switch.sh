@@ -6,7 +6,7 @@ setup_switch_dev() {
 	config_get name "$1" name
 	name="${name:-$1}"
 	[ -d "/sys/class/net/$name" ] && ifconfig "$name" up
-	swconfig dev "$name" load network
+	swconfig dev "$name" update network
 }
 
 setup_switch() {
@@ -39,6 +39,7 @@ enum {
 	CMD_GET,
 	CMD_SET,
 	CMD_LOAD,
+	CMD_UPDATE,
 	CMD_HELP,
 	CMD_SHOW,
 	CMD_PORTMAP,
@@ -63,6 +64,9 @@ print_attrs(const struct switch_attr *attr)
 			case SWITCH_TYPE_NOVAL:
 				type = "none";
 				break;
+			case SWITCH_TYPE_BINARY:
+				type = "binary";
+				break;
 			default:
 				type = "unknown";
 				break;
@@ -104,77 +108,241 @@ print_attr_val(const struct switch_attr *attr, const struct switch_val *val)
 				 SWLIB_PORT_FLAG_TAGGED) ? "t" : "");
 		}
 		break;
+	case SWITCH_TYPE_BINARY:
+		for (i = 0; i < val->len; i++)
+			printf("%02x", (unsigned char) val->value.s[i]);
+		break;
 	default:
 		printf("?unknown-type?");
 	}
 }
 
 static void
-show_attrs(struct switch_dev *dev, struct switch_attr *attr, struct switch_val *val)
+show_attrs(struct switch_dev *dev, struct switch_attr *attr, struct switch_val *val,
+		const struct switch_val *vals)
 {
-	while (attr) {
-		if (attr->type != SWITCH_TYPE_NOVAL) {
-			printf("\t%s: ", attr->name);
-			if (swlib_get_attr(dev, attr, val) < 0)
-				printf("???");
-			else
-				print_attr_val(attr, val);
-			putchar('\n');
-		}
-		attr = attr->next;
+	for (; attr; attr = attr->next, vals = vals ? vals + 1 : NULL) {
+		/* binary values are only useful with "get" */
+		if (attr->type == SWITCH_TYPE_NOVAL ||
+		    attr->type == SWITCH_TYPE_BINARY)
+			continue;
+
+		printf("\t%s: ", attr->name);
+		if (vals ? vals->err < 0 : swlib_get_attr(dev, attr, val) < 0)
+			printf("???");
+		else
+			print_attr_val(attr, vals ? vals : val);
+		putchar('\n');
 	}
 }
 
 static void
-show_global(struct switch_dev *dev)
+show_global(struct switch_dev *dev, const struct switch_val *vals)
 {
 	struct switch_val val;
 
 	printf("Global attributes:\n");
-	show_attrs(dev, dev->ops, &val);
+	show_attrs(dev, dev->ops, &val, vals);
 }
 
 static void
-show_port(struct switch_dev *dev, int port)
+show_port(struct switch_dev *dev, int port, const struct switch_val *vals)
 {
 	struct switch_val val;
 
 	printf("Port %d:\n", port);
 	val.port_vlan = port;
-	show_attrs(dev, dev->port_ops, &val);
+	show_attrs(dev, dev->port_ops, &val, vals);
+}
+
+static int
+attr_index(struct switch_attr *head, struct switch_attr *attr)
+{
+	int i;
+
+	for (i = 0; head; head = head->next, i++)
+		if (head == attr)
+			return i;
+
+	return -1;
 }
 
 static void
-show_vlan(struct switch_dev *dev, int vlan, bool all)
+show_vlan(struct switch_dev *dev, int vlan, bool all, const struct switch_val *vals)
 {
 	struct switch_val val;
 	struct switch_attr *attr;
+	int i;
 
 	val.port_vlan = vlan;
 
 	if (all) {
 		attr = swlib_lookup_attr(dev, SWLIB_ATTR_GROUP_VLAN, "ports");
-		if (swlib_get_attr(dev, attr, &val) < 0)
+		if (vals) {
+			i = attr_index(dev->vlan_ops, attr);
+			if (i < 0 || vals[i].err < 0 || !vals[i].len)
+				return;
+		} else {
+			if (swlib_get_attr(dev, attr, &val) < 0)
+				return;
+
+			if (!val.len)
+				return;
+		}
+	}
+
+	printf("VLAN %d:\n", vlan);
+	show_attrs(dev, dev->vlan_ops, &val, vals);
+}
+
+/* attribute values of the whole switch, fetched with one dump request */
+struct switch_vals {
+	struct switch_dev *dev;
+	int n_global, n_port, n_vlan;
+	struct switch_val *global, *port, *vlan;
+};
+
+static void
+store_val(struct switch_attr *attr, struct switch_val *val, void *arg)
+{
+	struct switch_vals *v = arg;
+	struct switch_val *slot;
+	int i;
+
+	switch (attr->atype) {
+	case SWLIB_ATTR_GROUP_GLOBAL:
+		i = attr_index(v->dev->ops, attr);
+		slot = &v->global[i];
+		break;
+	case SWLIB_ATTR_GROUP_PORT:
+		if (val->port_vlan >= v->dev->ports)
+			return;
+		i = attr_index(v->dev->port_ops, attr);
+		slot = &v->port[val->port_vlan * v->n_port + i];
+		break;
+	case SWLIB_ATTR_GROUP_VLAN:
+		if (val->port_vlan >= v->dev->vlans)
 			return;
+		i = attr_index(v->dev->vlan_ops, attr);
+		slot = &v->vlan[val->port_vlan * v->n_vlan + i];
+		break;
+	default:
+		return;
+	}
 
-		if (!val.len)
+	*slot = *val;
+	if (val->err < 0)
+		return;
+
+	if (attr->type == SWITCH_TYPE_STRING) {
+		slot->value.s = val->value.s ? strdup(val->value.s) : NULL;
+		if (!slot->value.s)
+			slot->err = -ENOMEM;
+	} else if (attr->type == SWITCH_TYPE_PORTS) {
+		slot->value.ports = malloc(sizeof(*val->value.ports) * (val->len + 1));
+		if (!slot->value.ports) {
+			slot->err = -ENOMEM;
 			return;
+		}
+		memcpy(slot->value.ports, val->value.ports,
+			sizeof(*val->value.ports) * val->len);
 	}
+}
 
-	printf("VLAN %d:\n", vlan);
-	show_attrs(dev, dev->vlan_ops, &val);
+static int
+count_attrs(struct switch_attr *attr)
+{
+	int n = 0;
+
+	for (; attr; attr = attr->next)
+		n++;
+
+	return n;
+}
+
+static void
+free_vals(struct switch_val *vals, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		if (vals[i].err < 0 || !vals[i].attr)
+			continue;
+		if (vals[i].attr->type == SWITCH_TYPE_STRING)
+			free((char *) vals[i].value.s);
+		else if (vals[i].attr->type == SWITCH_TYPE_PORTS)
+			free(vals[i].value.ports);
+	}
+	free(vals);
+}
+
+static struct switch_val *
+alloc_vals(int n)
+{
+	struct switch_val *vals;
+	int i;
+
+	vals = calloc(n + 1, sizeof(*vals));
+	if (!vals)
+		return NULL;
+
+	for (i = 0; i < n; i++)
+		vals[i].err = -EINVAL;
+
+	return vals;
+}
+
+static void
+show_all(struct switch_dev *dev)
+{
+	struct switch_vals v;
+	int i;
+
+	memset(&v, 0, sizeof(v));
+	v.dev = dev;
+	v.n_global = count_attrs(dev->ops);
+	v.n_port = count_attrs(dev->port_ops);
+	v.n_vlan = count_attrs(dev->vlan_ops);
+	v.global = alloc_vals(v.n_global);
+	v.port = alloc_vals(dev->ports * v.n_port);
+	v.vlan = alloc_vals(dev->vlans * v.n_vlan);
+
+	/* fall back to one request per value on older kernels */
+	if (!v.global || !v.port || !v.vlan ||
+	    swlib_dump_attrs(dev, store_val, &v) < 0) {
+		show_global(dev, NULL);
+		for (i = 0; i < dev->ports; i++)
+			show_port(dev, i, NULL);
+		for (i = 0; i < dev->vlans; i++)
+			show_vlan(dev, i, true, NULL);
+		goto out;
+	}
+
+	show_global(dev, v.global);
+	for (i = 0; i < dev->ports; i++)
+		show_port(dev, i, &v.port[i * v.n_port]);
+	for (i = 0; i < dev->vlans; i++)
+		show_vlan(dev, i, true, &v.vlan[i * v.n_vlan]);
+
+out:
+	if (v.global)
+		free_vals(v.global, v.n_global);
+	if (v.port)
+		free_vals(v.port, dev->ports * v.n_port);
+	if (v.vlan)
+		free_vals(v.vlan, dev->vlans * v.n_vlan);
 }
 
 static void
 print_usage(void)
 {
 	printf("swconfig list\n");
-	printf("swconfig dev <dev> [port <port>|vlan <vlan>] (help|set <key> <value>|get <key>|load <config>|show)\n");
+	printf("swconfig dev <dev> [port <port>|vlan <vlan>] (help|set <key> <value>|get <key>|load <config>|update <config>|show)\n");
 	exit(1);
 }
 
 static void
-swconfig_load_uci(struct switch_dev *dev, const char *name)
+swconfig_load_uci(struct switch_dev *dev, const char *name, bool update)
 {
 	struct uci_context *ctx;
 	struct uci_package *p = NULL;
@@ -190,7 +358,10 @@ swconfig_load_uci(struct switch_dev *dev, const char *name)
 		goto out;
 	}
 
-	ret = swlib_apply_from_uci(dev, p);
+	if (update)
+		ret = swlib_update_from_uci(dev, p);
+	else
+		ret = swlib_apply_from_uci(dev, p);
 	if (ret < 0)
 		fprintf(stderr, "Failed to apply configuration for switch '%s'\n", dev->dev_name);
 
@@ -252,6 +423,11 @@ int main(int argc, char **argv)
 				print_usage();
 			cmd = CMD_LOAD;
 			ckey = argv[++i];
+		} else if (!strcmp(arg, "update") && i+1 < argc) {
+			if ((cport >= 0) || (cvlan >= 0))
+				print_usage();
+			cmd = CMD_UPDATE;
+			ckey = argv[++i];
 		} else if (!strcmp(arg, "portmap")) {
 			if (i + 1 < argc)
 				csegment = argv[++i];
@@ -324,7 +500,10 @@ int main(int argc, char **argv)
 		putchar('\n');
 		break;
 	case CMD_LOAD:
-		swconfig_load_uci(dev, ckey);
+		swconfig_load_uci(dev, ckey, false);
+		break;
+	case CMD_UPDATE:
+		swconfig_load_uci(dev, ckey, true);
 		break;
 	case CMD_HELP:
 		list_attributes(dev);
@@ -335,15 +514,11 @@ int main(int argc, char **argv)
 	case CMD_SHOW:
 		if (cport >= 0 || cvlan >= 0) {
 			if (cport >= 0)
-				show_port(dev, cport);
+				show_port(dev, cport, NULL);
 			else
-				show_vlan(dev, cvlan, false);
+				show_vlan(dev, cvlan, false, NULL);
 		} else {
-			show_global(dev);
-			for (i=0; i < dev->ports; i++)
-				show_port(dev, i);
-			for (i=0; i < dev->vlans; i++)
-				show_vlan(dev, i, true);
+			show_all(dev);
 		}
 		break;
 	}
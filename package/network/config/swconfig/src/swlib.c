@@ -76,13 +76,12 @@ wait_handler(struct nl_msg *msg, void *arg)
 
 /* helper function for performing netlink requests */
 static int
-swlib_call(int cmd, int (*call)(struct nl_msg *, void *),
+swlib_call_flags(int cmd, int flags, int (*call)(struct nl_msg *, void *),
 		int (*data)(struct nl_msg *, void *), void *arg)
 {
 	struct nl_msg *msg;
 	struct nl_cb *cb = NULL;
 	int finished;
-	int flags = 0;
 	int err;
 
 	msg = nlmsg_alloc();
@@ -117,10 +116,10 @@ swlib_call(int cmd, int (*call)(struct nl_msg *, void *),
 	if (call)
 		nl_cb_set(cb, NL_CB_VALID, NL_CB_CUSTOM, call, arg);
 
-	if (data)
-		nl_cb_set(cb, NL_CB_ACK, NL_CB_CUSTOM, wait_handler, &finished);
-	else
+	if (flags & NLM_F_DUMP)
 		nl_cb_set(cb, NL_CB_FINISH, NL_CB_CUSTOM, wait_handler, &finished);
+	else
+		nl_cb_set(cb, NL_CB_ACK, NL_CB_CUSTOM, wait_handler, &finished);
 
 	err = nl_recvmsgs(handle, cb);
 	if (err < 0) {
@@ -138,6 +137,13 @@ nla_put_failure:
 	return err;
 }
 
+static int
+swlib_call(int cmd, int (*call)(struct nl_msg *, void *),
+		int (*data)(struct nl_msg *, void *), void *arg)
+{
+	return swlib_call_flags(cmd, 0, call, data, arg);
+}
+
 static int
 send_attr(struct nl_msg *msg, void *arg)
 {
@@ -221,6 +227,13 @@ store_val(struct nl_msg *msg, void *arg)
 		val->value.s = strdup(nla_get_string(tb[SWITCH_ATTR_OP_VALUE_STR]));
 	else if (tb[SWITCH_ATTR_OP_VALUE_PORTS])
 		val->err = store_port_val(msg, tb[SWITCH_ATTR_OP_VALUE_PORTS], val);
+	else if (tb[SWITCH_ATTR_OP_VALUE_BINARY]) {
+		val->len = nla_len(tb[SWITCH_ATTR_OP_VALUE_BINARY]);
+		val->value.s = malloc(val->len);
+		if (val->value.s)
+			memcpy((char *) val->value.s,
+				nla_data(tb[SWITCH_ATTR_OP_VALUE_BINARY]), val->len);
+	}
 
 	val->err = 0;
 	return 0;
@@ -350,11 +363,49 @@ swlib_set_attr(struct switch_dev *dev, struct switch_attr *attr, struct switch_v
 	return swlib_call(cmd, NULL, send_attr_val, val);
 }
 
+static int
+swlib_parse_ports(struct switch_dev *dev, const char *str, struct switch_port *ports)
+{
+	char *ptr = (char *)str;
+	int len = 0;
+
+	memset(ports, 0, sizeof(struct switch_port) * dev->ports);
+	while(ptr && *ptr)
+	{
+		while(*ptr && isspace(*ptr))
+			ptr++;
+
+		if (!*ptr)
+			break;
+
+		if (!isdigit(*ptr))
+			return -1;
+
+		if (len >= dev->ports)
+			return -1;
+
+		ports[len].flags = 0;
+		ports[len].id = strtoul(ptr, &ptr, 10);
+		while(*ptr && !isspace(*ptr)) {
+			if (*ptr == 't')
+				ports[len].flags |= SWLIB_PORT_FLAG_TAGGED;
+			else
+				return -1;
+
+			ptr++;
+		}
+		if (*ptr)
+			ptr++;
+		len++;
+	}
+
+	return len;
+}
+
 int swlib_set_attr_string(struct switch_dev *dev, struct switch_attr *a, int port_vlan, const char *str)
 {
 	struct switch_port *ports;
 	struct switch_val val;
-	char *ptr;
 
 	memset(&val, 0, sizeof(val));
 	val.port_vlan = port_vlan;
@@ -367,37 +418,9 @@ int swlib_set_attr_string(struct switch_dev *dev, struct switch_attr *a, int por
 		break;
 	case SWITCH_TYPE_PORTS:
 		ports = alloca(sizeof(struct switch_port) * dev->ports);
-		memset(ports, 0, sizeof(struct switch_port) * dev->ports);
-		val.len = 0;
-		ptr = (char *)str;
-		while(ptr && *ptr)
-		{
-			while(*ptr && isspace(*ptr))
-				ptr++;
-
-			if (!*ptr)
-				break;
-
-			if (!isdigit(*ptr))
-				return -1;
-
-			if (val.len >= dev->ports)
-				return -1;
-
-			ports[val.len].flags = 0;
-			ports[val.len].id = strtoul(ptr, &ptr, 10);
-			while(*ptr && !isspace(*ptr)) {
-				if (*ptr == 't')
-					ports[val.len].flags |= SWLIB_PORT_FLAG_TAGGED;
-				else
-					return -1;
-
-				ptr++;
-			}
-			if (*ptr)
-				ptr++;
-			val.len++;
-		}
+		val.len = swlib_parse_ports(dev, str, ports);
+		if (val.len < 0)
+			return -1;
 		val.value.ports = ports;
 		break;
 	case SWITCH_TYPE_NOVAL:
@@ -411,6 +434,38 @@ int swlib_set_attr_string(struct switch_dev *dev, struct switch_attr *a, int por
 	return swlib_set_attr(dev, a, &val);
 }
 
+int swlib_compare_attr_string(struct switch_dev *dev, struct switch_attr *a,
+		const struct switch_val *val, const char *str)
+{
+	struct switch_port *ports;
+	int len, i, j;
+
+	switch(a->type) {
+	case SWITCH_TYPE_INT:
+		return val->value.i != atoi(str);
+	case SWITCH_TYPE_STRING:
+		return strcmp(val->value.s, str) != 0;
+	case SWITCH_TYPE_PORTS:
+		ports = alloca(sizeof(struct switch_port) * dev->ports);
+		len = swlib_parse_ports(dev, str, ports);
+		if (len != val->len)
+			return 1;
+
+		/* the order of the port list does not matter */
+		for (i = 0; i < len; i++) {
+			for (j = 0; j < val->len; j++) {
+				if (ports[i].id == val->value.ports[j].id)
+					break;
+			}
+			if (j == val->len ||
+			    ports[i].flags != val->value.ports[j].flags)
+				return 1;
+		}
+		return 0;
+	default:
+		return 1;
+	}
+}
 
 struct attrlist_arg {
 	int id;
@@ -498,6 +553,105 @@ swlib_scan(struct switch_dev *dev)
 	return 0;
 }
 
+struct dump_arg {
+	struct switch_dev *dev;
+	struct switch_port *ports;
+	void (*cb)(struct switch_attr *attr, struct switch_val *val, void *arg);
+	void *arg;
+};
+
+static int
+store_dump_val(struct nl_msg *msg, void *ptr)
+{
+	struct genlmsghdr *gnlh = nlmsg_data(nlmsg_hdr(msg));
+	struct dump_arg *arg = ptr;
+	struct switch_attr *attr;
+	struct switch_val val;
+	int id;
+
+	if (nla_parse(tb, SWITCH_ATTR_MAX - 1, genlmsg_attrdata(gnlh, 0),
+			genlmsg_attrlen(gnlh, 0), NULL) < 0)
+		goto done;
+
+	if (!tb[SWITCH_ATTR_OP_ID])
+		goto done;
+
+	memset(&val, 0, sizeof(val));
+	id = nla_get_u32(tb[SWITCH_ATTR_OP_ID]);
+	if (tb[SWITCH_ATTR_OP_PORT]) {
+		attr = arg->dev->port_ops;
+		val.port_vlan = nla_get_u32(tb[SWITCH_ATTR_OP_PORT]);
+	} else if (tb[SWITCH_ATTR_OP_VLAN]) {
+		attr = arg->dev->vlan_ops;
+		val.port_vlan = nla_get_u32(tb[SWITCH_ATTR_OP_VLAN]);
+	} else {
+		attr = arg->dev->ops;
+	}
+
+	while (attr && attr->id != id)
+		attr = attr->next;
+
+	if (!attr)
+		goto done;
+
+	val.attr = attr;
+	val.err = -EINVAL;
+
+	if (tb[SWITCH_ATTR_OP_VALUE_INT]) {
+		val.value.i = nla_get_u32(tb[SWITCH_ATTR_OP_VALUE_INT]);
+		val.err = 0;
+	} else if (tb[SWITCH_ATTR_OP_VALUE_STR]) {
+		val.value.s = nla_get_string(tb[SWITCH_ATTR_OP_VALUE_STR]);
+		val.err = 0;
+	} else if (tb[SWITCH_ATTR_OP_VALUE_PORTS]) {
+		val.value.ports = arg->ports;
+		val.err = store_port_val(msg, tb[SWITCH_ATTR_OP_VALUE_PORTS], &val);
+	} else if (tb[SWITCH_ATTR_OP_VALUE_BINARY]) {
+		val.value.s = nla_data(tb[SWITCH_ATTR_OP_VALUE_BINARY]);
+		val.len = nla_len(tb[SWITCH_ATTR_OP_VALUE_BINARY]);
+		val.err = 0;
+	}
+
+	arg->cb(attr, &val, arg->arg);
+
+done:
+	return NL_SKIP;
+}
+
+static int
+add_dump_id(struct nl_msg *msg, void *ptr)
+{
+	struct dump_arg *arg = ptr;
+
+	NLA_PUT_U32(msg, SWITCH_ATTR_ID, arg->dev->id);
+
+	return 0;
+nla_put_failure:
+	return -1;
+}
+
+int
+swlib_dump_attrs(struct switch_dev *dev,
+		void (*cb)(struct switch_attr *attr, struct switch_val *val, void *arg),
+		void *arg)
+{
+	struct dump_arg darg;
+	int err;
+
+	darg.dev = dev;
+	darg.cb = cb;
+	darg.arg = arg;
+	darg.ports = swlib_alloc(sizeof(struct switch_port) * (dev->ports + 1));
+	if (!darg.ports)
+		return -ENOMEM;
+
+	err = swlib_call_flags(SWITCH_CMD_DUMP_ATTRS, NLM_F_DUMP, store_dump_val,
+			add_dump_id, &darg);
+
+	free(darg.ports);
+	return err;
+}
+
 struct switch_attr *swlib_lookup_attr(struct switch_dev *dev,
 		enum swlib_attr_group atype, const char *name)
 {
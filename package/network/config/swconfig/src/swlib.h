@@ -242,6 +242,30 @@ int swlib_set_attr_string(struct switch_dev *dev, struct switch_attr *attr,
 int swlib_get_attr(struct switch_dev *dev, struct switch_attr *attr,
 		struct switch_val *val);
 
+/**
+ * swlib_compare_attr_string: compare an attribute value with a string
+ * @dev: switch device struct
+ * @attr: switch attribute struct
+ * @val: current value of the attribute
+ * @str: value in the format accepted by swlib_set_attr_string
+ * returns 0 if setting @str would not change the value
+ */
+int swlib_compare_attr_string(struct switch_dev *dev, struct switch_attr *attr,
+		const struct switch_val *val, const char *str);
+
+/**
+ * swlib_dump_attrs: get the values of all attributes with a single request
+ * @dev: switch device struct
+ * @cb: called for every global, port and vlan attribute value
+ * @arg: argument passed to the callback
+ * returns 0 on success, or an error if the kernel does not support it
+ * val->err is set for values that could not be read; string and port
+ * list values are only valid during the callback
+ */
+int swlib_dump_attrs(struct switch_dev *dev,
+		void (*cb)(struct switch_attr *attr, struct switch_val *val, void *arg),
+		void *arg);
+
 /**
  * swlib_apply_from_uci: set up the switch from a uci configuration
  * @dev: switch device struct
@@ -249,4 +273,16 @@ int swlib_get_attr(struct switch_dev *dev, struct switch_attr *attr,
  */
 int swlib_apply_from_uci(struct switch_dev *dev, struct uci_package *p);
 
+/**
+ * swlib_update_from_uci: bring the switch in line with a uci configuration
+ * @dev: switch device struct
+ * @p: uci package which contains the desired global config
+ * Only the attributes that differ from the current switch state are set.
+ * The switch is reset and fully reconfigured as with swlib_apply_from_uci
+ * if the current state cannot be read, if it contains a vlan that is not
+ * configured, or if an option set by the previous load or update has been
+ * removed from the configuration.
+ */
+int swlib_update_from_uci(struct switch_dev *dev, struct uci_package *p);
+
 #endif
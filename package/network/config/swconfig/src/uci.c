@@ -42,6 +42,7 @@ struct swlib_setting {
 	const char *name;
 	int port_vlan;
 	const char *val;
+	bool changed;
 	struct swlib_setting *next;
 };
 
@@ -98,6 +99,7 @@ swlib_map_settings(struct switch_dev *dev, int type, int port_vlan, struct uci_s
 		setting->attr = attr;
 		setting->port_vlan = port_vlan;
 		setting->val = o->v.string;
+		setting->changed = true;
 		*head = setting;
 		head = &setting->next;
 skip:
@@ -105,14 +107,12 @@ skip:
 	}
 }
 
-int swlib_apply_from_uci(struct switch_dev *dev, struct uci_package *p)
+static int
+swlib_map_uci(struct switch_dev *dev, struct uci_package *p)
 {
-	struct switch_attr *attr;
 	struct uci_element *e;
 	struct uci_section *s;
 	struct uci_option *o;
-	struct uci_ptr ptr;
-	struct switch_val val;
 	int i;
 
 	settings = NULL;
@@ -217,30 +217,181 @@ found:
 		}
 	}
 
+	return 0;
+}
+
+static struct swlib_setting *
+swlib_find_setting(struct switch_attr *attr, int port_vlan)
+{
+	struct swlib_setting *st;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(early_settings); i++) {
+		if (early_settings[i].attr == attr)
+			return &early_settings[i];
+	}
+
+	for (st = settings; st; st = st->next) {
+		if (st->attr == attr && st->port_vlan == port_vlan)
+			return st;
+	}
+
+	return NULL;
+}
+
+static void
+swlib_state_file(struct switch_dev *dev, char *buf, int len)
+{
+	snprintf(buf, len, "/var/run/swconfig.%s", dev->dev_name);
+}
+
+/* remember which attributes were set, so that removed options can be found */
+static void
+swlib_save_state(struct switch_dev *dev)
+{
+	struct swlib_setting *st;
+	char path[64];
+	FILE *f;
+	int i;
+
+	swlib_state_file(dev, path, sizeof(path));
+	f = fopen(path, "w");
+	if (!f)
+		return;
+
+	for (i = 0; i < ARRAY_SIZE(early_settings); i++) {
+		st = &early_settings[i];
+		if (st->attr && st->attr->type != SWITCH_TYPE_NOVAL)
+			fprintf(f, "%d %d %s\n", st->attr->atype, 0, st->attr->name);
+	}
+
+	for (st = settings; st; st = st->next)
+		fprintf(f, "%d %d %s\n", st->attr->atype, st->port_vlan, st->attr->name);
+
+	fclose(f);
+}
+
+static bool
+swlib_state_removed(struct switch_dev *dev)
+{
+	struct switch_attr *attr;
+	char path[64], name[64];
+	int atype, port_vlan;
+	bool ret = false;
+	FILE *f;
+
+	swlib_state_file(dev, path, sizeof(path));
+	f = fopen(path, "r");
+	if (!f)
+		return true;
+
+	while (fscanf(f, "%d %d %63s", &atype, &port_vlan, name) == 3) {
+		attr = swlib_lookup_attr(dev, atype, name);
+		if (!attr || !swlib_find_setting(attr, port_vlan)) {
+			ret = true;
+			break;
+		}
+	}
+
+	fclose(f);
+	return ret;
+}
+
+static void
+swlib_diff_val(struct switch_attr *attr, struct switch_val *val, void *arg)
+{
+	bool *reset = arg;
+	struct swlib_setting *st;
+
+	st = swlib_find_setting(attr, val->port_vlan);
+	if (st) {
+		if (!val->err && !swlib_compare_attr_string(attr->dev, attr, val, st->val))
+			st->changed = false;
+		return;
+	}
+
+	/* only a reset clears vlans that are not configured anymore */
+	if (attr->atype == SWLIB_ATTR_GROUP_VLAN && !val->err && val->len &&
+	    !strcmp(attr->name, "ports"))
+		*reset = true;
+}
+
+static void
+swlib_push_settings(struct switch_dev *dev, bool all)
+{
+	struct switch_attr *attr;
+	struct switch_val val;
+	bool changed = all;
+	int i;
+
+	swlib_save_state(dev);
+
 	for (i = 0; i < ARRAY_SIZE(early_settings); i++) {
 		struct swlib_setting *st = &early_settings[i];
 		if (!st->attr || !st->val)
 			continue;
+		if (!all && !st->changed)
+			continue;
 		swlib_set_attr_string(dev, st->attr, st->port_vlan, st->val);
-
+		changed = true;
 	}
 
 	while (settings) {
 		struct swlib_setting *st = settings;
 
-		swlib_set_attr_string(dev, st->attr, st->port_vlan, st->val);
+		if (all || st->changed) {
+			swlib_set_attr_string(dev, st->attr, st->port_vlan, st->val);
+			changed = true;
+		}
 		st = st->next;
 		free(settings);
 		settings = st;
 	}
 
+	if (!changed)
+		return;
+
 	/* Apply the config */
 	attr = swlib_lookup_attr(dev, SWLIB_ATTR_GROUP_GLOBAL, "apply");
 	if (!attr)
-		return 0;
+		return;
 
 	memset(&val, 0, sizeof(val));
 	swlib_set_attr(dev, attr, &val);
+}
+
+int swlib_apply_from_uci(struct switch_dev *dev, struct uci_package *p)
+{
+	if (swlib_map_uci(dev, p) < 0)
+		return -1;
+
+	swlib_push_settings(dev, true);
+
+	return 0;
+}
+
+int swlib_update_from_uci(struct switch_dev *dev, struct uci_package *p)
+{
+	bool reset = false;
+	int i;
+
+	if (swlib_map_uci(dev, p) < 0)
+		return -1;
+
+	for (i = 0; i < ARRAY_SIZE(early_settings); i++) {
+		early_settings[i].changed = true;
+
+		/* the reset is only issued if the switch needs a full reload */
+		if (early_settings[i].attr &&
+		    early_settings[i].attr->type == SWITCH_TYPE_NOVAL)
+			early_settings[i].changed = false;
+	}
+
+	if (swlib_state_removed(dev) ||
+	    swlib_dump_attrs(dev, swlib_diff_val, &reset) < 0)
+		reset = true;
+
+	swlib_push_settings(dev, reset);
 
 	return 0;
 }
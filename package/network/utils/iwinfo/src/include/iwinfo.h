@@ -148,6 +148,13 @@ extern const struct iwinfo_iso3166_label IWINFO_ISO3166_NAMES[];
 #define IWINFO_HARDWARE_FILE	"/usr/share/libiwinfo/hardware.txt"
 
 
+/* Return non-zero from an iterator callback to stop the iteration */
+typedef int (*iwinfo_assoclist_cb)(const struct iwinfo_assoclist_entry *,
+                                   void *);
+typedef int (*iwinfo_scanlist_cb)(const struct iwinfo_scanlist_entry *,
+                                  void *);
+
+
 struct iwinfo_ops {
 	const char *name;
 
@@ -177,6 +184,10 @@ struct iwinfo_ops {
 	int (*scanlist)(const char *, char *, int *);
 	int (*freqlist)(const char *, char *, int *);
 	int (*countrylist)(const char *, char *, int *);
+	int (*assoclist_iter)(const char *, iwinfo_assoclist_cb, void *);
+	int (*scanlist_iter)(const char *, iwinfo_scanlist_cb, void *);
+	int (*scanlist_cached_iter)(const char *, int, iwinfo_scanlist_cb, void *);
+	int (*scan_trigger)(const char *);
 	void (*close)(void);
 };
 
@@ -184,6 +195,14 @@ const char * iwinfo_type(const char *ifname);
 const struct iwinfo_ops * iwinfo_backend(const char *ifname);
 void iwinfo_finish(void);
 
+int iwinfo_assoclist(const struct iwinfo_ops *ops, const char *ifname,
+                     iwinfo_assoclist_cb cb, void *priv);
+int iwinfo_scanlist(const struct iwinfo_ops *ops, const char *ifname,
+                    iwinfo_scanlist_cb cb, void *priv);
+int iwinfo_scanlist_cached(const struct iwinfo_ops *ops, const char *ifname,
+                           int max_age, iwinfo_scanlist_cb cb, void *priv);
+int iwinfo_scan_trigger(const struct iwinfo_ops *ops, const char *ifname);
+
 extern const struct iwinfo_ops wext_ops;
 extern const struct iwinfo_ops madwifi_ops;
 extern const struct iwinfo_ops nl80211_ops;
@@ -76,4 +76,10 @@
 		return iwinfo_L_##op(L, type##_ops.op);			\
 	}
 
+#define LUA_WRAP_ITER_OP(type,op)						\
+	static int iwinfo_L_##type##_##op(lua_State *L)		\
+	{													\
+		return iwinfo_L_##op(L, &type##_ops);			\
+	}
+
 #endif
@@ -26,6 +26,12 @@
 
 #define LOG10_MAGIC	1.25892541179
 
+#ifndef ARRAY_SIZE
+#define ARRAY_SIZE(arr) (sizeof(arr) / sizeof((arr)[0]))
+#endif
+
+#define IWINFO_HARDWARE_CACHE	"/var/run/iwinfo-hwid.%s"
+
 int iwinfo_ioctl(int cmd, void *ifr);
 
 int iwinfo_dbm2mw(int in);
@@ -41,6 +47,10 @@ struct iwinfo_hardware_entry * iwinfo_hardware(struct iwinfo_hardware_id *id);
 
 int iwinfo_hardware_id_from_mtd(struct iwinfo_hardware_id *id);
 
+int iwinfo_hardware_id_cached(const char *phy, struct iwinfo_hardware_id *id);
+void iwinfo_hardware_id_store(const char *phy,
+                              const struct iwinfo_hardware_id *id);
+
 void iwinfo_parse_rsn(struct iwinfo_crypto_entry *c, uint8_t *data, uint8_t len,
 					  uint8_t defcipher, uint8_t defauth);
 
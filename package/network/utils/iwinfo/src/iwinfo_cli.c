@@ -22,7 +22,7 @@
 #include "iwinfo.h"
 
 
-static char * format_bssid(unsigned char *mac)
+static char * format_bssid(const unsigned char *mac)
 {
 	static char buf[18];
 
@@ -32,7 +32,7 @@ static char * format_bssid(unsigned char *mac)
 	return buf;
 }
 
-static char * format_ssid(char *ssid)
+static char * format_ssid(const char *ssid)
 {
 	static char buf[IWINFO_ESSID_MAX_SIZE+3];
 
@@ -194,7 +194,7 @@ static char * format_enc_suites(int suites)
 	return str;
 }
 
-static char * format_encryption(struct iwinfo_crypto_entry *c)
+static char * format_encryption(const struct iwinfo_crypto_entry *c)
 {
 	static char buf[512];
 
@@ -278,7 +278,7 @@ static char * format_hwmodes(int modes)
 	return buf;
 }
 
-static char * format_assocrate(struct iwinfo_rate_entry *r)
+static char * format_assocrate(const struct iwinfo_rate_entry *r)
 {
 	static char buf[40];
 	char *p = buf;
@@ -562,42 +562,50 @@ static void print_info(const struct iwinfo_ops *iw, const char *ifname)
 }
 
 
-static void print_scanlist(const struct iwinfo_ops *iw, const char *ifname)
+static int print_scanlist_entry(const struct iwinfo_scanlist_entry *e,
+                                void *priv)
 {
-	int i, x, len;
-	char buf[IWINFO_BUFSIZE];
-	struct iwinfo_scanlist_entry *e;
+	int *x = priv;
+
+	printf("Cell %02d - Address: %s\n",
+		++*x,
+		format_bssid(e->mac));
+	printf("          ESSID: %s\n",
+		format_ssid((const char *) e->ssid));
+	printf("          Mode: %s  Channel: %s\n",
+		IWINFO_OPMODE_NAMES[e->mode],
+		format_channel(e->channel));
+	printf("          Signal: %s  Quality: %s/%s\n",
+		format_signal(e->signal - 0x100),
+		format_quality(e->quality),
+		format_quality_max(e->quality_max));
+	printf("          Encryption: %s\n\n",
+		format_encryption(&e->crypto));
+
+	return 0;
+}
+
+static void print_scanlist(const struct iwinfo_ops *iw, const char *ifname,
+                           int max_age)
+{
+	int x = 0, rv;
+
+	if (max_age > 0)
+		rv = iwinfo_scanlist_cached(iw, ifname, max_age,
+		                            print_scanlist_entry, &x);
+	else
+		rv = iwinfo_scanlist(iw, ifname, print_scanlist_entry, &x);
 
-	if (iw->scanlist(ifname, buf, &len))
+	if (rv)
 	{
 		printf("Scanning not possible\n\n");
 		return;
 	}
-	else if (len <= 0)
+	else if (x <= 0)
 	{
 		printf("No scan results\n\n");
 		return;
 	}
-
-	for (i = 0, x = 1; i < len; i += sizeof(struct iwinfo_scanlist_entry), x++)
-	{
-		e = (struct iwinfo_scanlist_entry *) &buf[i];
-
-		printf("Cell %02d - Address: %s\n",
-			x,
-			format_bssid(e->mac));
-		printf("          ESSID: %s\n",
-			format_ssid(e->ssid));
-		printf("          Mode: %s  Channel: %s\n",
-			IWINFO_OPMODE_NAMES[e->mode],
-			format_channel(e->channel));
-		printf("          Signal: %s  Quality: %s/%s\n",
-			format_signal(e->signal - 0x100),
-			format_quality(e->quality),
-			format_quality_max(e->quality_max));
-		printf("          Encryption: %s\n\n",
-			format_encryption(&e->crypto));
-	}
 }
 
 
@@ -659,44 +667,46 @@ static void print_freqlist(const struct iwinfo_ops *iw, const char *ifname)
 }
 
 
+static int print_assoclist_entry(const struct iwinfo_assoclist_entry *e,
+                                 void *priv)
+{
+	int *n = priv;
+
+	printf("%s  %s / %s (SNR %d)  %d ms ago\n",
+		format_bssid(e->mac),
+		format_signal(e->signal),
+		format_noise(e->noise),
+		(e->signal - e->noise),
+		e->inactive);
+
+	printf("	RX: %-38s  %8d Pkts.\n",
+		format_assocrate(&e->rx_rate),
+		e->rx_packets
+	);
+
+	printf("	TX: %-38s  %8d Pkts.\n\n",
+		format_assocrate(&e->tx_rate),
+		e->tx_packets
+	);
+
+	(*n)++;
+	return 0;
+}
+
 static void print_assoclist(const struct iwinfo_ops *iw, const char *ifname)
 {
-	int i, len;
-	char buf[IWINFO_BUFSIZE];
-	struct iwinfo_assoclist_entry *e;
+	int n = 0;
 
-	if (iw->assoclist(ifname, buf, &len))
+	if (iwinfo_assoclist(iw, ifname, print_assoclist_entry, &n))
 	{
 		printf("No information available\n");
 		return;
 	}
-	else if (len <= 0)
+	else if (n <= 0)
 	{
 		printf("No station connected\n");
 		return;
 	}
-
-	for (i = 0; i < len; i += sizeof(struct iwinfo_assoclist_entry))
-	{
-		e = (struct iwinfo_assoclist_entry *) &buf[i];
-
-		printf("%s  %s / %s (SNR %d)  %d ms ago\n",
-			format_bssid(e->mac),
-			format_signal(e->signal),
-			format_noise(e->noise),
-			(e->signal - e->noise),
-			e->inactive);
-
-		printf("	RX: %-38s  %8d Pkts.\n",
-			format_assocrate(&e->rx_rate),
-			e->rx_packets
-		);
-
-		printf("	TX: %-38s  %8d Pkts.\n\n",
-			format_assocrate(&e->tx_rate),
-			e->tx_packets
-		);
-	}
 }
 
 
@@ -757,7 +767,8 @@ int main(int argc, char **argv)
 		fprintf(stderr,
 			"Usage:\n"
 			"	iwinfo <device> info\n"
-			"	iwinfo <device> scan\n"
+			"	iwinfo <device> scan [max age in seconds]\n"
+			"	iwinfo <device> rescan\n"
 			"	iwinfo <device> txpowerlist\n"
 			"	iwinfo <device> freqlist\n"
 			"	iwinfo <device> assoclist\n"
@@ -808,7 +819,18 @@ int main(int argc, char **argv)
 			break;
 
 		case 's':
-			print_scanlist(iw, argv[1]);
+			if (i + 1 < argc && isdigit(argv[i + 1][0]))
+				print_scanlist(iw, argv[1], atoi(argv[++i]));
+			else
+				print_scanlist(iw, argv[1], 0);
+			break;
+
+		case 'r':
+			if (iwinfo_scan_trigger(iw, argv[1]))
+			{
+				fprintf(stderr, "Background scan not possible\n");
+				return 1;
+			}
 			break;
 
 		case 't':
@@ -350,6 +350,79 @@ const struct iwinfo_ops * iwinfo_backend(const char *ifname)
 	return NULL;
 }
 
+/*
+ * Pass the associated stations or scan results to the callback one by
+ * one. Backends without a native iterator are read into the fixed size
+ * buffer first.
+ */
+int iwinfo_assoclist(const struct iwinfo_ops *ops, const char *ifname,
+                     iwinfo_assoclist_cb cb, void *priv)
+{
+	int i, len;
+	char buf[IWINFO_BUFSIZE];
+
+	if (ops->assoclist_iter)
+		return ops->assoclist_iter(ifname, cb, priv);
+
+	memset(buf, 0, sizeof(buf));
+
+	if (ops->assoclist(ifname, buf, &len))
+		return -1;
+
+	for (i = 0; i < len; i += sizeof(struct iwinfo_assoclist_entry))
+		if (cb((struct iwinfo_assoclist_entry *) &buf[i], priv))
+			break;
+
+	return 0;
+}
+
+int iwinfo_scanlist(const struct iwinfo_ops *ops, const char *ifname,
+                    iwinfo_scanlist_cb cb, void *priv)
+{
+	int i, len;
+	char buf[IWINFO_BUFSIZE];
+
+	if (ops->scanlist_iter)
+		return ops->scanlist_iter(ifname, cb, priv);
+
+	memset(buf, 0, sizeof(buf));
+
+	if (ops->scanlist(ifname, buf, &len))
+		return -1;
+
+	for (i = 0; i < len; i += sizeof(struct iwinfo_scanlist_entry))
+		if (cb((struct iwinfo_scanlist_entry *) &buf[i], priv))
+			break;
+
+	return 0;
+}
+
+/*
+ * Like iwinfo_scanlist(), but return the results the driver already
+ * knows about if they are at most max_age seconds old. A new scan is
+ * only done if there are none.
+ */
+int iwinfo_scanlist_cached(const struct iwinfo_ops *ops, const char *ifname,
+                           int max_age, iwinfo_scanlist_cb cb, void *priv)
+{
+	if (ops->scanlist_cached_iter)
+		return ops->scanlist_cached_iter(ifname, max_age, cb, priv);
+
+	return iwinfo_scanlist(ops, ifname, cb, priv);
+}
+
+/*
+ * Start a low priority scan and return without waiting for it, the
+ * results are merged into the cache read by iwinfo_scanlist_cached().
+ */
+int iwinfo_scan_trigger(const struct iwinfo_ops *ops, const char *ifname)
+{
+	if (!ops->scan_trigger)
+		return -1;
+
+	return ops->scan_trigger(ifname);
+}
+
 void iwinfo_finish(void)
 {
 	int i;
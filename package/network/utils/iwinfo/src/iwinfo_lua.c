@@ -97,7 +97,7 @@ static char * iwinfo_crypto_print_suites(int suites)
 	return str;
 }
 
-static char * iwinfo_crypto_desc(struct iwinfo_crypto_entry *c)
+static char * iwinfo_crypto_desc(const struct iwinfo_crypto_entry *c)
 {
 	static char desc[512] = { 0 };
 
@@ -171,7 +171,7 @@ static char * iwinfo_crypto_desc(struct iwinfo_crypto_entry *c)
 }
 
 /* Build Lua table from crypto data */
-static void iwinfo_L_cryptotable(lua_State *L, struct iwinfo_crypto_entry *c)
+static void iwinfo_L_cryptotable(lua_State *L, const struct iwinfo_crypto_entry *c)
 {
 	int i, j;
 
@@ -249,77 +249,74 @@ static int iwinfo_L_mode(lua_State *L, int (*func)(const char *, int *))
 }
 
 /* Wrapper for assoclist */
-static int iwinfo_L_assoclist(lua_State *L, int (*func)(const char *, char *, int *))
+static int iwinfo_L_assoclist_entry(const struct iwinfo_assoclist_entry *e,
+                                    void *priv)
 {
-	int i, len;
-	char rv[IWINFO_BUFSIZE];
+	lua_State *L = priv;
 	char macstr[18];
-	const char *ifname = luaL_checkstring(L, 1);
-	struct iwinfo_assoclist_entry *e;
+
+	sprintf(macstr, "%02X:%02X:%02X:%02X:%02X:%02X",
+		e->mac[0], e->mac[1], e->mac[2],
+		e->mac[3], e->mac[4], e->mac[5]);
 
 	lua_newtable(L);
-	memset(rv, 0, sizeof(rv));
 
-	if (!(*func)(ifname, rv, &len))
-	{
-		for (i = 0; i < len; i += sizeof(struct iwinfo_assoclist_entry))
-		{
-			e = (struct iwinfo_assoclist_entry *) &rv[i];
+	lua_pushnumber(L, e->signal);
+	lua_setfield(L, -2, "signal");
 
-			sprintf(macstr, "%02X:%02X:%02X:%02X:%02X:%02X",
-				e->mac[0], e->mac[1], e->mac[2],
-				e->mac[3], e->mac[4], e->mac[5]);
+	lua_pushnumber(L, e->noise);
+	lua_setfield(L, -2, "noise");
 
-			lua_newtable(L);
+	lua_pushnumber(L, e->inactive);
+	lua_setfield(L, -2, "inactive");
 
-			lua_pushnumber(L, e->signal);
-			lua_setfield(L, -2, "signal");
+	lua_pushnumber(L, e->rx_packets);
+	lua_setfield(L, -2, "rx_packets");
 
-			lua_pushnumber(L, e->noise);
-			lua_setfield(L, -2, "noise");
+	lua_pushnumber(L, e->tx_packets);
+	lua_setfield(L, -2, "tx_packets");
 
-			lua_pushnumber(L, e->inactive);
-			lua_setfield(L, -2, "inactive");
+	lua_pushnumber(L, e->rx_rate.rate);
+	lua_setfield(L, -2, "rx_rate");
 
-			lua_pushnumber(L, e->rx_packets);
-			lua_setfield(L, -2, "rx_packets");
+	lua_pushnumber(L, e->tx_rate.rate);
+	lua_setfield(L, -2, "tx_rate");
 
-			lua_pushnumber(L, e->tx_packets);
-			lua_setfield(L, -2, "tx_packets");
+	if (e->rx_rate.mcs >= 0)
+	{
+		lua_pushnumber(L, e->rx_rate.mcs);
+		lua_setfield(L, -2, "rx_mcs");
 
-			lua_pushnumber(L, e->rx_rate.rate);
-			lua_setfield(L, -2, "rx_rate");
+		lua_pushboolean(L, e->rx_rate.is_40mhz);
+		lua_setfield(L, -2, "rx_40mhz");
 
-			lua_pushnumber(L, e->tx_rate.rate);
-			lua_setfield(L, -2, "tx_rate");
+		lua_pushboolean(L, e->rx_rate.is_short_gi);
+		lua_setfield(L, -2, "rx_short_gi");
+	}
 
-			if (e->rx_rate.mcs >= 0)
-			{
-				lua_pushnumber(L, e->rx_rate.mcs);
-				lua_setfield(L, -2, "rx_mcs");
+	if (e->tx_rate.mcs >= 0)
+	{
+		lua_pushnumber(L, e->tx_rate.mcs);
+		lua_setfield(L, -2, "tx_mcs");
 
-				lua_pushboolean(L, e->rx_rate.is_40mhz);
-				lua_setfield(L, -2, "rx_40mhz");
+		lua_pushboolean(L, e->tx_rate.is_40mhz);
+		lua_setfield(L, -2, "tx_40mhz");
 
-				lua_pushboolean(L, e->rx_rate.is_short_gi);
-				lua_setfield(L, -2, "rx_short_gi");
-			}
+		lua_pushboolean(L, e->tx_rate.is_short_gi);
+		lua_setfield(L, -2, "tx_short_gi");
+	}
 
-			if (e->tx_rate.mcs >= 0)
-			{
-				lua_pushnumber(L, e->tx_rate.mcs);
-				lua_setfield(L, -2, "tx_mcs");
+	lua_setfield(L, -2, macstr);
 
-				lua_pushboolean(L, e->tx_rate.is_40mhz);
-				lua_setfield(L, -2, "tx_40mhz");
+	return 0;
+}
 
-				lua_pushboolean(L, e->tx_rate.is_short_gi);
-				lua_setfield(L, -2, "tx_short_gi");
-			}
+static int iwinfo_L_assoclist(lua_State *L, const struct iwinfo_ops *ops)
+{
+	const char *ifname = luaL_checkstring(L, 1);
 
-			lua_setfield(L, -2, macstr);
-		}
-	}
+	lua_newtable(L);
+	iwinfo_assoclist(ops, ifname, iwinfo_L_assoclist_entry, L);
 
 	return 1;
 }
@@ -360,66 +357,86 @@ static int iwinfo_L_txpwrlist(lua_State *L, int (*func)(const char *, char *, in
 }
 
 /* Wrapper for scan list */
-static int iwinfo_L_scanlist(lua_State *L, int (*func)(const char *, char *, int *))
+struct iwinfo_L_scanlist_state {
+	lua_State *L;
+	int x;
+};
+
+static int iwinfo_L_scanlist_entry(const struct iwinfo_scanlist_entry *e,
+                                   void *priv)
 {
-	int i, x, len;
-	char rv[IWINFO_BUFSIZE];
+	struct iwinfo_L_scanlist_state *st = priv;
+	lua_State *L = st->L;
 	char macstr[18];
-	const char *ifname = luaL_checkstring(L, 1);
-	struct iwinfo_scanlist_entry *e;
 
 	lua_newtable(L);
-	memset(rv, 0, sizeof(rv));
 
-	if (!(*func)(ifname, rv, &len))
+	/* BSSID */
+	sprintf(macstr, "%02X:%02X:%02X:%02X:%02X:%02X",
+		e->mac[0], e->mac[1], e->mac[2],
+		e->mac[3], e->mac[4], e->mac[5]);
+
+	lua_pushstring(L, macstr);
+	lua_setfield(L, -2, "bssid");
+
+	/* ESSID */
+	if (e->ssid[0])
 	{
-		for (i = 0, x = 1; i < len; i += sizeof(struct iwinfo_scanlist_entry), x++)
-		{
-			e = (struct iwinfo_scanlist_entry *) &rv[i];
+		lua_pushstring(L, (char *) e->ssid);
+		lua_setfield(L, -2, "ssid");
+	}
 
-			lua_newtable(L);
+	/* Channel */
+	lua_pushinteger(L, e->channel);
+	lua_setfield(L, -2, "channel");
 
-			/* BSSID */
-			sprintf(macstr, "%02X:%02X:%02X:%02X:%02X:%02X",
-				e->mac[0], e->mac[1], e->mac[2],
-				e->mac[3], e->mac[4], e->mac[5]);
+	/* Mode */
+	lua_pushstring(L, IWINFO_OPMODE_NAMES[e->mode]);
+	lua_setfield(L, -2, "mode");
 
-			lua_pushstring(L, macstr);
-			lua_setfield(L, -2, "bssid");
+	/* Quality, Signal */
+	lua_pushinteger(L, e->quality);
+	lua_setfield(L, -2, "quality");
 
-			/* ESSID */
-			if (e->ssid[0])
-			{
-				lua_pushstring(L, (char *) e->ssid);
-				lua_setfield(L, -2, "ssid");
-			}
+	lua_pushinteger(L, e->quality_max);
+	lua_setfield(L, -2, "quality_max");
 
-			/* Channel */
-			lua_pushinteger(L, e->channel);
-			lua_setfield(L, -2, "channel");
+	lua_pushnumber(L, (e->signal - 0x100));
+	lua_setfield(L, -2, "signal");
 
-			/* Mode */
-			lua_pushstring(L, IWINFO_OPMODE_NAMES[e->mode]);
-			lua_setfield(L, -2, "mode");
+	/* Crypto */
+	iwinfo_L_cryptotable(L, &e->crypto);
+	lua_setfield(L, -2, "encryption");
 
-			/* Quality, Signal */
-			lua_pushinteger(L, e->quality);
-			lua_setfield(L, -2, "quality");
+	lua_rawseti(L, -2, ++st->x);
 
-			lua_pushinteger(L, e->quality_max);
-			lua_setfield(L, -2, "quality_max");
+	return 0;
+}
 
-			lua_pushnumber(L, (e->signal - 0x100));
-			lua_setfield(L, -2, "signal");
+static int iwinfo_L_scanlist(lua_State *L, const struct iwinfo_ops *ops)
+{
+	struct iwinfo_L_scanlist_state st = { .L = L, .x = 0 };
+	const char *ifname = luaL_checkstring(L, 1);
+	int max_age = luaL_optint(L, 2, 0);
 
-			/* Crypto */
-			iwinfo_L_cryptotable(L, &e->crypto);
-			lua_setfield(L, -2, "encryption");
+	lua_newtable(L);
 
-			lua_rawseti(L, -2, x);
-		}
-	}
+	/* a maximum age selects the cached results */
+	if (max_age > 0)
+		iwinfo_scanlist_cached(ops, ifname, max_age,
+		                       iwinfo_L_scanlist_entry, &st);
+	else
+		iwinfo_scanlist(ops, ifname, iwinfo_L_scanlist_entry, &st);
+
+	return 1;
+}
+
+/* Wrapper for background scan trigger */
+static int iwinfo_L_scan_trigger(lua_State *L, const struct iwinfo_ops *ops)
+{
+	const char *ifname = luaL_checkstring(L, 1);
 
+	lua_pushboolean(L, !iwinfo_scan_trigger(ops, ifname));
 	return 1;
 }
 
@@ -627,9 +644,10 @@ LUA_WRAP_STRING_OP(wl,country)
 LUA_WRAP_STRING_OP(wl,hardware_name)
 LUA_WRAP_STRING_OP(wl,phyname)
 LUA_WRAP_STRUCT_OP(wl,mode)
-LUA_WRAP_STRUCT_OP(wl,assoclist)
+LUA_WRAP_ITER_OP(wl,assoclist)
 LUA_WRAP_STRUCT_OP(wl,txpwrlist)
-LUA_WRAP_STRUCT_OP(wl,scanlist)
+LUA_WRAP_ITER_OP(wl,scanlist)
+LUA_WRAP_ITER_OP(wl,scan_trigger)
 LUA_WRAP_STRUCT_OP(wl,freqlist)
 LUA_WRAP_STRUCT_OP(wl,countrylist)
 LUA_WRAP_STRUCT_OP(wl,hwmodelist)
@@ -656,9 +674,10 @@ LUA_WRAP_STRING_OP(madwifi,country)
 LUA_WRAP_STRING_OP(madwifi,hardware_name)
 LUA_WRAP_STRING_OP(madwifi,phyname)
 LUA_WRAP_STRUCT_OP(madwifi,mode)
-LUA_WRAP_STRUCT_OP(madwifi,assoclist)
+LUA_WRAP_ITER_OP(madwifi,assoclist)
 LUA_WRAP_STRUCT_OP(madwifi,txpwrlist)
-LUA_WRAP_STRUCT_OP(madwifi,scanlist)
+LUA_WRAP_ITER_OP(madwifi,scanlist)
+LUA_WRAP_ITER_OP(madwifi,scan_trigger)
 LUA_WRAP_STRUCT_OP(madwifi,freqlist)
 LUA_WRAP_STRUCT_OP(madwifi,countrylist)
 LUA_WRAP_STRUCT_OP(madwifi,hwmodelist)
@@ -685,9 +704,10 @@ LUA_WRAP_STRING_OP(nl80211,country)
 LUA_WRAP_STRING_OP(nl80211,hardware_name)
 LUA_WRAP_STRING_OP(nl80211,phyname)
 LUA_WRAP_STRUCT_OP(nl80211,mode)
-LUA_WRAP_STRUCT_OP(nl80211,assoclist)
+LUA_WRAP_ITER_OP(nl80211,assoclist)
 LUA_WRAP_STRUCT_OP(nl80211,txpwrlist)
-LUA_WRAP_STRUCT_OP(nl80211,scanlist)
+LUA_WRAP_ITER_OP(nl80211,scanlist)
+LUA_WRAP_ITER_OP(nl80211,scan_trigger)
 LUA_WRAP_STRUCT_OP(nl80211,freqlist)
 LUA_WRAP_STRUCT_OP(nl80211,countrylist)
 LUA_WRAP_STRUCT_OP(nl80211,hwmodelist)
@@ -713,9 +733,10 @@ LUA_WRAP_STRING_OP(wext,country)
 LUA_WRAP_STRING_OP(wext,hardware_name)
 LUA_WRAP_STRING_OP(wext,phyname)
 LUA_WRAP_STRUCT_OP(wext,mode)
-LUA_WRAP_STRUCT_OP(wext,assoclist)
+LUA_WRAP_ITER_OP(wext,assoclist)
 LUA_WRAP_STRUCT_OP(wext,txpwrlist)
-LUA_WRAP_STRUCT_OP(wext,scanlist)
+LUA_WRAP_ITER_OP(wext,scanlist)
+LUA_WRAP_ITER_OP(wext,scan_trigger)
 LUA_WRAP_STRUCT_OP(wext,freqlist)
 LUA_WRAP_STRUCT_OP(wext,countrylist)
 LUA_WRAP_STRUCT_OP(wext,hwmodelist)
@@ -743,6 +764,7 @@ static const luaL_reg R_wl[] = {
 	LUA_REG(wl,assoclist),
 	LUA_REG(wl,txpwrlist),
 	LUA_REG(wl,scanlist),
+	LUA_REG(wl,scan_trigger),
 	LUA_REG(wl,freqlist),
 	LUA_REG(wl,countrylist),
 	LUA_REG(wl,hwmodelist),
@@ -775,6 +797,7 @@ static const luaL_reg R_madwifi[] = {
 	LUA_REG(madwifi,assoclist),
 	LUA_REG(madwifi,txpwrlist),
 	LUA_REG(madwifi,scanlist),
+	LUA_REG(madwifi,scan_trigger),
 	LUA_REG(madwifi,freqlist),
 	LUA_REG(madwifi,countrylist),
 	LUA_REG(madwifi,hwmodelist),
@@ -807,6 +830,7 @@ static const luaL_reg R_nl80211[] = {
 	LUA_REG(nl80211,assoclist),
 	LUA_REG(nl80211,txpwrlist),
 	LUA_REG(nl80211,scanlist),
+	LUA_REG(nl80211,scan_trigger),
 	LUA_REG(nl80211,freqlist),
 	LUA_REG(nl80211,countrylist),
 	LUA_REG(nl80211,hwmodelist),
@@ -838,6 +862,7 @@ static const luaL_reg R_wext[] = {
 	LUA_REG(wext,assoclist),
 	LUA_REG(wext,txpwrlist),
 	LUA_REG(wext,scanlist),
+	LUA_REG(wext,scan_trigger),
 	LUA_REG(wext,freqlist),
 	LUA_REG(wext,countrylist),
 	LUA_REG(wext,hwmodelist),
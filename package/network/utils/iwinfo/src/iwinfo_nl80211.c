@@ -247,9 +247,10 @@ nla_put_failure:
 	return NULL;
 }
 
-static struct nl80211_msg_conveyor * nl80211_send(
+/* status (if not NULL) receives 0 on ack or the negative kernel error */
+static struct nl80211_msg_conveyor * nl80211_send_status(
 	struct nl80211_msg_conveyor *cv,
-	int (*cb_func)(struct nl_msg *, void *), void *cb_arg
+	int (*cb_func)(struct nl_msg *, void *), void *cb_arg, int *status
 ) {
 	static struct nl80211_msg_conveyor rcv;
 	int err = 1;
@@ -269,6 +270,9 @@ static struct nl80211_msg_conveyor * nl80211_send(
 	while (err > 0)
 		nl_recvmsgs(nls->nl_sock, cv->cb);
 
+	if (status)
+		*status = err;
+
 	return &rcv;
 
 err:
@@ -278,6 +282,13 @@ err:
 	return NULL;
 }
 
+static struct nl80211_msg_conveyor * nl80211_send(
+	struct nl80211_msg_conveyor *cv,
+	int (*cb_func)(struct nl_msg *, void *), void *cb_arg
+) {
+	return nl80211_send_status(cv, cb_func, cb_arg, NULL);
+}
+
 static struct nlattr ** nl80211_parse(struct nl_msg *msg)
 {
 	struct genlmsghdr *gnlh = nlmsg_data(nlmsg_hdr(msg));
@@ -1448,10 +1459,17 @@ static int nl80211_get_phyname(const char *ifname, char *buf)
 }
 
 
+struct nl80211_assoclist {
+	iwinfo_assoclist_cb cb;
+	void *priv;
+	int noise;
+	int stop;
+};
+
 static int nl80211_get_assoclist_cb(struct nl_msg *msg, void *arg)
 {
-	struct nl80211_array_buf *arr = arg;
-	struct iwinfo_assoclist_entry *e = arr->buf;
+	struct nl80211_assoclist *al = arg;
+	struct iwinfo_assoclist_entry entry, *e = &entry;
 	struct nlattr **attr = nl80211_parse(msg);
 	struct nlattr *sinfo[NL80211_STA_INFO_MAX + 1];
 	struct nlattr *rinfo[NL80211_RATE_INFO_MAX + 1];
@@ -1472,8 +1490,10 @@ static int nl80211_get_assoclist_cb(struct nl_msg *msg, void *arg)
 		[NL80211_RATE_INFO_SHORT_GI]     = { .type = NLA_FLAG   },
 	};
 
-	/* advance to end of array */
-	e += arr->count;
+	/* the caller does not want any more entries */
+	if (al->stop)
+		return NL_SKIP;
+
 	memset(e, 0, sizeof(*e));
 
 	if (attr[NL80211_ATTR_MAC])
@@ -1532,24 +1552,26 @@ static int nl80211_get_assoclist_cb(struct nl_msg *msg, void *arg)
 		}
 	}
 
-	e->noise = 0; /* filled in by caller */
-	arr->count++;
+	e->noise = al->noise;
+	al->stop = al->cb(e, al->priv);
 
 	return NL_SKIP;
 }
 
-static int nl80211_get_assoclist(const char *ifname, char *buf, int *len)
+static int nl80211_get_assoclist_iter(const char *ifname,
+                                      iwinfo_assoclist_cb cb, void *priv)
 {
 	DIR *d;
-	int i, noise = 0;
 	struct dirent *de;
 	struct nl80211_msg_conveyor *req;
-	struct nl80211_array_buf arr = { .buf = buf, .count = 0 };
-	struct iwinfo_assoclist_entry *e;
+	struct nl80211_assoclist al = { .cb = cb, .priv = priv };
 
 	if ((d = opendir("/sys/class/net")) != NULL)
 	{
-		while ((de = readdir(d)) != NULL)
+		if (nl80211_get_noise(ifname, &al.noise))
+			al.noise = 0;
+
+		while (!al.stop && (de = readdir(d)) != NULL)
 		{
 			if (!strncmp(de->d_name, ifname, strlen(ifname)) &&
 			    (!de->d_name[strlen(ifname)] ||
@@ -1560,25 +1582,44 @@ static int nl80211_get_assoclist(const char *ifname, char *buf, int *len)
 
 				if (req)
 				{
-					nl80211_send(req, nl80211_get_assoclist_cb, &arr);
+					nl80211_send(req, nl80211_get_assoclist_cb, &al);
 					nl80211_free(req);
 				}
 			}
 		}
 
 		closedir(d);
-
-		if (!nl80211_get_noise(ifname, &noise))
-			for (i = 0, e = arr.buf; i < arr.count; i++, e++)
-				e->noise = noise;
-
-		*len = (arr.count * sizeof(struct iwinfo_assoclist_entry));
 		return 0;
 	}
 
 	return -1;
 }
 
+static int nl80211_add_assoclist_entry(const struct iwinfo_assoclist_entry *e,
+                                       void *priv)
+{
+	struct nl80211_array_buf *arr = priv;
+
+	if ((arr->count + 1) * sizeof(*e) > IWINFO_BUFSIZE)
+		return 1;
+
+	memcpy((struct iwinfo_assoclist_entry *)arr->buf + arr->count++,
+	       e, sizeof(*e));
+
+	return 0;
+}
+
+static int nl80211_get_assoclist(const char *ifname, char *buf, int *len)
+{
+	struct nl80211_array_buf arr = { .buf = buf, .count = 0 };
+
+	if (nl80211_get_assoclist_iter(ifname, nl80211_add_assoclist_entry, &arr))
+		return -1;
+
+	*len = (arr.count * sizeof(struct iwinfo_assoclist_entry));
+	return 0;
+}
+
 static int nl80211_get_txpwrlist_cb(struct nl_msg *msg, void *arg)
 {
 	int *dbm_max = arg;
@@ -1725,8 +1766,11 @@ static void nl80211_get_scancrypto(const char *spec,
 
 
 struct nl80211_scanlist {
-	struct iwinfo_scanlist_entry *e;
-	int len;
+	iwinfo_scanlist_cb cb;
+	void *priv;
+	int max_age;
+	int count;
+	int stop;
 };
 
 
@@ -1771,6 +1815,7 @@ static int nl80211_get_scanlist_cb(struct nl_msg *msg, void *arg)
 	uint16_t caps;
 
 	struct nl80211_scanlist *sl = arg;
+	struct iwinfo_scanlist_entry entry, *e = &entry;
 	struct nlattr **tb = nl80211_parse(msg);
 	struct nlattr *bss[NL80211_BSS_MAX + 1];
 
@@ -1788,7 +1833,7 @@ static int nl80211_get_scanlist_cb(struct nl_msg *msg, void *arg)
 		[NL80211_BSS_BEACON_IES]           = {                 },
 	};
 
-	if (!tb[NL80211_ATTR_BSS] ||
+	if (sl->stop || !tb[NL80211_ATTR_BSS] ||
 		nla_parse_nested(bss, NL80211_BSS_MAX, tb[NL80211_ATTR_BSS],
 		                 bss_policy) ||
 		!bss[NL80211_BSS_BSSID])
@@ -1796,85 +1841,101 @@ static int nl80211_get_scanlist_cb(struct nl_msg *msg, void *arg)
 		return NL_SKIP;
 	}
 
+	/* skip cached entries older than requested */
+	if (sl->max_age > 0 && bss[NL80211_BSS_SEEN_MS_AGO] &&
+	    nla_get_u32(bss[NL80211_BSS_SEEN_MS_AGO]) > sl->max_age)
+	{
+		return NL_SKIP;
+	}
+
 	if (bss[NL80211_BSS_CAPABILITY])
 		caps = nla_get_u16(bss[NL80211_BSS_CAPABILITY]);
 	else
 		caps = 0;
 
-	memset(sl->e, 0, sizeof(*sl->e));
-	memcpy(sl->e->mac, nla_data(bss[NL80211_BSS_BSSID]), 6);
+	memset(e, 0, sizeof(*e));
+	memcpy(e->mac, nla_data(bss[NL80211_BSS_BSSID]), 6);
 
 	if (caps & (1<<1))
-		sl->e->mode = IWINFO_OPMODE_ADHOC;
+		e->mode = IWINFO_OPMODE_ADHOC;
 	else if (caps & (1<<0))
-		sl->e->mode = IWINFO_OPMODE_MASTER;
+		e->mode = IWINFO_OPMODE_MASTER;
 	else
-		sl->e->mode = IWINFO_OPMODE_MESHPOINT;
+		e->mode = IWINFO_OPMODE_MESHPOINT;
 
 	if (caps & (1<<4))
-		sl->e->crypto.enabled = 1;
+		e->crypto.enabled = 1;
 
 	if (bss[NL80211_BSS_FREQUENCY])
-		sl->e->channel = nl80211_freq2channel(nla_get_u32(
+		e->channel = nl80211_freq2channel(nla_get_u32(
 			bss[NL80211_BSS_FREQUENCY]));
 
 	if (bss[NL80211_BSS_INFORMATION_ELEMENTS])
-		nl80211_get_scanlist_ie(bss, sl->e);
+		nl80211_get_scanlist_ie(bss, e);
 
 	if (bss[NL80211_BSS_SIGNAL_MBM])
 	{
-		sl->e->signal =
+		e->signal =
 			(uint8_t)((int32_t)nla_get_u32(bss[NL80211_BSS_SIGNAL_MBM]) / 100);
 
-		rssi = sl->e->signal - 0x100;
+		rssi = e->signal - 0x100;
 
 		if (rssi < -110)
 			rssi = -110;
 		else if (rssi > -40)
 			rssi = -40;
 
-		sl->e->quality = (rssi + 110);
-		sl->e->quality_max = 70;
+		e->quality = (rssi + 110);
+		e->quality_max = 70;
 	}
 
-	if (sl->e->crypto.enabled && !sl->e->crypto.wpa_version)
+	if (e->crypto.enabled && !e->crypto.wpa_version)
 	{
-		sl->e->crypto.auth_algs    = IWINFO_AUTH_OPEN | IWINFO_AUTH_SHARED;
-		sl->e->crypto.pair_ciphers = IWINFO_CIPHER_WEP40 | IWINFO_CIPHER_WEP104;
+		e->crypto.auth_algs    = IWINFO_AUTH_OPEN | IWINFO_AUTH_SHARED;
+		e->crypto.pair_ciphers = IWINFO_CIPHER_WEP40 | IWINFO_CIPHER_WEP104;
 	}
 
-	sl->e++;
-	sl->len++;
+	sl->count++;
+	sl->stop = sl->cb(e, sl->priv);
 
 	return NL_SKIP;
 }
 
-static int nl80211_get_scanlist_nl(const char *ifname, char *buf, int *len)
+static int nl80211_get_scanlist_dump(const char *ifname,
+                                     struct nl80211_scanlist *sl)
 {
 	struct nl80211_msg_conveyor *req;
-	struct nl80211_scanlist sl = { .e = (struct iwinfo_scanlist_entry *)buf };
 
-	req = nl80211_msg(ifname, NL80211_CMD_TRIGGER_SCAN, 0);
+	req = nl80211_msg(ifname, NL80211_CMD_GET_SCAN, NLM_F_DUMP);
 	if (req)
 	{
-		nl80211_send(req, NULL, NULL);
+		nl80211_send(req, nl80211_get_scanlist_cb, sl);
 		nl80211_free(req);
 	}
 
-	nl80211_wait("nl80211", "scan", NL80211_CMD_NEW_SCAN_RESULTS);
+	return sl->count ? 0 : -1;
+}
 
-	req = nl80211_msg(ifname, NL80211_CMD_GET_SCAN, NLM_F_DUMP);
+static int nl80211_get_scanlist_nl(const char *ifname,
+                                   iwinfo_scanlist_cb cb, void *priv)
+{
+	struct nl80211_msg_conveyor *req;
+	struct nl80211_scanlist sl = { .cb = cb, .priv = priv };
+
+	req = nl80211_msg(ifname, NL80211_CMD_TRIGGER_SCAN, 0);
 	if (req)
 	{
-		nl80211_send(req, nl80211_get_scanlist_cb, &sl);
+		nl80211_send(req, NULL, NULL);
 		nl80211_free(req);
 	}
 
-	*len = sl.len * sizeof(struct iwinfo_scanlist_entry);
-	return *len ? 0 : -1;
+	nl80211_wait("nl80211", "scan", NL80211_CMD_NEW_SCAN_RESULTS);
+
+	return nl80211_get_scanlist_dump(ifname, &sl);
 }
 
-static int nl80211_get_scanlist(const char *ifname, char *buf, int *len)
+static int nl80211_get_scanlist_iter(const char *ifname,
+                                     iwinfo_scanlist_cb cb, void *priv)
 {
 	int freq, rssi, qmax, count, mode;
 	char *res;
@@ -1888,19 +1949,19 @@ static int nl80211_get_scanlist(const char *ifname, char *buf, int *len)
 		/* Reuse existing interface */
 		if ((res = nl80211_phy2ifname(ifname)) != NULL)
 		{
-			return nl80211_get_scanlist(res, buf, len);
+			return nl80211_get_scanlist_iter(res, cb, priv);
 		}
 
 		/* Need to spawn a temporary iface for scanning */
 		else if ((res = nl80211_ifadd(ifname)) != NULL)
 		{
-			count = nl80211_get_scanlist(res, buf, len);
+			count = nl80211_get_scanlist_iter(res, cb, priv);
 			nl80211_ifdel(res);
 			return count;
 		}
 	}
 
-	struct iwinfo_scanlist_entry *e = (struct iwinfo_scanlist_entry *)buf;
+	struct iwinfo_scanlist_entry entry, *e = &entry;
 
 	/* WPA supplicant */
 	if ((res = nl80211_wpactl_info(ifname, "SCAN", "CTRL-EVENT-SCAN-RESULTS")))
@@ -1929,6 +1990,9 @@ static int nl80211_get_scanlist(const char *ifname, char *buf, int *len)
 					/* skip malformed lines */
 					goto nextline;
 				}
+
+				memset(e, 0, sizeof(*e));
+
 				/* BSSID */
 				e->mac[0] = strtol(&bssid[0],  NULL, 16);
 				e->mac[1] = strtol(&bssid[3],  NULL, 16);
@@ -1977,7 +2041,9 @@ static int nl80211_get_scanlist(const char *ifname, char *buf, int *len)
 				nl80211_get_scancrypto(cipher, &e->crypto);
 
 				count++;
-				e++;
+
+				if (cb(e, priv))
+					break;
 
 				memset(ssid, 0, sizeof(ssid));
 				memset(bssid, 0, sizeof(bssid));
@@ -1989,7 +2055,6 @@ static int nl80211_get_scanlist(const char *ifname, char *buf, int *len)
  			}
 			while( *res );
 
-			*len = count * sizeof(struct iwinfo_scanlist_entry);
 			return 0;
 		}
 	}
@@ -2001,7 +2066,7 @@ static int nl80211_get_scanlist(const char *ifname, char *buf, int *len)
 	          mode == IWINFO_OPMODE_MONITOR) &&
 	         iwinfo_ifup(ifname))
 	{
-		return nl80211_get_scanlist_nl(ifname, buf, len);
+		return nl80211_get_scanlist_nl(ifname, cb, priv);
 	}
 
 	/* AP scan */
@@ -2013,7 +2078,7 @@ static int nl80211_get_scanlist(const char *ifname, char *buf, int *len)
 			if (!iwinfo_ifup(ifname))
 				return -1;
 
-			nl80211_get_scanlist_nl(ifname, buf, len);
+			nl80211_get_scanlist_nl(ifname, cb, priv);
 			iwinfo_ifdown(ifname);
 			return 0;
 		}
@@ -2030,7 +2095,7 @@ static int nl80211_get_scanlist(const char *ifname, char *buf, int *len)
 			 * additional interface and there's no need to tear down the ap */
 			if (iwinfo_ifup(res))
 			{
-				nl80211_get_scanlist_nl(res, buf, len);
+				nl80211_get_scanlist_nl(res, cb, priv);
 				iwinfo_ifdown(res);
 			}
 
@@ -2038,7 +2103,7 @@ static int nl80211_get_scanlist(const char *ifname, char *buf, int *len)
 			 * during scan */
 			else if (iwinfo_ifdown(ifname) && iwinfo_ifup(res))
 			{
-				nl80211_get_scanlist_nl(res, buf, len);
+				nl80211_get_scanlist_nl(res, cb, priv);
 				iwinfo_ifdown(res);
 				iwinfo_ifup(ifname);
 				nl80211_hostapd_hup(ifname);
@@ -2053,6 +2118,128 @@ static int nl80211_get_scanlist(const char *ifname, char *buf, int *len)
 	return -1;
 }
 
+static int nl80211_get_scanlist_cached_iter(const char *ifname, int max_age,
+                                            iwinfo_scanlist_cb cb, void *priv)
+{
+	char *res;
+	struct nl80211_scanlist sl = {
+		.cb = cb, .priv = priv, .max_age = max_age * 1000
+	};
+
+	/* The bss cache belongs to the phy, any interface on it will do.
+	 * Without one there is nothing cached and a full scan is needed. */
+	if (!strncmp(ifname, "radio", 5))
+	{
+		if ((res = nl80211_phy2ifname(ifname)) == NULL)
+			return nl80211_get_scanlist_iter(ifname, cb, priv);
+
+		ifname = res;
+	}
+
+	if (!nl80211_get_scanlist_dump(ifname, &sl))
+		return 0;
+
+	/* nothing recent enough, do a real scan */
+	return nl80211_get_scanlist_iter(ifname, cb, priv);
+}
+
+static int nl80211_get_features_cb(struct nl_msg *msg, void *arg)
+{
+	uint32_t *features = arg;
+	struct nlattr **attr = nl80211_parse(msg);
+
+	if (attr[NL80211_ATTR_FEATURE_FLAGS])
+		*features = nla_get_u32(attr[NL80211_ATTR_FEATURE_FLAGS]);
+
+	return NL_SKIP;
+}
+
+static uint32_t nl80211_get_features(const char *ifname)
+{
+	struct nl80211_msg_conveyor *req;
+	uint32_t features = 0;
+
+	req = nl80211_msg(ifname, NL80211_CMD_GET_WIPHY, 0);
+	if (req)
+	{
+		nl80211_send(req, nl80211_get_features_cb, &features);
+		nl80211_free(req);
+	}
+
+	return features;
+}
+
+/* Starts a single scan and returns without waiting for it. The results are
+ * merged into the bss cache of the phy, so calling this periodically keeps
+ * the cached scanlist fresh; scheduling it is left to the caller. */
+static int nl80211_scan_trigger(const char *ifname)
+{
+	int mode, err, rv = -1;
+	uint32_t features, flags = 0;
+	struct nl80211_msg_conveyor *req;
+	char *res;
+
+	if (!strncmp(ifname, "radio", 5))
+	{
+		if ((res = nl80211_phy2ifname(ifname)) == NULL)
+			return -1;
+
+		ifname = res;
+	}
+
+	/* drivers reject flags they do not advertise with -EOPNOTSUPP */
+	features = nl80211_get_features(ifname);
+
+	if (features & NL80211_FEATURE_LOW_PRIORITY_SCAN)
+		flags |= NL80211_SCAN_FLAG_LOW_PRIORITY;
+
+	/* ask the driver to scan without taking a running ap down */
+	if ((features & NL80211_FEATURE_AP_SCAN) &&
+	    !nl80211_get_mode(ifname, &mode) && mode == IWINFO_OPMODE_MASTER)
+		flags |= NL80211_SCAN_FLAG_AP;
+
+	req = nl80211_msg(ifname, NL80211_CMD_TRIGGER_SCAN, 0);
+	if (req)
+	{
+		if (flags)
+			NLA_PUT_U32(req->msg, NL80211_ATTR_SCAN_FLAGS, flags);
+
+		/* the kernel refuses e.g. while a scan is running (-EBUSY) */
+		if (nl80211_send_status(req, NULL, NULL, &err) && !err)
+			rv = 0;
+
+	nla_put_failure:
+		nl80211_free(req);
+	}
+
+	return rv;
+}
+
+static int nl80211_add_scanlist_entry(const struct iwinfo_scanlist_entry *e,
+                                      void *priv)
+{
+	struct nl80211_array_buf *arr = priv;
+
+	if ((arr->count + 1) * sizeof(*e) > IWINFO_BUFSIZE)
+		return 1;
+
+	memcpy((struct iwinfo_scanlist_entry *)arr->buf + arr->count++,
+	       e, sizeof(*e));
+
+	return 0;
+}
+
+static int nl80211_get_scanlist(const char *ifname, char *buf, int *len)
+{
+	struct nl80211_array_buf arr = { .buf = buf, .count = 0 };
+	int ret;
+
+	ret = nl80211_get_scanlist_iter(ifname, nl80211_add_scanlist_entry, &arr);
+	*len = arr.count * sizeof(struct iwinfo_scanlist_entry);
+
+	return ret;
+}
+
 static int nl80211_get_freqlist_cb(struct nl_msg *msg, void *arg)
 {
 	int bands_remain, freqs_remain;
@@ -2315,8 +2502,21 @@ static int nl80211_get_mbssid_support(const char *ifname, int *buf)
 
 static int nl80211_get_hardware_id(const char *ifname, char *buf)
 {
-	int rv;
-	char *res;
+	int rv = -1;
+	char *res, phy[32];
+
+	/* The ids never change while the system is running, so look them up
+	 * only once per phy. The radio pseudo interfaces map to phy names. */
+	if (!strncmp(ifname, "radio", 5))
+		snprintf(phy, sizeof(phy), "phy%d", atoi(&ifname[5]));
+	else if ((res = nl80211_ifname2phy(ifname)) != NULL)
+		snprintf(phy, sizeof(phy), "%s", res);
+	else
+		phy[0] = 0;
+
+	if (phy[0] &&
+	    !iwinfo_hardware_id_cached(phy, (struct iwinfo_hardware_id *)buf))
+		return 0;
 
 	/* Got a radioX pseudo interface, find some interface on it or create one */
 	if (!strncmp(ifname, "radio", 5))
@@ -2345,6 +2545,11 @@ static int nl80211_get_hardware_id(const char *ifname, char *buf)
 		rv = iwinfo_hardware_id_from_mtd((struct iwinfo_hardware_id *)buf);
 	}
 
+	/* a failure may be transient, e.g. early during boot, so it is not
+	 * cached and the next call tries again */
+	if (phy[0] && !rv)
+		iwinfo_hardware_id_store(phy, (struct iwinfo_hardware_id *)buf);
+
 	return rv;
 }
 
@@ -2417,8 +2622,12 @@ const struct iwinfo_ops nl80211_ops = {
 	.encryption       = nl80211_get_encryption,
 	.phyname          = nl80211_get_phyname,
 	.assoclist        = nl80211_get_assoclist,
+	.assoclist_iter   = nl80211_get_assoclist_iter,
 	.txpwrlist        = nl80211_get_txpwrlist,
 	.scanlist         = nl80211_get_scanlist,
+	.scanlist_iter    = nl80211_get_scanlist_iter,
+	.scanlist_cached_iter = nl80211_get_scanlist_cached_iter,
+	.scan_trigger     = nl80211_scan_trigger,
 	.freqlist         = nl80211_get_freqlist,
 	.countrylist      = nl80211_get_countrylist,
 	.close            = nl80211_close
@@ -25,6 +25,23 @@
 
 static int ioctl_socket = -1;
 
+/* hardware.txt, parsed on first use */
+struct iwinfo_hardware_db_entry {
+	struct iwinfo_hardware_entry e;
+	int line;
+};
+
+static struct iwinfo_hardware_db_entry *hw_db;
+static int hw_db_len = -1;
+
+/* known hardware ids per phy */
+struct iwinfo_hardware_id_cache {
+	char phy[IFNAMSIZ];
+	struct iwinfo_hardware_id id;
+};
+
+static struct iwinfo_hardware_id_cache hw_id_cache[8];
+
 static int iwinfo_ioctl_socket(void)
 {
 	/* Prepare socket */
@@ -128,49 +145,256 @@ void iwinfo_close(void)
 	ioctl_socket = -1;
 }
 
-struct iwinfo_hardware_entry * iwinfo_hardware(struct iwinfo_hardware_id *id)
+/*
+ * Entries with a fixed vendor and device id are sorted by those so they
+ * can be found with a binary search, entries using a wildcard for either
+ * of them go last in file order. The line number decides between
+ * several matching entries, so the first match in the file still wins.
+ */
+static int iwinfo_hardware_cmp(const void *a, const void *b)
+{
+	const struct iwinfo_hardware_db_entry *x = a, *y = b;
+	int xw = (x->e.vendor_id == 0xffff || x->e.device_id == 0xffff);
+	int yw = (y->e.vendor_id == 0xffff || y->e.device_id == 0xffff);
+
+	if (xw != yw)
+		return xw - yw;
+
+	if (!xw && x->e.vendor_id != y->e.vendor_id)
+		return x->e.vendor_id - y->e.vendor_id;
+
+	if (!xw && x->e.device_id != y->e.device_id)
+		return x->e.device_id - y->e.device_id;
+
+	return x->line - y->line;
+}
+
+static void iwinfo_hardware_load(void)
 {
 	FILE *db;
 	char buf[256] = { 0 };
-	static struct iwinfo_hardware_entry e;
-	struct iwinfo_hardware_entry *rv = NULL;
+	struct iwinfo_hardware_db_entry *tmp, *d;
+	int line = 0, size = 0;
+
+	hw_db_len = 0;
 
 	if (!(db = fopen(IWINFO_HARDWARE_FILE, "r")))
-		return NULL;
+		return;
 
 	while (fgets(buf, sizeof(buf) - 1, db) != NULL)
 	{
-		memset(&e, 0, sizeof(e));
+		if (hw_db_len == size)
+		{
+			size += 32;
+			tmp = realloc(hw_db, size * sizeof(*hw_db));
+
+			if (!tmp)
+				break;
+
+			hw_db = tmp;
+		}
+
+		d = &hw_db[hw_db_len];
+		memset(d, 0, sizeof(*d));
+		d->line = line++;
 
 		if (sscanf(buf, "%hx %hx %hx %hx %hd %hd \"%63[^\"]\" \"%63[^\"]\"",
-			       &e.vendor_id, &e.device_id,
-			       &e.subsystem_vendor_id, &e.subsystem_device_id,
-			       &e.txpower_offset, &e.frequency_offset,
-			       e.vendor_name, e.device_name) < 8)
+			       &d->e.vendor_id, &d->e.device_id,
+			       &d->e.subsystem_vendor_id, &d->e.subsystem_device_id,
+			       &d->e.txpower_offset, &d->e.frequency_offset,
+			       d->e.vendor_name, d->e.device_name) < 8)
 			continue;
 
-		if ((e.vendor_id != 0xffff) && (e.vendor_id != id->vendor_id))
-			continue;
+		hw_db_len++;
+	}
 
-		if ((e.device_id != 0xffff) && (e.device_id != id->device_id))
-			continue;
+	fclose(db);
 
-		if ((e.subsystem_vendor_id != 0xffff) &&
-			(e.subsystem_vendor_id != id->subsystem_vendor_id))
-			continue;
+	qsort(hw_db, hw_db_len, sizeof(*hw_db), iwinfo_hardware_cmp);
+}
 
-		if ((e.subsystem_device_id != 0xffff) &&
-			(e.subsystem_device_id != id->subsystem_device_id))
-			continue;
+static int iwinfo_hardware_match(const struct iwinfo_hardware_entry *e,
+                                 const struct iwinfo_hardware_id *id)
+{
+	if ((e->vendor_id != 0xffff) && (e->vendor_id != id->vendor_id))
+		return 0;
 
-		rv = &e;
-		break;
+	if ((e->device_id != 0xffff) && (e->device_id != id->device_id))
+		return 0;
+
+	if ((e->subsystem_vendor_id != 0xffff) &&
+		(e->subsystem_vendor_id != id->subsystem_vendor_id))
+		return 0;
+
+	if ((e->subsystem_device_id != 0xffff) &&
+		(e->subsystem_device_id != id->subsystem_device_id))
+		return 0;
+
+	return 1;
+}
+
+struct iwinfo_hardware_entry * iwinfo_hardware(struct iwinfo_hardware_id *id)
+{
+	struct iwinfo_hardware_db_entry *d, *rv = NULL;
+	int lo, hi, mid, n_fixed;
+
+	if (hw_db_len < 0)
+		iwinfo_hardware_load();
+
+	/* find the first fixed entry for this vendor and device id */
+	for (n_fixed = 0; n_fixed < hw_db_len; n_fixed++)
+		if (hw_db[n_fixed].e.vendor_id == 0xffff ||
+		    hw_db[n_fixed].e.device_id == 0xffff)
+			break;
+
+	lo = 0;
+	hi = n_fixed;
+
+	while (lo < hi)
+	{
+		mid = (lo + hi) / 2;
+		d = &hw_db[mid];
+
+		if (d->e.vendor_id < id->vendor_id ||
+		    (d->e.vendor_id == id->vendor_id &&
+		     d->e.device_id < id->device_id))
+			lo = mid + 1;
+		else
+			hi = mid;
 	}
 
-	fclose(db);
+	for (d = &hw_db[lo]; d < &hw_db[n_fixed]; d++)
+	{
+		if (d->e.vendor_id != id->vendor_id ||
+		    d->e.device_id != id->device_id)
+			break;
+
+		if (iwinfo_hardware_match(&d->e, id))
+		{
+			rv = d;
+			break;
+		}
+	}
+
+	for (d = &hw_db[n_fixed]; d < &hw_db[hw_db_len]; d++)
+	{
+		if (rv && d->line > rv->line)
+			break;
+
+		if (iwinfo_hardware_match(&d->e, id))
+		{
+			rv = d;
+			break;
+		}
+	}
+
+	return rv ? &rv->e : NULL;
+}
+
+static const char * iwinfo_boot_id(void)
+{
+	static char boot_id[40];
+	FILE *f;
+
+	if (!boot_id[0] && (f = fopen("/proc/sys/kernel/random/boot_id", "r")))
+	{
+		if (!fgets(boot_id, sizeof(boot_id), f))
+			boot_id[0] = 0;
+
+		boot_id[strcspn(boot_id, "\n")] = 0;
+		fclose(f);
+	}
+
+	return boot_id;
+}
+
+/* the slot of a phy, or the first free one if it has none */
+static struct iwinfo_hardware_id_cache * iwinfo_hardware_id_slot(const char *phy)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(hw_id_cache); i++)
+		if (!hw_id_cache[i].phy[0] || !strcmp(hw_id_cache[i].phy, phy))
+			return &hw_id_cache[i];
+
+	return NULL;
+}
+
+static void iwinfo_hardware_id_remember(const char *phy,
+                                        const struct iwinfo_hardware_id *id)
+{
+	struct iwinfo_hardware_id_cache *c = iwinfo_hardware_id_slot(phy);
+
+	if (c)
+	{
+		strncpy(c->phy, phy, sizeof(c->phy) - 1);
+		c->id = *id;
+	}
+}
+
+/*
+ * Look up the hardware id of a phy determined earlier, either by this
+ * process or by another one since boot. Returns 0 if it is known and 1
+ * otherwise. Only successful lookups are stored, so a failure is retried.
+ */
+int iwinfo_hardware_id_cached(const char *phy, struct iwinfo_hardware_id *id)
+{
+	int rv = 0;
+	FILE *f;
+	char path[64], boot_id[40];
+	struct iwinfo_hardware_id_cache *c = iwinfo_hardware_id_slot(phy);
+
+	if (c && c->phy[0])
+	{
+		*id = c->id;
+		return 0;
+	}
+
+	snprintf(path, sizeof(path), IWINFO_HARDWARE_CACHE, phy);
+
+	if (!(f = fopen(path, "r")))
+		return 1;
+
+	if (fscanf(f, "%39s %hx %hx %hx %hx", boot_id,
+	           &id->vendor_id, &id->device_id,
+	           &id->subsystem_vendor_id, &id->subsystem_device_id) != 5 ||
+	    strcmp(boot_id, iwinfo_boot_id()))
+		rv = 1;
+
+	fclose(f);
+
+	/* keep it in this process too, long running ones ask repeatedly */
+	if (!rv)
+		iwinfo_hardware_id_remember(phy, id);
+
 	return rv;
 }
 
+void iwinfo_hardware_id_store(const char *phy,
+                              const struct iwinfo_hardware_id *id)
+{
+	FILE *f;
+	char path[64], tmp[72];
+
+	iwinfo_hardware_id_remember(phy, id);
+
+	if (!iwinfo_boot_id()[0])
+		return;
+
+	snprintf(path, sizeof(path), IWINFO_HARDWARE_CACHE, phy);
+	snprintf(tmp, sizeof(tmp), "%s.%d", path, getpid());
+
+	if (!(f = fopen(tmp, "w")))
+		return;
+
+	fprintf(f, "%s %04x %04x %04x %04x\n", iwinfo_boot_id(),
+	        id->vendor_id, id->device_id,
+	        id->subsystem_vendor_id, id->subsystem_device_id);
+
+	if (fclose(f) || rename(tmp, path))
+		unlink(tmp);
+}
+
 int iwinfo_hardware_id_from_mtd(struct iwinfo_hardware_id *id)
 {
 	FILE *mtd;
@@ -0,0 +1,986 @@
+/*
+ * hotplugd - run /etc/hotplug.d scripts from long-lived shell workers
+ *
+ * Copyright (C) 2015 OpenWrt.org
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License v2 as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ *
+ * /sbin/hotplug-call hands each event to the daemon with "hotplugd -c",
+ * which sends the subsystem and the environment over a seqpacket socket
+ * and waits until the scripts have finished, so callers see the same
+ * synchronous behaviour as before.  The daemon keeps the sorted script
+ * list of every subsystem (reread when the directory mtime changes) and
+ * feeds the events to a small pool of shells which have sourced
+ * /lib/functions.sh once at startup.  Every script still runs in its own
+ * subshell, with the same environment hotplug-call would have set up, and
+ * is killed when it runs for longer than the script timeout.
+ *
+ * The daemon answers 's' when an event is started, 'd' when it is done
+ * and 'c' when it was not queued.  A client which has not seen its event
+ * start within CLIENT_TIMEOUT sends a cancel request; unless the event
+ * has started meanwhile it is dropped and the client runs the scripts
+ * itself.
+ *
+ * Events for the same device (DEVPATH, or INTERFACE for netifd events)
+ * are run in order.  A new event that is identical to the last queued
+ * event of its device, apart from SEQNUM, is dropped while that one is
+ * still waiting; every event is held for a short window to give
+ * duplicates a chance to arrive.
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <dirent.h>
+#include <poll.h>
+#include <signal.h>
+#include <syslog.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#define HOTPLUG_DIR	"/etc/hotplug.d"
+#define SOCK_PATH	"/var/run/hotplugd.sock"
+#define MAX_MSG		16384
+#define MAX_WORKERS	8
+#define CLIENT_TIMEOUT	10
+
+struct script_dir {
+	struct script_dir *next;
+	char *subsystem;
+	struct timespec mtime;
+	bool racy;
+	char **scripts;
+	int n_scripts;
+};
+
+struct worker;
+
+struct event {
+	struct event *next;
+	char *subsystem;
+	char *device;
+	char *env;
+	int env_len;
+	uint64_t due;
+	struct worker *worker;
+};
+
+struct worker {
+	pid_t pid;
+	int cmd;
+	int status;
+	struct event *ev;
+
+	/* the script currently running and when it has to be done */
+	pid_t script;
+	uint64_t deadline;
+
+	char line[32];
+	int line_len;
+};
+
+struct client {
+	struct client *next;
+	struct event *ev;
+	bool queued;
+	int fd;
+};
+
+static const char *sock_path = SOCK_PATH;
+static struct script_dir *dirs;
+static struct event *queue, **queue_tail = &queue;
+static struct worker workers[MAX_WORKERS];
+static struct client *clients;
+static int n_clients;
+static int n_workers = 1;
+static int window = 20;
+static int script_timeout = 30;
+
+static uint64_t
+now_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static const char *
+env_get(const char *env, int len, const char *name)
+{
+	int nlen = strlen(name);
+	const char *end = env + len;
+
+	for (; env < end; env += strlen(env) + 1)
+		if (!strncmp(env, name, nlen) && env[nlen] == '=')
+			return env + nlen + 1;
+
+	return NULL;
+}
+
+/* compare two environments, ignoring the kernel sequence number */
+static bool
+env_equal(const char *a, int alen, const char *b, int blen)
+{
+	const char *aend = a + alen, *bend = b + blen;
+
+	while (1) {
+		while (a < aend && !strncmp(a, "SEQNUM=", 7))
+			a += strlen(a) + 1;
+		while (b < bend && !strncmp(b, "SEQNUM=", 7))
+			b += strlen(b) + 1;
+
+		if (a >= aend || b >= bend)
+			return a >= aend && b >= bend;
+
+		if (strcmp(a, b))
+			return false;
+
+		a += strlen(a) + 1;
+		b += strlen(b) + 1;
+	}
+}
+
+static bool
+valid_name(const char *s, int len)
+{
+	int i;
+
+	for (i = 0; i < len; i++) {
+		if ((s[i] >= 'a' && s[i] <= 'z') || (s[i] >= 'A' && s[i] <= 'Z') ||
+		    s[i] == '_' || (i && s[i] >= '0' && s[i] <= '9'))
+			continue;
+		return false;
+	}
+
+	return len > 0;
+}
+
+static void
+put_quoted(FILE *f, const char *s)
+{
+	fputc('\'', f);
+	for (; *s; s++) {
+		if (*s == '\'')
+			fputs("'\\''", f);
+		else
+			fputc(*s, f);
+	}
+	fputc('\'', f);
+}
+
+static int
+script_cmp(const void *a, const void *b)
+{
+	return strcmp(*(char * const *) a, *(char * const *) b);
+}
+
+static void
+script_dir_clear(struct script_dir *d)
+{
+	while (d->n_scripts > 0)
+		free(d->scripts[--d->n_scripts]);
+	free(d->scripts);
+	d->scripts = NULL;
+}
+
+static int
+script_dir_read(struct script_dir *d, const char *path)
+{
+	char file[PATH_MAX];
+	struct dirent *e;
+	struct stat s;
+	char **list;
+	DIR *dir;
+	int n = 0;
+
+	dir = opendir(path);
+	if (!dir)
+		return -1;
+
+	while ((e = readdir(dir)) != NULL) {
+		if (e->d_name[0] == '.')
+			continue;
+
+		snprintf(file, sizeof(file), "%s/%s", path, e->d_name);
+		if (stat(file, &s) || !S_ISREG(s.st_mode))
+			continue;
+
+		list = realloc(d->scripts, (n + 1) * sizeof(*list));
+		if (!list)
+			break;
+
+		d->scripts = list;
+		d->scripts[n] = strdup(file);
+		if (d->scripts[n])
+			d->n_scripts = ++n;
+	}
+	closedir(dir);
+
+	qsort(d->scripts, d->n_scripts, sizeof(*d->scripts), script_cmp);
+	return 0;
+}
+
+static struct script_dir *
+script_dir_get(const char *subsystem)
+{
+	char path[PATH_MAX];
+	struct script_dir *d;
+	struct stat s;
+
+	if (!*subsystem || strchr(subsystem, '/') || !strcmp(subsystem, ".") ||
+	    !strcmp(subsystem, ".."))
+		return NULL;
+
+	snprintf(path, sizeof(path), "%s/%s", HOTPLUG_DIR, subsystem);
+
+	for (d = dirs; d; d = d->next)
+		if (!strcmp(d->subsystem, subsystem))
+			break;
+
+	if (stat(path, &s) || !S_ISDIR(s.st_mode)) {
+		if (d)
+			script_dir_clear(d);
+		return d;
+	}
+
+	if (!d) {
+		d = calloc(1, sizeof(*d));
+		if (!d)
+			return NULL;
+
+		d->subsystem = strdup(subsystem);
+		d->racy = true;
+		d->next = dirs;
+		dirs = d;
+	}
+
+	if (!d->racy && d->mtime.tv_sec == s.st_mtim.tv_sec &&
+	    d->mtime.tv_nsec == s.st_mtim.tv_nsec)
+		return d;
+
+	script_dir_clear(d);
+	script_dir_read(d, path);
+	d->mtime = s.st_mtim;
+
+	/*
+	 * A change within the same timestamp tick would not be noticed,
+	 * so keep rereading until the directory is older than that.
+	 */
+	d->racy = time(NULL) - s.st_mtim.tv_sec <= 1;
+
+	return d;
+}
+
+static void
+event_free(struct event *ev)
+{
+	free(ev->subsystem);
+	free(ev->device);
+	free(ev->env);
+	free(ev);
+}
+
+static void
+client_free(struct client *c)
+{
+	struct client **p;
+
+	for (p = &clients; *p; p = &(*p)->next) {
+		if (*p != c)
+			continue;
+
+		*p = c->next;
+		n_clients--;
+		break;
+	}
+
+	close(c->fd);
+	free(c);
+}
+
+/* send a reply to every client waiting for the event */
+static void
+client_reply(struct event *ev, char reply, bool done)
+{
+	struct client *c, *next;
+
+	for (c = clients; c; c = next) {
+		next = c->next;
+
+		if (c->ev != ev)
+			continue;
+
+		send(c->fd, &reply, 1, MSG_DONTWAIT | MSG_NOSIGNAL);
+		if (done)
+			client_free(c);
+	}
+}
+
+static bool
+event_has_clients(struct event *ev)
+{
+	struct client *c;
+
+	for (c = clients; c; c = c->next)
+		if (c->ev == ev)
+			return true;
+
+	return false;
+}
+
+/* queue an event, returns the queued event it was merged into if any */
+static struct event *
+event_add(const char *msg, int len)
+{
+	const char *subsystem = msg, *device;
+	struct event *ev, *last = NULL;
+	int slen = strnlen(msg, len);
+
+	if (slen >= len - 1 || msg[len - 1])
+		return NULL;
+
+	msg += slen + 1;
+	len -= slen + 1;
+
+	device = env_get(msg, len, "DEVPATH");
+	if (!device)
+		device = env_get(msg, len, "INTERFACE");
+	if (!device)
+		device = "";
+
+	for (ev = queue; ev; ev = ev->next)
+		if (!strcmp(ev->subsystem, subsystem) && !strcmp(ev->device, device))
+			last = ev;
+
+	if (last && !last->worker && env_equal(last->env, last->env_len, msg, len))
+		return last;
+
+	ev = calloc(1, sizeof(*ev));
+	if (!ev)
+		return NULL;
+
+	ev->subsystem = strdup(subsystem);
+	ev->device = strdup(device);
+	ev->env = malloc(len);
+	ev->env_len = len;
+	ev->due = now_ms() + window;
+
+	if (!ev->subsystem || !ev->device || !ev->env) {
+		event_free(ev);
+		return NULL;
+	}
+
+	memcpy(ev->env, msg, len);
+	*queue_tail = ev;
+	queue_tail = &ev->next;
+
+	return ev;
+}
+
+static void
+event_remove(struct event *ev)
+{
+	struct event **p;
+
+	for (p = &queue; *p; p = &(*p)->next) {
+		if (*p != ev)
+			continue;
+
+		*p = ev->next;
+		if (queue_tail == &ev->next)
+			queue_tail = p;
+		break;
+	}
+
+	event_free(ev);
+}
+
+/* the scripts of the event have run, release the waiting clients */
+static void
+event_done(struct event *ev)
+{
+	client_reply(ev, 'd', true);
+	event_remove(ev);
+}
+
+static int
+worker_start(struct worker *w)
+{
+	int cmd[2], status[2];
+
+	if (pipe2(cmd, O_CLOEXEC))
+		return -1;
+
+	if (pipe2(status, O_CLOEXEC)) {
+		close(cmd[0]);
+		close(cmd[1]);
+		return -1;
+	}
+
+	w->pid = fork();
+	if (w->pid < 0) {
+		close(cmd[0]); close(cmd[1]);
+		close(status[0]); close(status[1]);
+		return -1;
+	}
+
+	if (!w->pid) {
+		/* the shell reads commands on stdin and reports on fd 3 */
+		dup2(cmd[0], 0);
+		dup2(status[1], 3);
+		signal(SIGPIPE, SIG_DFL);
+		execl("/bin/sh", "sh", "-s", NULL);
+		_exit(127);
+	}
+
+	close(cmd[0]);
+	close(status[1]);
+	w->cmd = cmd[1];
+	w->status = status[0];
+	w->ev = NULL;
+	w->script = 0;
+	w->deadline = 0;
+	w->line_len = 0;
+
+	dprintf(w->cmd,
+		". /lib/functions.sh\n"
+		"PATH=/bin:/sbin:/usr/bin:/usr/sbin\n"
+		"LOGNAME=root\n"
+		"USER=root\n"
+		"export PATH LOGNAME USER\n");
+
+	return 0;
+}
+
+static void
+worker_stop(struct worker *w)
+{
+	close(w->cmd);
+	close(w->status);
+	waitpid(w->pid, NULL, 0);
+	w->pid = 0;
+
+	if (w->ev)
+		event_done(w->ev);
+	w->ev = NULL;
+}
+
+static bool
+worker_run(struct worker *w, struct event *ev, struct script_dir *d)
+{
+	const char *env = ev->env, *end = ev->env + ev->env_len, *eq;
+	char *job = NULL;
+	size_t job_len = 0;
+	FILE *f;
+	int i, r;
+
+	f = open_memstream(&job, &job_len);
+	if (!f)
+		return false;
+
+	fputs("(\nset -- ", f);
+	put_quoted(f, ev->subsystem);
+	fputs("\nexport HOTPLUG_TYPE=\"$1\"\n", f);
+
+	for (; env < end; env += strlen(env) + 1) {
+		eq = strchr(env, '=');
+		if (!eq || !valid_name(env, eq - env))
+			continue;
+
+		fputs("export ", f);
+		put_quoted(f, env);
+		fputc('\n', f);
+	}
+
+	fputs("PATH=/bin:/sbin:/usr/bin:/usr/sbin LOGNAME=root USER=root\n"
+	      "export DEVICENAME=\"${DEVPATH##*/}\"\n", f);
+
+	/*
+	 * Every script runs in the background so that its pid can be
+	 * reported for the timeout, the next one starts once it is done.
+	 */
+	for (i = 0; i < d->n_scripts; i++) {
+		fputs("( [ -f ", f);
+		put_quoted(f, d->scripts[i]);
+		fputs(" ] && . ", f);
+		put_quoted(f, d->scripts[i]);
+		fputs(" ) 3>&- &\necho \"s $!\" >&3\nwait $!\n", f);
+	}
+
+	fputs(") </dev/null\necho d >&3\n", f);
+	fclose(f);
+
+	for (i = 0; i < job_len; i += r) {
+		r = write(w->cmd, job + i, job_len - i);
+		if (r < 0 && errno == EINTR)
+			r = 0;
+		else if (r < 0)
+			break;
+	}
+	free(job);
+
+	if (i < job_len)
+		return false;
+
+	w->ev = ev;
+	ev->worker = w;
+	return true;
+}
+
+static struct worker *
+worker_idle(void)
+{
+	int i;
+
+	for (i = 0; i < n_workers; i++)
+		if (workers[i].pid && !workers[i].ev)
+			return &workers[i];
+
+	return NULL;
+}
+
+/* start every due event whose device is not busy, returns the next deadline */
+static int
+dispatch(void)
+{
+	struct event *ev, *next, *prev;
+	struct script_dir *d;
+	struct worker *w;
+	uint64_t now = now_ms();
+
+	for (ev = queue; ev; ev = next) {
+		next = ev->next;
+
+		if (ev->worker)
+			continue;
+
+		if (ev->due > now)
+			return ev->due - now;
+
+		for (prev = queue; prev != ev; prev = prev->next)
+			if (!strcmp(prev->subsystem, ev->subsystem) &&
+			    !strcmp(prev->device, ev->device))
+				break;
+
+		if (prev != ev)
+			continue;
+
+		d = script_dir_get(ev->subsystem);
+		if (!d || !d->n_scripts) {
+			event_done(ev);
+			continue;
+		}
+
+		w = worker_idle();
+		if (!w)
+			break;
+
+		if (!worker_run(w, ev, d)) {
+			syslog(LOG_ERR, "Failed to pass %s event to worker %d\n",
+			       ev->subsystem, w->pid);
+			worker_stop(w);
+			worker_start(w);
+			continue;
+		}
+
+		client_reply(ev, 's', false);
+	}
+
+	return -1;
+}
+
+/* handle the status lines of a worker, returns -1 once it has exited */
+static int
+worker_read(struct worker *w)
+{
+	char buf[64];
+	int len, i;
+
+	len = read(w->status, buf, sizeof(buf));
+	if (len < 0 && errno == EINTR)
+		return 0;
+
+	if (len <= 0)
+		return -1;
+
+	for (i = 0; i < len; i++) {
+		if (buf[i] != '\n') {
+			if (w->line_len < sizeof(w->line) - 1)
+				w->line[w->line_len++] = buf[i];
+			continue;
+		}
+
+		w->line[w->line_len] = 0;
+		w->line_len = 0;
+
+		if (w->line[0] == 's') {
+			/* the next script has started */
+			w->script = atoi(w->line + 1);
+			w->deadline = script_timeout ?
+				now_ms() + script_timeout * 1000 : 0;
+		} else if (w->line[0] == 'd') {
+			w->script = 0;
+			w->deadline = 0;
+
+			if (w->ev)
+				event_done(w->ev);
+			w->ev = NULL;
+		}
+	}
+
+	return 0;
+}
+
+/* kill scripts which ran out of time, returns the next poll timeout */
+static int
+worker_expire(int timeout)
+{
+	uint64_t now = now_ms();
+	struct worker *w;
+	int i;
+
+	for (i = 0; i < n_workers; i++) {
+		w = &workers[i];
+
+		if (!w->pid || !w->deadline)
+			continue;
+
+		if (w->deadline <= now) {
+			syslog(LOG_WARNING, "Script of %s event timed out, killing %d\n",
+			       w->ev ? w->ev->subsystem : "unknown", w->script);
+			if (w->script > 0)
+				kill(w->script, SIGKILL);
+			w->deadline = 0;
+			continue;
+		}
+
+		if (timeout < 0 || w->deadline - now < timeout)
+			timeout = w->deadline - now;
+	}
+
+	return timeout;
+}
+
+static int
+sock_open(bool server)
+{
+	struct sockaddr_un sun = { .sun_family = AF_UNIX };
+	int fd;
+
+	if (strlen(sock_path) >= sizeof(sun.sun_path))
+		return -1;
+
+	strcpy(sun.sun_path, sock_path);
+
+	fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+		return -1;
+
+	if (server) {
+		unlink(sock_path);
+		if (!bind(fd, (struct sockaddr *) &sun, sizeof(sun)) &&
+		    !chmod(sock_path, 0600) && !listen(fd, 16))
+			return fd;
+	} else {
+		if (!connect(fd, (struct sockaddr *) &sun, sizeof(sun)))
+			return fd;
+	}
+
+	close(fd);
+	return -1;
+}
+
+/* wait for a reply from the daemon, returns 0 on timeout and -1 on error */
+static int
+client_wait(int fd, int timeout)
+{
+	struct pollfd pfd = { .fd = fd, .events = POLLIN };
+	char reply;
+	int r;
+
+	do {
+		r = poll(&pfd, 1, timeout);
+	} while (r < 0 && errno == EINTR);
+
+	if (r <= 0)
+		return r;
+
+	if (recv(fd, &reply, 1, 0) != 1)
+		return -1;
+
+	return reply;
+}
+
+static int
+run_client(const char *subsystem)
+{
+	struct timeval tv = { .tv_sec = 1 };
+	extern char **environ;
+	static char msg[MAX_MSG];
+	int fd, len, n, reply;
+	char **e;
+
+	len = strlen(subsystem) + 1;
+	if (len > sizeof(msg))
+		return 1;
+
+	memcpy(msg, subsystem, len);
+
+	for (e = environ; *e; e++) {
+		n = strlen(*e) + 1;
+		if (len + n > sizeof(msg))
+			return 1;
+
+		memcpy(msg + len, *e, n);
+		len += n;
+	}
+
+	fd = sock_open(false);
+	if (fd < 0)
+		return 1;
+
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+	if (send(fd, msg, len, 0) != len)
+		return 1;
+
+	/*
+	 * If the event has not started in time, ask the daemon to drop it
+	 * and let hotplug-call run the scripts directly.  The event may
+	 * have started meanwhile, in which case it is waited for.
+	 */
+	reply = client_wait(fd, CLIENT_TIMEOUT * 1000);
+	if (!reply) {
+		if (send(fd, "c", 1, 0) != 1)
+			return 1;
+
+		reply = client_wait(fd, CLIENT_TIMEOUT * 1000);
+	}
+
+	/* a running event is bounded by the script timeout of the daemon */
+	if (reply == 's')
+		reply = client_wait(fd, -1);
+
+	close(fd);
+	return reply != 'd';
+}
+
+static void
+client_add(int fd)
+{
+	struct client *c, **p;
+
+	c = calloc(1, sizeof(*c));
+	if (!c) {
+		close(fd);
+		return;
+	}
+
+	c->fd = fd;
+
+	for (p = &clients; *p; p = &(*p)->next);
+	*p = c;
+	n_clients++;
+}
+
+static void
+client_recv(struct client *c)
+{
+	static char msg[MAX_MSG];
+	struct event *ev;
+	int len;
+
+	len = recv(c->fd, msg, sizeof(msg), MSG_DONTWAIT);
+	if (len < 0 && (errno == EAGAIN || errno == EINTR))
+		return;
+
+	/* the client went away, its event still runs */
+	if (len <= 0) {
+		client_free(c);
+		return;
+	}
+
+	if (!c->queued) {
+		c->queued = true;
+		c->ev = event_add(msg, len);
+		if (!c->ev) {
+			send(c->fd, "c", 1, MSG_DONTWAIT | MSG_NOSIGNAL);
+			client_free(c);
+		}
+		return;
+	}
+
+	/* a cancel request, too late once the event has started */
+	ev = c->ev;
+	if (!ev || ev->worker)
+		return;
+
+	send(c->fd, "c", 1, MSG_DONTWAIT | MSG_NOSIGNAL);
+	client_free(c);
+
+	if (!event_has_clients(ev))
+		event_remove(ev);
+}
+
+static int
+run_daemon(void)
+{
+	struct pollfd *pfd = NULL, *tmp;
+	struct client *c, *next;
+	int fd, cfd, i, n, timeout;
+
+	fd = sock_open(true);
+	if (fd < 0) {
+		syslog(LOG_ERR, "Failed to open %s: %s\n", sock_path, strerror(errno));
+		return 1;
+	}
+
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	signal(SIGPIPE, SIG_IGN);
+
+	for (i = 0; i < n_workers; i++)
+		if (worker_start(&workers[i]))
+			syslog(LOG_ERR, "Failed to start worker: %s\n", strerror(errno));
+
+	while (1) {
+		timeout = worker_expire(dispatch());
+
+		n = 1 + n_workers + n_clients;
+		tmp = realloc(pfd, n * sizeof(*pfd));
+		if (!tmp) {
+			syslog(LOG_ERR, "Out of memory\n");
+			break;
+		}
+		pfd = tmp;
+
+		pfd[0].fd = fd;
+		pfd[0].events = POLLIN;
+
+		for (i = 0; i < n_workers; i++) {
+			pfd[i + 1].fd = workers[i].pid ? workers[i].status : -1;
+			pfd[i + 1].events = POLLIN;
+		}
+
+		for (c = clients, i = n_workers + 1; c; c = c->next, i++) {
+			pfd[i].fd = c->fd;
+			pfd[i].events = POLLIN;
+		}
+
+		if (poll(pfd, n, timeout) < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+
+		/* only the client itself is freed here, so the order holds */
+		for (c = clients, i = n_workers + 1; c && i < n; c = next, i++) {
+			next = c->next;
+			if (pfd[i].revents)
+				client_recv(c);
+		}
+
+		for (i = 0; i < n_workers; i++) {
+			struct worker *w = &workers[i];
+
+			if (!w->pid || !pfd[i + 1].revents)
+				continue;
+
+			if (!worker_read(w))
+				continue;
+
+			syslog(LOG_WARNING, "Worker %d exited, restarting\n", w->pid);
+			worker_stop(w);
+			worker_start(w);
+		}
+
+		if (pfd[0].revents & POLLIN)
+			while ((cfd = accept4(fd, NULL, NULL,
+					      SOCK_CLOEXEC | SOCK_NONBLOCK)) >= 0)
+				client_add(cfd);
+	}
+
+	free(pfd);
+	close(fd);
+	unlink(sock_path);
+	return 1;
+}
+
+static int
+usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [options] -d|-c <subsystem>\n"
+		"Options:\n"
+		"	-d:		Run the dispatcher daemon\n"
+		"	-c <subsystem>:	Pass the current event to the daemon\n"
+		"	-s <path>:	Socket path (default: %s)\n"
+		"	-w <num>:	Number of shell workers (default: 1, max: %d)\n"
+		"			Events of different devices may run in parallel\n"
+		"			when more than one worker is used\n"
+		"	-t <msec>:	Duplicate event window (default: %d)\n"
+		"	-T <sec>:	Script timeout, 0 to disable (default: %d)\n"
+		"\n", prog, SOCK_PATH, MAX_WORKERS, window, script_timeout);
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	const char *subsystem = NULL;
+	bool daemon = false;
+	int ch;
+
+	while ((ch = getopt(argc, argv, "c:ds:t:T:w:")) != -1) {
+		switch (ch) {
+		case 'c':
+			subsystem = optarg;
+			break;
+		case 'd':
+			daemon = true;
+			break;
+		case 's':
+			sock_path = optarg;
+			break;
+		case 't':
+			window = atoi(optarg);
+			break;
+		case 'T':
+			script_timeout = atoi(optarg);
+			break;
+		case 'w':
+			n_workers = atoi(optarg);
+			if (n_workers < 1 || n_workers > MAX_WORKERS)
+				return usage(argv[0]);
+			break;
+		default:
+			return usage(argv[0]);
+		}
+	}
+
+	if (subsystem && !daemon)
+		return run_client(subsystem);
+
+	if (!daemon || subsystem)
+		return usage(argv[0]);
+
+	openlog("hotplugd", 0, LOG_DAEMON);
+	return run_daemon();
+}
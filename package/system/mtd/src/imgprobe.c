@@ -0,0 +1,334 @@
+/*
+ * imgprobe - read a sysupgrade image once and describe it to the shell
+ *
+ * Copyright (C) 2015 OpenWrt.org
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License v2
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ *
+ * The image is decompressed (if it is gzip or bzip2 compressed), hashed
+ * and measured in a single pass.  Compressed images and images read from
+ * a pipe are stored uncompressed in the cache file, so that the platform
+ * checks and the final mtd write can use the plain data without running
+ * the decompressor again.  The cache file usually lives on tmpfs, so it
+ * is only kept while it fits into half of the available memory; beyond
+ * that it is dropped and IMAGE_FILE is left empty, and the caller has to
+ * stream the image through the decompressor again.  The result is printed
+ * as shell assignments:
+ *
+ *   IMAGE_FILE       file holding the uncompressed image, empty if none
+ *   IMAGE_CACHED     1 if IMAGE_FILE is the cache file
+ *   IMAGE_COMPRESSED gzip, bzip2 or none
+ *   IMAGE_SIZE       uncompressed size in bytes
+ *   IMAGE_MD5        md5sum of the uncompressed data
+ *   IMAGE_HEAD       hex dump of the first HEAD_LEN bytes
+ */
+
+#define _GNU_SOURCE
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include <libubox/md5.h>
+
+#define BUF_LEN		(64 * 1024)
+#define HEAD_LEN	16
+
+static char buf[BUF_LEN];
+
+static int
+read_full(int fd, char *data, int len)
+{
+	int done = 0, r;
+
+	while (done < len) {
+		r = read(fd, data + done, len - done);
+		if (r < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		if (!r)
+			break;
+		done += r;
+	}
+
+	return done;
+}
+
+static int
+write_full(int fd, const char *data, int len)
+{
+	int r;
+
+	while (len > 0) {
+		r = write(fd, data, len);
+		if (r < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		data += r;
+		len -= r;
+	}
+
+	return 0;
+}
+
+/*
+ * Run the decompressor on the image. The bytes already consumed from
+ * the input are fed back in front of the rest by a small helper process,
+ * which also works when the input is a pipe and cannot be rewound.
+ */
+static int
+spawn_filter(const char *cmd, int in, const char *prefix, int len,
+	     pid_t *pid, pid_t *feeder)
+{
+	int p_in[2], p_out[2];
+
+	if (pipe(p_in) || pipe(p_out))
+		return -1;
+
+	*pid = fork();
+	if (*pid < 0)
+		return -1;
+
+	if (!*pid) {
+		close(in);
+		dup2(p_in[0], 0);
+		dup2(p_out[1], 1);
+		close(p_in[0]); close(p_in[1]);
+		close(p_out[0]); close(p_out[1]);
+		execlp(cmd, cmd, NULL);
+		_exit(127);
+	}
+
+	*feeder = fork();
+	if (*feeder < 0)
+		return -1;
+
+	if (!*feeder) {
+		close(p_in[0]);
+		close(p_out[0]); close(p_out[1]);
+		if (write_full(p_in[1], prefix, len))
+			_exit(1);
+		while ((len = read_full(in, buf, sizeof(buf))) > 0)
+			if (write_full(p_in[1], buf, len))
+				_exit(1);
+		_exit(len < 0);
+	}
+
+	close(p_in[0]); close(p_in[1]);
+	close(p_out[1]);
+	close(in);
+
+	return p_out[0];
+}
+
+static int
+wait_child(pid_t pid)
+{
+	int status;
+
+	while (waitpid(pid, &status, 0) < 0)
+		if (errno != EINTR)
+			return -1;
+
+	return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/* memory that can be filled with the cache file without pushing anything out */
+static unsigned long long
+mem_available(void)
+{
+	unsigned long long avail = 0, free = 0, val;
+	char line[128];
+	FILE *f;
+
+	f = fopen("/proc/meminfo", "r");
+	if (!f)
+		return 0;
+
+	while (fgets(line, sizeof(line), f)) {
+		if (sscanf(line, "MemAvailable: %llu kB", &val) == 1)
+			avail = val;
+		else if (sscanf(line, "MemFree: %llu kB", &val) == 1)
+			free = val;
+	}
+	fclose(f);
+
+	return (avail ? avail : free) * 1024;
+}
+
+static void
+print_quoted(const char *name, const char *val)
+{
+	printf("%s='", name);
+	for (; *val; val++) {
+		if (*val == '\'')
+			fputs("'\\''", stdout);
+		else
+			putchar(*val);
+	}
+	printf("'\n");
+}
+
+static void
+usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s <image file|-> <cache file>\n", prog);
+	exit(1);
+}
+
+int main(int argc, char **argv)
+{
+	const char *image, *cache, *type = "none";
+	unsigned char head[HEAD_LEN], md5[16];
+	int fd, out = -1, len, hlen, i;
+	unsigned long long size = 0, cache_max = 0;
+	pid_t pid = 0, feeder = 0;
+	md5_ctx_t ctx;
+	struct stat s;
+
+	if (argc != 3)
+		usage(argv[0]);
+
+	image = argv[1];
+	cache = argv[2];
+
+	signal(SIGPIPE, SIG_IGN);
+
+	if (!strcmp(image, "-"))
+		fd = 0;
+	else if ((fd = open(image, O_RDONLY)) < 0) {
+		fprintf(stderr, "Failed to open %s: %s\n", image, strerror(errno));
+		return 1;
+	}
+
+	len = read_full(fd, buf, sizeof(buf));
+	if (len <= 0) {
+		fprintf(stderr, "Failed to read image data\n");
+		return 1;
+	}
+
+	if (len > 2 && (uint8_t)buf[0] == 0x1f && (uint8_t)buf[1] == 0x8b)
+		type = "gzip";
+	else if (len > 2 && buf[0] == 'B' && buf[1] == 'Z' && buf[2] == 'h')
+		type = "bzip2";
+
+	if (strcmp(type, "none")) {
+		fd = spawn_filter(!strcmp(type, "gzip") ? "zcat" : "bzcat",
+				  fd, buf, len, &pid, &feeder);
+		if (fd < 0) {
+			fprintf(stderr, "Failed to start the %s decompressor\n", type);
+			return 1;
+		}
+		len = read_full(fd, buf, sizeof(buf));
+	}
+
+	/* plain regular files are used in place, everything else is cached */
+	if (fd == 0 || pid || fstat(fd, &s) || !S_ISREG(s.st_mode)) {
+		out = open(cache, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+		if (out < 0) {
+			fprintf(stderr, "Failed to create %s: %s\n", cache, strerror(errno));
+			return 1;
+		}
+		image = cache;
+		cache_max = mem_available() / 2;
+	}
+
+	hlen = len < HEAD_LEN ? len : HEAD_LEN;
+	memcpy(head, buf, hlen);
+
+	md5_begin(&ctx);
+	while (len > 0) {
+		md5_hash(buf, len, &ctx);
+		size += len;
+
+		if (out >= 0 && size > cache_max) {
+			fprintf(stderr, "Not enough memory to keep the uncompressed image\n");
+			close(out);
+			unlink(cache);
+			out = -1;
+			image = "";
+		}
+
+		if (out >= 0 && write_full(out, buf, len)) {
+			fprintf(stderr, "Failed to write %s: %s\n", cache, strerror(errno));
+			goto error;
+		}
+
+		len = read_full(fd, buf, sizeof(buf));
+	}
+	md5_end(md5, &ctx);
+
+	if (len < 0) {
+		fprintf(stderr, "Failed to read image data\n");
+		goto error;
+	}
+
+	if (pid) {
+		close(fd);
+		i = wait_child(pid);
+		i |= wait_child(feeder);
+		pid = 0;
+		if (i) {
+			fprintf(stderr, "Failed to decompress the image\n");
+			goto error;
+		}
+	}
+
+	if (!size) {
+		fprintf(stderr, "Image is empty\n");
+		goto error;
+	}
+
+	if (out >= 0 && close(out)) {
+		fprintf(stderr, "Failed to write %s: %s\n", cache, strerror(errno));
+		unlink(cache);
+		return 1;
+	}
+
+	print_quoted("IMAGE_FILE", image);
+	printf("IMAGE_CACHED=%d\n", out >= 0);
+	printf("IMAGE_COMPRESSED=%s\n", type);
+	printf("IMAGE_SIZE=%llu\n", size);
+
+	printf("IMAGE_MD5=");
+	for (i = 0; i < sizeof(md5); i++)
+		printf("%02x", md5[i]);
+
+	printf("\nIMAGE_HEAD=");
+	for (i = 0; i < hlen; i++)
+		printf("%02x", head[i]);
+	printf("\n");
+
+	return 0;
+
+error:
+	if (pid) {
+		close(fd);
+		wait_child(pid);
+		wait_child(feeder);
+	}
+	if (out >= 0) {
+		close(out);
+		unlink(cache);
+	}
+	return 1;
+}
@@ -26,12 +26,19 @@
 #include <dirent.h>
 #include <unistd.h>
 #include <endian.h>
+#include <errno.h>
+#include <sys/wait.h>
 #include "jffs2.h"
 #include "crc32.h"
 #include "mtd.h"
 
 #define PAD(x) (((x)+3)&~3)
 
+/* data nodes never cross a page boundary of the file */
+#define JFFS2_PAGE_SIZE	4096
+
+#define TAR_BLOCK	512
+
 #if BYTE_ORDER == BIG_ENDIAN
 # define CLEANMARKER "\x19\x85\x20\x03\x00\x00\x00\x0c\xf0\x60\xdc\x98"
 #else
@@ -45,6 +52,10 @@ static int ofs = 0;
 static int outfd = -1;
 static int mtdofs = 0;
 static int target_ino = 0;
+static unsigned int raw_bytes = 0;
+static unsigned int stored_bytes = 0;
+
+bool jffs2_untar = false;
 
 static void prep_eraseblock(void);
 
@@ -101,7 +112,7 @@ static int add_dirent(const char *name, const char type, int parent)
 {
 	struct jffs2_raw_dirent *de;
 
-	if (ofs - erasesize < sizeof(struct jffs2_raw_dirent) + strlen(name))
+	if (rbytes() < sizeof(struct jffs2_raw_dirent) + strlen(name))
 		pad(erasesize);
 
 	prep_eraseblock();
@@ -129,7 +140,7 @@ static int add_dirent(const char *name, const char type, int parent)
 	return de->ino;
 }
 
-static int add_dir(const char *name, int parent)
+static int add_dir(const char *name, int parent, int mode, int mtime)
 {
 	struct jffs2_raw_inode ri;
 	int inode;
@@ -147,9 +158,9 @@ static int add_dir(const char *name, int parent)
 	ri.hdr_crc = crc32(0, &ri, sizeof(struct jffs2_unknown_node) - 4);
 
 	ri.ino = inode;
-	ri.mode = S_IFDIR | 0755;
+	ri.mode = S_IFDIR | mode;
 	ri.uid = ri.gid = 0;
-	ri.atime = ri.ctime = ri.mtime = 0;
+	ri.atime = ri.ctime = ri.mtime = mtime;
 	ri.isize = ri.csize = ri.dsize = 0;
 	ri.version = 1;
 	ri.node_crc = crc32(0, &ri, sizeof(ri) - 8);
@@ -160,12 +171,162 @@ static int add_dir(const char *name, int parent)
 	return inode;
 }
 
+static int read_full(int fd, void *data, int len)
+{
+	int done = 0, r;
+
+	while (done < len) {
+		r = read(fd, (char *) data + done, len - done);
+		if (r < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		if (!r)
+			break;
+		done += r;
+	}
+
+	return done;
+}
+
+/*
+ * rtime compressor, the same algorithm as fs/jffs2/compr_rtime.c.
+ * It is the only compressor the kernel jffs2 driver is built with
+ * besides lzma, and it needs no extra library.
+ * Compresses as much of the input as fits into *dstlen bytes and
+ * updates *srclen / *dstlen, returns -1 if the data does not shrink.
+ */
+static int rtime_compress(const unsigned char *in, unsigned char *out,
+			  int *srclen, int *dstlen)
+{
+	unsigned short positions[256];
+	int outpos = 0, pos = 0;
+
+	memset(positions, 0, sizeof(positions));
+
+	while (pos < *srclen && outpos <= *dstlen - 2) {
+		int backpos, runlen = 0;
+		unsigned char value;
+
+		value = in[pos];
+		out[outpos++] = in[pos++];
+
+		backpos = positions[value];
+		positions[value] = pos;
+
+		while (backpos < pos && pos < *srclen &&
+		       in[pos] == in[backpos++] && runlen < 255) {
+			pos++;
+			runlen++;
+		}
+		out[outpos++] = runlen;
+	}
+
+	if (outpos >= pos)
+		return -1;
+
+	*srclen = pos;
+	*dstlen = outpos;
+	return 0;
+}
+
+static void add_data_node(struct jffs2_raw_inode *ri, const void *data)
+{
+	ri->totlen = sizeof(*ri) + ri->csize;
+	ri->hdr_crc = crc32(0, ri, sizeof(struct jffs2_unknown_node) - 4);
+	ri->version = ++last_version;
+	ri->node_crc = crc32(0, ri, sizeof(*ri) - 8);
+	ri->data_crc = crc32(0, data, ri->csize);
+
+	add_data((char *) ri, sizeof(*ri));
+	add_data((char *) data, ri->csize);
+	pad(4);
+	prep_eraseblock();
+
+	stored_bytes += ri->csize;
+}
+
+/*
+ * Write the data nodes for an inode, reading up to size bytes (or until
+ * end of file if size is negative) from fd. Every node is compressed
+ * with rtime and stored raw if that does not make it smaller.
+ */
+static int add_inode_data(struct jffs2_raw_inode *ri, int fd, int size)
+{
+	unsigned char rbuf[JFFS2_PAGE_SIZE], cbuf[JFFS2_PAGE_SIZE];
+	int f_offset = 0, have = 0, pos = 0;
+
+	for (;;) {
+		int space, dlen, clen;
+
+		if (!have) {
+			int want = sizeof(rbuf);
+
+			if (size >= 0 && size - f_offset < want)
+				want = size - f_offset;
+			if (!want)
+				break;
+
+			have = read_full(fd, rbuf, want);
+			if (have < 0 || (size >= 0 && have < want))
+				return -1;
+			if (!have)
+				break;
+
+			raw_bytes += have;
+			pos = 0;
+		}
+
+		for (;;) {
+			space = rbytes() - sizeof(*ri);
+			if (space > JFFS2_MIN_DATA_LEN)
+				break;
+
+			pad(erasesize);
+			prep_eraseblock();
+		}
+
+		dlen = have;
+		clen = space < have ? space : have;
+		if (rtime_compress(rbuf + pos, cbuf, &dlen, &clen)) {
+			dlen = clen = space < have ? space : have;
+			ri->compr = JFFS2_COMPR_NONE;
+		} else {
+			ri->compr = JFFS2_COMPR_RTIME;
+		}
+
+		ri->offset = f_offset;
+		ri->dsize = dlen;
+		ri->csize = clen;
+		add_data_node(ri, ri->compr == JFFS2_COMPR_NONE ? rbuf + pos : cbuf);
+
+		f_offset += dlen;
+		pos += dlen;
+		have -= dlen;
+	}
+
+	/* the kernel cannot read an inode without nodes, so an empty
+	 * file still gets a node without any data */
+	if (!f_offset) {
+		if (rbytes() < sizeof(*ri))
+			pad(erasesize);
+		prep_eraseblock();
+
+		ri->offset = 0;
+		ri->dsize = ri->csize = 0;
+		ri->compr = JFFS2_COMPR_NONE;
+		add_data_node(ri, rbuf);
+	}
+
+	return 0;
+}
+
 static void add_file(const char *name, int parent)
 {
-	int inode, f_offset = 0, fd;
+	int inode, fd;
 	struct jffs2_raw_inode ri;
 	struct stat st;
-	char wbuf[4096];
 	const char *fname;
 
 	if (stat(name, &st)) {
@@ -191,7 +352,6 @@ static void add_file(const char *name, int parent)
 	ri.ctime = st.st_ctime;
 	ri.mtime = st.st_mtime;
 	ri.isize = st.st_size;
-	ri.compr = 0;
 	ri.usercompr = 0;
 
 	fd = open(name, 0);
@@ -200,40 +360,319 @@ static void add_file(const char *name, int parent)
 		return;
 	}
 
+	if (add_inode_data(&ri, fd, -1))
+		fprintf(stderr, "Failed to read %s\n", name);
+
+	close(fd);
+}
+
+static void add_symlink(const char *name, const char *target, int parent,
+			int mtime)
+{
+	struct jffs2_raw_inode ri;
+
+	memset(&ri, 0, sizeof(ri));
+	ri.magic = JFFS2_MAGIC_BITMASK;
+	ri.nodetype = JFFS2_NODETYPE_INODE;
+	ri.ino = add_dirent(name, IFTODT(S_IFLNK), parent);
+	ri.mode = S_IFLNK | 0777;
+	ri.atime = ri.ctime = ri.mtime = mtime;
+	ri.isize = ri.dsize = ri.csize = strlen(target);
+	ri.compr = JFFS2_COMPR_NONE;
+
+	if (rbytes() < sizeof(ri) + ri.csize)
+		pad(erasesize);
+	prep_eraseblock();
+
+	raw_bytes += ri.csize;
+	add_data_node(&ri, target);
+}
+
+struct tar_dir {
+	char *path;
+	int ino;
+};
+
+static struct tar_dir *tar_dirs;
+static int n_tar_dirs;
+
+static unsigned long tar_num(const char *field, int len)
+{
+	char tmp[16];
+
+	memcpy(tmp, field, len);
+	tmp[len] = 0;
+
+	return strtoul(tmp, NULL, 8);
+}
+
+static int tar_skip(int fd, int len)
+{
+	char tmp[TAR_BLOCK];
+	int r;
+
+	while (len > 0) {
+		r = read_full(fd, tmp, len > sizeof(tmp) ? sizeof(tmp) : len);
+		if (r <= 0)
+			return -1;
+		len -= r;
+	}
+
+	return 0;
+}
+
+/*
+ * Look up the inode of a directory created from the archive, creating
+ * it and its parents if necessary. The empty path is the target dir.
+ */
+static int tar_dir_ino(const char *path, int mode, int mtime)
+{
+	const char *name;
+	char *parent;
+	int i, ino;
+
+	if (!*path)
+		return target_ino;
+
+	for (i = 0; i < n_tar_dirs; i++)
+		if (!strcmp(tar_dirs[i].path, path))
+			return tar_dirs[i].ino;
+
+	parent = strdup(path);
+	name = strrchr(path, '/');
+	if (name) {
+		parent[name - path] = 0;
+		name++;
+	} else {
+		parent[0] = 0;
+		name = path;
+	}
+
+	ino = add_dir(name, tar_dir_ino(parent, 0755, mtime), mode, mtime);
+	free(parent);
+
+	tar_dirs = realloc(tar_dirs, (n_tar_dirs + 1) * sizeof(*tar_dirs));
+	tar_dirs[n_tar_dirs].path = strdup(path);
+	tar_dirs[n_tar_dirs].ino = ino;
+	n_tar_dirs++;
+
+	return ino;
+}
+
+static int tar_open(const char *name, pid_t *pid)
+{
+	unsigned char magic[2];
+	int fd, p[2];
+
+	*pid = 0;
+	if (!strcmp(name, "-"))
+		fd = 0;
+	else if ((fd = open(name, O_RDONLY)) < 0)
+		return -1;
+
+	/* gzip compressed archives are only detected on seekable input */
+	if (pread(fd, magic, 2, 0) != 2 || magic[0] != 0x1f || magic[1] != 0x8b)
+		return fd;
+
+	if (pipe(p))
+		return -1;
+
+	*pid = fork();
+	if (*pid < 0)
+		return -1;
+
+	if (!*pid) {
+		close(p[0]);
+		dup2(fd, 0);
+		dup2(p[1], 1);
+		execlp("zcat", "zcat", NULL);
+		_exit(127);
+	}
+
+	close(p[1]);
+	close(fd);
+
+	return p[0];
+}
+
+/*
+ * Unpack a tar archive into the target directory, creating the dirent
+ * and inode nodes for every entry directly instead of storing the
+ * archive as a single file.
+ */
+static int add_tar(const char *name)
+{
+	unsigned char hdr[TAR_BLOCK];
+	char path[256 + 2], longname[256], *fname;
+	int fd, i, ret = -1, status;
+	pid_t pid;
+
+	fd = tar_open(name, &pid);
+	if (fd < 0) {
+		fprintf(stderr, "Failed to open archive %s\n", name);
+		return -1;
+	}
+
+	longname[0] = 0;
 	for (;;) {
-		int len = 0;
+		struct jffs2_raw_inode ri;
+		unsigned long size, skip, sum = 0, mode, mtime;
+		char *p;
+		int len;
 
-		for (;;) {
-			len = rbytes() - sizeof(ri);
-			if (len > 128)
+		if (read_full(fd, hdr, sizeof(hdr)) != sizeof(hdr))
+			break;
+
+		for (i = 0; i < sizeof(hdr); i++)
+			sum += (i >= 148 && i < 156) ? ' ' : hdr[i];
+
+		if (sum == 8 * ' ') {
+			/* end of archive */
+			ret = 0;
+			break;
+		}
+
+		if (sum != tar_num((char *) hdr + 148, 8))
+			break;
+
+		size = tar_num((char *) hdr + 124, 12);
+		skip = (size + TAR_BLOCK - 1) & ~(TAR_BLOCK - 1);
+		mode = tar_num((char *) hdr + 100, 8) & 07777;
+		mtime = tar_num((char *) hdr + 136, 12);
+
+		if (hdr[156] == 'L') {
+			if (size >= sizeof(longname) ||
+			    read_full(fd, longname, size) != size ||
+			    tar_skip(fd, -size & (TAR_BLOCK - 1)))
 				break;
+			longname[size] = 0;
+			continue;
+		}
 
-			pad(erasesize);
-			prep_eraseblock();
+		if (longname[0]) {
+			strcpy(path, longname);
+			longname[0] = 0;
+		} else if (hdr[345] && !memcmp(hdr + 257, "ustar", 5)) {
+			snprintf(path, sizeof(path), "%.155s/%.100s", hdr + 345, hdr);
+		} else {
+			snprintf(path, sizeof(path), "%.100s", hdr);
 		}
 
-		if (len > sizeof(wbuf))
-			len = sizeof(wbuf);
+		p = path;
+		while (*p == '/' || (p[0] == '.' && (p[1] == '/' || !p[1])))
+			p += (*p == '/') ? 1 : 1 + !!p[1];
 
-		len = read(fd, wbuf, len);
-		if (len <= 0)
+		if (!strcmp(p, "..") || !strncmp(p, "../", 3) || strstr(p, "/../") ||
+		    (strlen(p) > 2 && !strcmp(p + strlen(p) - 3, "/.."))) {
+			fprintf(stderr, "Skipping archive entry %s\n", p);
+			hdr[156] = 0xff;
+		}
+
+		len = strlen(p);
+		while (len > 0 && p[len - 1] == '/')
+			p[--len] = 0;
+
+		fname = strrchr(p, '/');
+		if (fname)
+			*fname++ = 0;
+
+		switch (hdr[156]) {
+		case 0xff:
 			break;
+		case '0':
+		case '\0':
+			if (!*p && !fname)
+				break;
 
-		ri.totlen = sizeof(ri) + len;
-		ri.hdr_crc = crc32(0, &ri, sizeof(struct jffs2_unknown_node) - 4);
-		ri.version = ++last_version;
-		ri.offset = f_offset;
-		ri.csize = ri.dsize = len;
-		ri.node_crc = crc32(0, &ri, sizeof(ri) - 8);
-		ri.data_crc = crc32(0, wbuf, len);
-		f_offset += len;
-		add_data((char *) &ri, sizeof(ri));
-		add_data(wbuf, len);
-		pad(4);
-		prep_eraseblock();
+			memset(&ri, 0, sizeof(ri));
+			ri.magic = JFFS2_MAGIC_BITMASK;
+			ri.nodetype = JFFS2_NODETYPE_INODE;
+			ri.mode = S_IFREG | mode;
+			ri.uid = tar_num((char *) hdr + 108, 8);
+			ri.gid = tar_num((char *) hdr + 116, 8);
+			ri.atime = ri.ctime = ri.mtime = mtime;
+			ri.isize = size;
+
+			if (fname)
+				i = tar_dir_ino(p, 0755, mtime);
+			else
+				i = target_ino, fname = p;
+
+			ri.ino = add_dirent(fname, IFTODT(S_IFREG), i);
+			if (add_inode_data(&ri, fd, size))
+				goto out;
+
+			/* only the padding to the next block is left */
+			skip -= size;
+			break;
+		case '2':
+			if (!*p && !fname)
+				break;
+
+			snprintf(longname, sizeof(longname), "%.100s", hdr + 157);
+			if (fname)
+				add_symlink(fname, longname, tar_dir_ino(p, 0755, mtime), mtime);
+			else
+				add_symlink(p, longname, target_ino, mtime);
+			longname[0] = 0;
+			break;
+		case '5':
+			if (fname)
+				fname[-1] = '/';
+			tar_dir_ino(p, mode, mtime);
+			break;
+		default:
+			if (fname)
+				fname[-1] = '/';
+			if (!quiet)
+				fprintf(stderr, "Skipping unsupported archive entry %s\n", p);
+			break;
+		}
+
+		if (tar_skip(fd, skip))
+			break;
 	}
 
-	close(fd);
+out:
+	if (ret)
+		fprintf(stderr, "Failed to read archive %s\n", name);
+
+	if (fd)
+		close(fd);
+
+	if (pid && (waitpid(pid, &status, 0) != pid ||
+		    !WIFEXITED(status) || WEXITSTATUS(status))) {
+		fprintf(stderr, "Failed to decompress archive %s\n", name);
+		ret = -1;
+	}
+
+	for (i = 0; i < n_tar_dirs; i++)
+		free(tar_dirs[i].path);
+	free(tar_dirs);
+	tar_dirs = NULL;
+	n_tar_dirs = 0;
+
+	return ret;
+}
+
+static int add_source(const char *name, int parent)
+{
+	if (jffs2_untar)
+		return add_tar(name);
+
+	add_file(name, parent);
+	return 0;
+}
+
+static void print_stats(int written)
+{
+	if (quiet > 1)
+		return;
+
+	fprintf(stderr, "\njffs2: stored %u bytes of file data in %u bytes (%u%%), %d bytes of flash written\n",
+		raw_bytes, stored_bytes,
+		raw_bytes ? (unsigned int) ((stored_bytes * 100ULL) / raw_bytes) : 100,
+		written);
 }
 
 int mtd_replace_jffs2(const char *mtd, int fd, int ofs, const char *filename)
@@ -245,7 +684,7 @@ int mtd_replace_jffs2(const char *mtd, int fd, int ofs, const char *filename)
 	target_ino = 1;
 	if (!last_ino)
 		last_ino = 1;
-	add_file(filename, target_ino);
+	add_source(filename, target_ino);
 	pad(erasesize);
 
 	/* add eof marker, pad to eraseblock size and write the data */
@@ -253,6 +692,8 @@ int mtd_replace_jffs2(const char *mtd, int fd, int ofs, const char *filename)
 	pad(erasesize);
 	free(buf);
 
+	print_stats(mtdofs - ofs);
+
 	return (mtdofs - ofs);
 }
 
@@ -285,7 +726,7 @@ void mtd_parse_jffs2data(const char *buf, const char *dir)
 
 int mtd_write_jffs2(const char *mtd, const char *filename, const char *dir)
 {
-	int err = -1, fdeof = 0;
+	int err = -1, fdeof = 0, start;
 
 	outfd = mtd_check_open(mtd);
 	if (outfd < 0)
@@ -337,21 +778,22 @@ int mtd_write_jffs2(const char *mtd, const char *filename, const char *dir)
 	lseek(outfd, mtdofs, SEEK_SET);
 
 	ofs = 0;
+	start = mtdofs;
 
 	if (!last_ino)
 		last_ino = 1;
 
 	if (!target_ino)
-		target_ino = add_dir(dir, 1);
+		target_ino = add_dir(dir, 1, 0755, 0);
 
-	add_file(filename, target_ino);
+	err = add_source(filename, target_ino);
 	pad(erasesize);
 
 	/* add eof marker, pad to eraseblock size and write the data */
 	add_data(JFFS2_EOF, sizeof(JFFS2_EOF) - 1);
 	pad(erasesize);
 
-	err = 0;
+	print_stats(mtdofs - start);
 
 	if (trx_fixup) {
 	  trx_fixup(outfd, mtd);
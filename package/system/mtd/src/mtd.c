@@ -607,6 +607,8 @@ static void usage(void)
 	"        -e <device>             erase <device> before executing the command\n"
 	"        -d <name>               directory for jffs2write, defaults to \"tmp\"\n"
 	"        -j <name>               integrate <file> into jffs2 data when writing an image\n"
+	"        -t                      unpack the (optionally gzip compressed) tar archive given\n"
+	"                                to jffs2write or -j instead of storing it as a file\n"
 	"        -s <number>             skip the first n bytes when appending data to the jffs2 partiton, defaults to \"0\"\n"
 	"        -p                      write beginning at partition offset\n");
 	if (mtd_fixtrx) {
@@ -666,7 +668,7 @@ int main (int argc, char **argv)
 #ifdef FIS_SUPPORT
 			"F:"
 #endif
-			"frnqe:d:s:j:p:o:")) != -1)
+			"frnqte:d:s:j:p:o:")) != -1)
 		switch (ch) {
 			case 'f':
 				force = 1;
@@ -680,6 +682,9 @@ int main (int argc, char **argv)
 			case 'j':
 				jffs2file = optarg;
 				break;
+			case 't':
+				jffs2_untar = true;
+				break;
 			case 's':
 				errno = 0;
 				jffs2_skip_bytes = strtoul(optarg, 0, 0);
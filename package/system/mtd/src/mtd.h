@@ -10,6 +10,7 @@
 #define JFFS2_EOF "\xde\xad\xc0\xde"
 
 extern int quiet;
+extern bool jffs2_untar;
 extern int mtdsize;
 extern int erasesize;
 
@@ -935,12 +935,97 @@ static void mpi_mul_hlp( int i, t_int *s, t_int *d, t_int b )
     while( c != 0 );
 }
 
+#if defined(POLARSSL_HAVE_LONGLONG)
+
+/*
+ * Comba column accumulator: (c2:c1:c0) += r1:r0
+ */
+#define COMBA_ADD(r0, r1)                       \
+{                                               \
+    t_int t1 = r1;                              \
+    c0 += r0; t1 += ( c0 < r0 );                \
+    c1 += t1; c2 += ( c1 < t1 );                \
+}
+
+#define COMBA_MULADD(a, b)                      \
+{                                               \
+    t_dbl r = (t_dbl) (a) * (b);                \
+    t_int r0 = (t_int) r;                       \
+    t_int r1 = (t_int) ( r >> biL );            \
+    COMBA_ADD( r0, r1 )                         \
+}
+
+#define COMBA_MULADD2(a, b)                     \
+{                                               \
+    t_dbl r = (t_dbl) (a) * (b);                \
+    t_int r0 = (t_int) r;                       \
+    t_int r1 = (t_int) ( r >> biL );            \
+    COMBA_ADD( r0, r1 )                         \
+    COMBA_ADD( r0, r1 )                         \
+}
+
+/*
+ * Comba multiplication of two n-limb numbers: d[0..2n-1] = a * b
+ *
+ * The product is built one column at a time, so every result limb
+ * is stored exactly once instead of being read and written back for
+ * each row as in mpi_mul_hlp().
+ */
+static void mpi_mul_comba( int n, t_int *a, t_int *b, t_int *d )
+{
+    int i, k, lo, hi;
+    t_int c0 = 0, c1 = 0, c2 = 0;
+
+    for( k = 0; k < 2 * n - 1; k++ )
+    {
+        lo = ( k < n ) ? 0 : k - n + 1;
+        hi = ( k < n ) ? k : n - 1;
+
+        for( i = lo; i <= hi; i++ )
+            COMBA_MULADD( a[i], b[k - i] );
+
+        d[k] = c0; c0 = c1; c1 = c2; c2 = 0;
+    }
+
+    d[2 * n - 1] = c0;
+}
+
+/*
+ * Comba squaring of a n-limb number: d[0..2n-1] = a * a
+ *
+ * Each cross product a[i] * a[j] (i != j) appears twice in a column,
+ * compute it once and add it twice; this saves almost half of the
+ * limb multiplications compared to mpi_mul_comba().
+ */
+static void mpi_sqr_comba( int n, t_int *a, t_int *d )
+{
+    int i, k, lo;
+    t_int c0 = 0, c1 = 0, c2 = 0;
+
+    for( k = 0; k < 2 * n - 1; k++ )
+    {
+        lo = ( k < n ) ? 0 : k - n + 1;
+
+        for( i = lo; i < k - i; i++ )
+            COMBA_MULADD2( a[i], a[k - i] );
+
+        if( ( k & 1 ) == 0 )
+            COMBA_MULADD( a[k >> 1], a[k >> 1] );
+
+        d[k] = c0; c0 = c1; c1 = c2; c2 = 0;
+    }
+
+    d[2 * n - 1] = c0;
+}
+
+#endif /* POLARSSL_HAVE_LONGLONG */
+
 /*
  * Baseline multiplication: X = A * B  (HAC 14.12)
  */
 int mpi_mul_mpi( mpi *X, mpi *A, mpi *B )
 {
-    int ret, i, j;
+    int ret, i, j, sqr = ( A == B );
     mpi TA, TB;
 
     mpi_init( &TA, &TB, NULL );
@@ -959,6 +1044,21 @@ int mpi_mul_mpi( mpi *X, mpi *A, mpi *B )
     MPI_CHK( mpi_grow( X, i + j + 2 ) );
     MPI_CHK( mpi_lset( X, 0 ) );
 
+#if defined(POLARSSL_HAVE_LONGLONG)
+    if( i == j && i >= 0 )
+    {
+        if( sqr )
+            mpi_sqr_comba( i + 1, A->p, X->p );
+        else
+            mpi_mul_comba( i + 1, A->p, B->p, X->p );
+
+        X->s = A->s * B->s;
+        goto cleanup;
+    }
+#else
+    (void) sqr;
+#endif
+
     for( i++; j >= 0; j-- )
         mpi_mul_hlp( i, A->p, X->p + j, B->p[j] );
 
@@ -1270,6 +1370,26 @@ static void mpi_montmul( mpi *A, mpi *B, mpi *N, t_int mm, mpi *T )
     n = N->n;
     m = ( B->n < n ) ? B->n : n;
 
+#if defined(POLARSSL_HAVE_LONGLONG)
+    if( m == n )
+    {
+        /*
+         * T = A * B with Comba (or squaring if A == B), then
+         * reduce:  T = (T + u*N) / 2^biL, n times  (HAC 14.32)
+         */
+        if( A == B )
+            mpi_sqr_comba( n, A->p, d );
+        else
+            mpi_mul_comba( n, A->p, B->p, d );
+
+        for( i = 0; i < n; i++ )
+            mpi_mul_hlp( n, N->p, d + i, d[i] * mm );
+
+        d += n;
+        goto done;
+    }
+#endif
+
     for( i = 0; i < n; i++ )
     {
         /*
@@ -1284,6 +1404,9 @@ static void mpi_montmul( mpi *A, mpi *B, mpi *N, t_int mm, mpi *T )
         *d++ = u0; d[n + 1] = 0;
     }
 
+#if defined(POLARSSL_HAVE_LONGLONG)
+done:
+#endif
     memcpy( A->p, d, (n + 1) * ciL );
 
     if( mpi_cmp_abs( A, N ) >= 0 )
@@ -1656,46 +1779,22 @@ static const int small_prime[] =
 };
 
 /*
- * Miller-Rabin primality test  (HAC 4.24)
+ * Miller-Rabin test of an odd X > 3  (HAC 4.24)
  */
-int mpi_is_prime( mpi *X, int (*f_rng)(void *), void *p_rng )
+static int mpi_miller_rabin( mpi *X, int (*f_rng)(void *), void *p_rng )
 {
-    int ret, i, j, n, s, xs;
+    int ret, i, j, n, s;
     mpi W, R, T, A, RR;
     unsigned char *p;
 
-    if( mpi_cmp_int( X, 0 ) == 0 )
-        return( 0 );
-
     mpi_init( &W, &R, &T, &A, &RR, NULL );
 
-    xs = X->s; X->s = 1;
-
-    /*
-     * test trivial factors first
-     */
-    if( ( X->p[0] & 1 ) == 0 )
-        return( POLARSSL_ERR_MPI_NOT_ACCEPTABLE );
-
-    for( i = 0; small_prime[i] > 0; i++ )
-    {
-        t_int r;
-
-        if( mpi_cmp_int( X, small_prime[i] ) <= 0 )
-            return( 0 );
-
-        MPI_CHK( mpi_mod_int( &r, X, small_prime[i] ) );
-
-        if( r == 0 )
-            return( POLARSSL_ERR_MPI_NOT_ACCEPTABLE );
-    }
-
     /*
      * W = |X| - 1
      * R = W >> lsb( W )
      */
-    s = mpi_lsb( &W );
     MPI_CHK( mpi_sub_int( &W, X, 1 ) );
+    s = mpi_lsb( &W );
     MPI_CHK( mpi_copy( &R, &W ) );
     MPI_CHK( mpi_shift_r( &R, s ) );
 
@@ -1759,21 +1858,80 @@ int mpi_is_prime( mpi *X, int (*f_rng)(void *), void *p_rng )
 
 cleanup:
 
-    X->s = xs;
-
     mpi_free( &RR, &A, &T, &R, &W, NULL );
 
     return( ret );
 }
 
+/*
+ * Pseudo-primality test: trial division, then Miller-Rabin
+ */
+int mpi_is_prime( mpi *X, int (*f_rng)(void *), void *p_rng )
+{
+    int ret, i, xs;
+
+    if( mpi_cmp_int( X, 0 ) == 0 )
+        return( 0 );
+
+    xs = X->s; X->s = 1;
+
+    /*
+     * test trivial factors first
+     */
+    if( ( X->p[0] & 1 ) == 0 )
+    {
+        ret = POLARSSL_ERR_MPI_NOT_ACCEPTABLE;
+        goto cleanup;
+    }
+
+    for( i = 0; small_prime[i] > 0; i++ )
+    {
+        t_int r;
+
+        if( mpi_cmp_int( X, small_prime[i] ) <= 0 )
+        {
+            ret = 0;
+            goto cleanup;
+        }
+
+        MPI_CHK( mpi_mod_int( &r, X, small_prime[i] ) );
+
+        if( r == 0 )
+        {
+            ret = POLARSSL_ERR_MPI_NOT_ACCEPTABLE;
+            goto cleanup;
+        }
+    }
+
+    ret = mpi_miller_rabin( X, f_rng, p_rng );
+
+cleanup:
+
+    X->s = xs;
+
+    return( ret );
+}
+
+#define SMALL_PRIME_COUNT \
+    ( (int) ( sizeof( small_prime ) / sizeof( small_prime[0] ) ) - 1 )
+
 /*
  * Prime number generation
+ *
+ * Candidates are walked in steps of 2 (4 for safe primes) from a random
+ * odd start. The residues of the candidate modulo the small primes are
+ * computed once and then advanced incrementally, so most composites are
+ * discarded without touching the bignum at all; only sieve survivors go
+ * through Miller-Rabin. For safe primes (dh_flag), X = 2Y + 1 and Y is
+ * divisible by p exactly when X = 1 mod p, which is sieved out as well.
  */
 int mpi_gen_prime( mpi *X, int nbits, int dh_flag,
                    int (*f_rng)(void *), void *p_rng )
 {
-    int ret, k, n;
+    int ret, i, k, n, step;
     unsigned char *p;
+    t_int r;
+    int mods[SMALL_PRIME_COUNT];
     mpi Y;
 
     if( nbits < 3 )
@@ -1796,39 +1954,97 @@ int mpi_gen_prime( mpi *X, int nbits, int dh_flag,
 
     X->p[0] |= 3;
 
-    if( dh_flag == 0 )
+    /*
+     * too small to sieve, every small prime would look like a factor
+     */
+    if( mpi_cmp_int( X, small_prime[SMALL_PRIME_COUNT - 1] ) <= 0 )
     {
-        while( ( ret = mpi_is_prime( X, f_rng, p_rng ) ) != 0 )
+        if( dh_flag == 0 )
         {
-            if( ret != POLARSSL_ERR_MPI_NOT_ACCEPTABLE )
-                goto cleanup;
+            while( ( ret = mpi_is_prime( X, f_rng, p_rng ) ) != 0 )
+            {
+                if( ret != POLARSSL_ERR_MPI_NOT_ACCEPTABLE )
+                    goto cleanup;
 
-            MPI_CHK( mpi_add_int( X, X, 2 ) );
+                MPI_CHK( mpi_add_int( X, X, 2 ) );
+            }
         }
-    }
-    else
-    {
-        MPI_CHK( mpi_sub_int( &Y, X, 1 ) );
-        MPI_CHK( mpi_shift_r( &Y, 1 ) );
-
-        while( 1 )
+        else
         {
-            if( ( ret = mpi_is_prime( X, f_rng, p_rng ) ) == 0 )
+            MPI_CHK( mpi_sub_int( &Y, X, 1 ) );
+            MPI_CHK( mpi_shift_r( &Y, 1 ) );
+
+            while( 1 )
             {
-                if( ( ret = mpi_is_prime( &Y, f_rng, p_rng ) ) == 0 )
-                    break;
+                if( ( ret = mpi_is_prime( X, f_rng, p_rng ) ) == 0 )
+                {
+                    if( ( ret = mpi_is_prime( &Y, f_rng, p_rng ) ) == 0 )
+                        break;
+
+                    if( ret != POLARSSL_ERR_MPI_NOT_ACCEPTABLE )
+                        goto cleanup;
+                }
 
                 if( ret != POLARSSL_ERR_MPI_NOT_ACCEPTABLE )
                     goto cleanup;
+
+                MPI_CHK( mpi_add_int( &Y, X, 1 ) );
+                MPI_CHK( mpi_add_int(  X, X, 2 ) );
+                MPI_CHK( mpi_shift_r( &Y, 1 ) );
             }
+        }
 
-            if( ret != POLARSSL_ERR_MPI_NOT_ACCEPTABLE )
-                goto cleanup;
+        goto cleanup;
+    }
+
+    for( i = 0; i < SMALL_PRIME_COUNT; i++ )
+    {
+        MPI_CHK( mpi_mod_int( &r, X, small_prime[i] ) );
+        mods[i] = (int) r;
+    }
 
-            MPI_CHK( mpi_add_int( &Y, X, 1 ) );
-            MPI_CHK( mpi_add_int(  X, X, 2 ) );
+    /*
+     * safe primes need an odd Y, so keep X = 3 mod 4
+     */
+    step = ( dh_flag != 0 ) ? 4 : 2;
+
+    for( k = 0; ; k += step )
+    {
+        for( i = 0; i < SMALL_PRIME_COUNT; i++ )
+        {
+            int m = ( mods[i] + k ) % small_prime[i];
+
+            if( m == 0 || ( dh_flag != 0 && m == 1 ) )
+                break;
+        }
+
+        if( i < SMALL_PRIME_COUNT )
+            continue;
+
+        /*
+         * sieve survivor: X += k, restart the walk from there
+         */
+        MPI_CHK( mpi_add_int( X, X, k ) );
+
+        for( i = 0; i < SMALL_PRIME_COUNT; i++ )
+            mods[i] = ( mods[i] + k ) % small_prime[i];
+        k = 0;
+
+        ret = mpi_miller_rabin( X, f_rng, p_rng );
+
+        if( ret == 0 && dh_flag != 0 )
+        {
+            MPI_CHK( mpi_sub_int( &Y, X, 1 ) );
             MPI_CHK( mpi_shift_r( &Y, 1 ) );
+
+            ret = mpi_miller_rabin( &Y, f_rng, p_rng );
         }
+
+        if( ret == 0 )
+            break;
+
+        if( ret != POLARSSL_ERR_MPI_NOT_ACCEPTABLE )
+            goto cleanup;
     }
 
 cleanup:
@@ -0,0 +1,521 @@
+/*
+ *  Elliptic curve DSA on the NIST P-256 curve
+ *
+ *  Copyright (C) 2015 OpenWrt.org
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License, version 2.1 as published by the Free Software Foundation.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ *  MA  02110-1301  USA
+ */
+/*
+ *  The curve and the signature scheme are specified in FIPS 186-3,
+ *  the point formulas are taken from the Explicit-Formulas Database.
+ *
+ *  http://csrc.nist.gov/publications/fips/fips186-3/fips_186-3.pdf
+ *  http://www.hyperelliptic.org/EFD/g1p/auto-shortw-jacobian-3.html
+ */
+
+#include "polarssl/config.h"
+
+#if defined(POLARSSL_ECDSA_C)
+
+#include "polarssl/ecdsa.h"
+
+#include <string.h>
+
+#define ciL    ((int) sizeof(t_int))    /* chars in limb  */
+#define biL    (ciL << 3)               /* bits  in limb  */
+
+/*
+ * Domain parameters of secp256r1 (a = -3)
+ */
+#define P256_P  "FFFFFFFF00000001000000000000000000000000FFFFFFFFFFFFFFFFFFFFFFFF"
+#define P256_B  "5AC635D8AA3A93E7B3EBBD55769886BC651D06B0CC53B0F63BCE3C3E27D2604B"
+#define P256_N  "FFFFFFFF00000000FFFFFFFFFFFFFFFFBCE6FAADA7179E84F3B9CAC2FC632551"
+#define P256_GX "6B17D1F2E12C4247F8BCE6E563A440F277037D812DEB33A0F4A13945D898C296"
+#define P256_GY "4FE342E2FE1A7F9B8EE7EB4A7C0F9E162BCE33576B315ECECBB6406837BF51F5"
+
+/*
+ * Width of the window used for scalar multiplication
+ */
+#define ECP_WINDOW      4
+
+static void ecp_point_init( ecp_point *R )
+{
+    mpi_init( &R->X, &R->Y, &R->Z, NULL );
+}
+
+static void ecp_point_free( ecp_point *R )
+{
+    mpi_free( &R->Z, &R->Y, &R->X, NULL );
+}
+
+static int ecp_point_copy( ecp_point *R, ecp_point *A )
+{
+    int ret;
+
+    MPI_CHK( mpi_copy( &R->X, &A->X ) );
+    MPI_CHK( mpi_copy( &R->Y, &A->Y ) );
+    MPI_CHK( mpi_copy( &R->Z, &A->Z ) );
+
+cleanup:
+
+    return( ret );
+}
+
+/*
+ * Field arithmetic, all operands are in [0, P)
+ */
+static int ecp_mul_mod( ecdsa_context *ctx, mpi *X, mpi *A, mpi *B )
+{
+    int ret;
+
+    MPI_CHK( mpi_mul_mpi( X, A, B ) );
+    MPI_CHK( mpi_mod_mpi( X, X, &ctx->P ) );
+
+cleanup:
+
+    return( ret );
+}
+
+static int ecp_mul_int_mod( ecdsa_context *ctx, mpi *X, mpi *A, t_int b )
+{
+    int ret;
+
+    MPI_CHK( mpi_mul_int( X, A, b ) );
+
+    while( mpi_cmp_mpi( X, &ctx->P ) >= 0 )
+        MPI_CHK( mpi_sub_abs( X, X, &ctx->P ) );
+
+cleanup:
+
+    return( ret );
+}
+
+static int ecp_add_mod( ecdsa_context *ctx, mpi *X, mpi *A, mpi *B )
+{
+    int ret;
+
+    MPI_CHK( mpi_add_mpi( X, A, B ) );
+
+    if( mpi_cmp_mpi( X, &ctx->P ) >= 0 )
+        MPI_CHK( mpi_sub_abs( X, X, &ctx->P ) );
+
+cleanup:
+
+    return( ret );
+}
+
+static int ecp_sub_mod( ecdsa_context *ctx, mpi *X, mpi *A, mpi *B )
+{
+    int ret;
+
+    MPI_CHK( mpi_sub_mpi( X, A, B ) );
+
+    if( mpi_cmp_int( X, 0 ) < 0 )
+        MPI_CHK( mpi_add_mpi( X, X, &ctx->P ) );
+
+cleanup:
+
+    return( ret );
+}
+
+/*
+ * R = 2 * A  (dbl-2001-b)
+ */
+static int ecp_double( ecdsa_context *ctx, ecp_point *R, ecp_point *A )
+{
+    int ret;
+    mpi T1, T2, T3, T4, T5;
+
+    if( mpi_cmp_int( &A->Z, 0 ) == 0 )
+        return( ecp_point_copy( R, A ) );
+
+    mpi_init( &T1, &T2, &T3, &T4, &T5, NULL );
+
+    /* T1 = delta = Z^2, T2 = gamma = Y^2, T3 = beta = X * gamma */
+    MPI_CHK( ecp_mul_mod( ctx, &T1, &A->Z, &A->Z ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T2, &A->Y, &A->Y ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T3, &A->X, &T2 ) );
+
+    /* T4 = alpha = 3 * (X - delta) * (X + delta) */
+    MPI_CHK( ecp_sub_mod( ctx, &T4, &A->X, &T1 ) );
+    MPI_CHK( ecp_add_mod( ctx, &T5, &A->X, &T1 ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T4, &T4, &T5 ) );
+    MPI_CHK( ecp_mul_int_mod( ctx, &T4, &T4, 3 ) );
+
+    /* T5 = Z3 = (Y + Z)^2 - gamma - delta */
+    MPI_CHK( ecp_add_mod( ctx, &T5, &A->Y, &A->Z ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T5, &T5, &T5 ) );
+    MPI_CHK( ecp_sub_mod( ctx, &T5, &T5, &T2 ) );
+    MPI_CHK( ecp_sub_mod( ctx, &T5, &T5, &T1 ) );
+
+    /* T1 = X3 = alpha^2 - 8 * beta */
+    MPI_CHK( ecp_mul_int_mod( ctx, &T3, &T3, 4 ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T1, &T4, &T4 ) );
+    MPI_CHK( ecp_sub_mod( ctx, &T1, &T1, &T3 ) );
+    MPI_CHK( ecp_sub_mod( ctx, &T1, &T1, &T3 ) );
+
+    /* T3 = Y3 = alpha * (4 * beta - X3) - 8 * gamma^2 */
+    MPI_CHK( ecp_sub_mod( ctx, &T3, &T3, &T1 ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T3, &T3, &T4 ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T2, &T2, &T2 ) );
+    MPI_CHK( ecp_mul_int_mod( ctx, &T2, &T2, 8 ) );
+    MPI_CHK( ecp_sub_mod( ctx, &T3, &T3, &T2 ) );
+
+    mpi_swap( &R->X, &T1 );
+    mpi_swap( &R->Y, &T3 );
+    mpi_swap( &R->Z, &T5 );
+
+cleanup:
+
+    mpi_free( &T5, &T4, &T3, &T2, &T1, NULL );
+
+    return( ret );
+}
+
+/*
+ * R = A + B, B must be affine (Z = 1)  (add-1998-cmo-2 with Z2 = 1)
+ */
+static int ecp_add_mixed( ecdsa_context *ctx, ecp_point *R,
+                          ecp_point *A, ecp_point *B )
+{
+    int ret;
+    mpi T1, T2, T3, T4, T5, T6;
+
+    if( mpi_cmp_int( &A->Z, 0 ) == 0 )
+        return( ecp_point_copy( R, B ) );
+
+    mpi_init( &T1, &T2, &T3, &T4, &T5, &T6, NULL );
+
+    /* T2 = H = X2 * Z1^2 - X1, T1 = r = Y2 * Z1^3 - Y1 */
+    MPI_CHK( ecp_mul_mod( ctx, &T1, &A->Z, &A->Z ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T2, &B->X, &T1 ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T1, &T1, &A->Z ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T1, &T1, &B->Y ) );
+    MPI_CHK( ecp_sub_mod( ctx, &T2, &T2, &A->X ) );
+    MPI_CHK( ecp_sub_mod( ctx, &T1, &T1, &A->Y ) );
+
+    if( mpi_cmp_int( &T2, 0 ) == 0 )
+    {
+        if( mpi_cmp_int( &T1, 0 ) == 0 )
+            ret = ecp_double( ctx, R, B );
+        else
+            ret = mpi_lset( &R->Z, 0 );
+
+        goto cleanup;
+    }
+
+    /* T4 = H^3, T3 = V = X1 * H^2, T5 = Z3 = Z1 * H */
+    MPI_CHK( ecp_mul_mod( ctx, &T3, &T2, &T2 ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T4, &T3, &T2 ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T3, &T3, &A->X ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T5, &A->Z, &T2 ) );
+
+    /* T6 = X3 = r^2 - H^3 - 2 * V */
+    MPI_CHK( ecp_mul_mod( ctx, &T6, &T1, &T1 ) );
+    MPI_CHK( ecp_sub_mod( ctx, &T6, &T6, &T4 ) );
+    MPI_CHK( ecp_sub_mod( ctx, &T6, &T6, &T3 ) );
+    MPI_CHK( ecp_sub_mod( ctx, &T6, &T6, &T3 ) );
+
+    /* T3 = Y3 = r * (V - X3) - Y1 * H^3 */
+    MPI_CHK( ecp_sub_mod( ctx, &T3, &T3, &T6 ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T3, &T3, &T1 ) );
+    MPI_CHK( ecp_mul_mod( ctx, &T4, &T4, &A->Y ) );
+    MPI_CHK( ecp_sub_mod( ctx, &T3, &T3, &T4 ) );
+
+    mpi_swap( &R->X, &T6 );
+    mpi_swap( &R->Y, &T3 );
+    mpi_swap( &R->Z, &T5 );
+
+cleanup:
+
+    mpi_free( &T6, &T5, &T4, &T3, &T2, &T1, NULL );
+
+    return( ret );
+}
+
+/*
+ * Convert R to affine coordinates
+ */
+static int ecp_normalize( ecdsa_context *ctx, ecp_point *R )
+{
+    int ret;
+    mpi ZI, ZZI;
+
+    if( mpi_cmp_int( &R->Z, 0 ) == 0 )
+        return( 0 );
+
+    mpi_init( &ZI, &ZZI, NULL );
+
+    MPI_CHK( mpi_inv_mod( &ZI, &R->Z, &ctx->P ) );
+    MPI_CHK( ecp_mul_mod( ctx, &ZZI, &ZI, &ZI ) );
+    MPI_CHK( ecp_mul_mod( ctx, &R->X, &R->X, &ZZI ) );
+    MPI_CHK( ecp_mul_mod( ctx, &R->Y, &R->Y, &ZZI ) );
+    MPI_CHK( ecp_mul_mod( ctx, &R->Y, &R->Y, &ZI ) );
+    MPI_CHK( mpi_lset( &R->Z, 1 ) );
+
+cleanup:
+
+    mpi_free( &ZZI, &ZI, NULL );
+
+    return( ret );
+}
+
+/*
+ * R = m * G, fixed window over the base point; the result is affine
+ */
+static int ecp_mul_base( ecdsa_context *ctx, ecp_point *R, mpi *m )
+{
+    int ret, i, j, w;
+    ecp_point T[1 << ECP_WINDOW], S;
+
+    for( i = 0; i < (1 << ECP_WINDOW); i++ )
+        ecp_point_init( &T[i] );
+    ecp_point_init( &S );
+
+    /* T[i] = i * G, affine */
+    MPI_CHK( ecp_point_copy( &T[1], &ctx->G ) );
+    for( i = 2; i < (1 << ECP_WINDOW); i++ )
+    {
+        MPI_CHK( ecp_add_mixed( ctx, &T[i], &T[i - 1], &ctx->G ) );
+        MPI_CHK( ecp_normalize( ctx, &T[i] ) );
+    }
+
+    MPI_CHK( mpi_lset( &S.X, 1 ) );
+    MPI_CHK( mpi_lset( &S.Y, 1 ) );
+    MPI_CHK( mpi_lset( &S.Z, 0 ) );
+
+    for( i = ( mpi_msb( m ) + ECP_WINDOW - 1 ) / ECP_WINDOW - 1; i >= 0; i-- )
+    {
+        for( j = 0; j < ECP_WINDOW; j++ )
+            MPI_CHK( ecp_double( ctx, &S, &S ) );
+
+        for( w = 0, j = ECP_WINDOW - 1; j >= 0; j-- )
+        {
+            int bit = i * ECP_WINDOW + j;
+
+            w = ( w << 1 ) | ( bit / biL < m->n ?
+                (int)( m->p[bit / biL] >> ( bit % biL ) ) & 1 : 0 );
+        }
+
+        if( w != 0 )
+            MPI_CHK( ecp_add_mixed( ctx, &S, &S, &T[w] ) );
+    }
+
+    MPI_CHK( ecp_normalize( ctx, &S ) );
+    MPI_CHK( ecp_point_copy( R, &S ) );
+
+cleanup:
+
+    ecp_point_free( &S );
+    for( i = 0; i < (1 << ECP_WINDOW); i++ )
+        ecp_point_free( &T[i] );
+
+    return( ret );
+}
+
+/*
+ * Draw a scalar uniformly from [1, N - 1]
+ */
+static int ecdsa_gen_scalar( ecdsa_context *ctx, mpi *k )
+{
+    int ret, i, count = 0;
+    unsigned char buf[64];
+
+    do
+    {
+        if( ++count > 30 )
+            return( POLARSSL_ERR_ECDSA_KEY_GEN_FAILED );
+
+        for( i = 0; i < ctx->len; i++ )
+            buf[i] = (unsigned char) ctx->f_rng( ctx->p_rng );
+
+        MPI_CHK( mpi_read_binary( k, buf, ctx->len ) );
+    }
+    while( mpi_cmp_int( k, 0 ) == 0 || mpi_cmp_mpi( k, &ctx->N ) >= 0 );
+
+cleanup:
+
+    memset( buf, 0, sizeof( buf ) );
+
+    return( ret );
+}
+
+/*
+ * Initialize an ECDSA context
+ */
+void ecdsa_init( ecdsa_context *ctx,
+                 int (*f_rng)(void *),
+                 void *p_rng )
+{
+    memset( ctx, 0, sizeof( ecdsa_context ) );
+
+    mpi_init( &ctx->P, &ctx->B, &ctx->N, &ctx->D, NULL );
+    ecp_point_init( &ctx->G );
+    ecp_point_init( &ctx->Q );
+
+    mpi_read_string( &ctx->P,   16, P256_P  );
+    mpi_read_string( &ctx->B,   16, P256_B  );
+    mpi_read_string( &ctx->N,   16, P256_N  );
+    mpi_read_string( &ctx->G.X, 16, P256_GX );
+    mpi_read_string( &ctx->G.Y, 16, P256_GY );
+    mpi_lset( &ctx->G.Z, 1 );
+
+    ctx->len = ( mpi_msb( &ctx->N ) + 7 ) >> 3;
+
+    ctx->f_rng = f_rng;
+    ctx->p_rng = p_rng;
+}
+
+/*
+ * Generate a key pair: D random, Q = D * G
+ */
+int ecdsa_gen_key( ecdsa_context *ctx )
+{
+    int ret;
+
+    if( ctx->f_rng == NULL )
+        return( POLARSSL_ERR_ECDSA_BAD_INPUT_DATA );
+
+    MPI_CHK( ecdsa_gen_scalar( ctx, &ctx->D ) );
+    MPI_CHK( ecp_mul_base( ctx, &ctx->Q, &ctx->D ) );
+
+cleanup:
+
+    if( ret != 0 )
+    {
+        ecdsa_free( ctx );
+        return( POLARSSL_ERR_ECDSA_KEY_GEN_FAILED | ret );
+    }
+
+    return( 0 );
+}
+
+/*
+ * Check Y^2 = X^3 - 3 * X + B
+ */
+int ecdsa_check_pubkey( ecdsa_context *ctx )
+{
+    int ret;
+    mpi YY, RHS;
+
+    if( mpi_cmp_int( &ctx->Q.Z, 1 ) != 0 ||
+        mpi_cmp_int( &ctx->Q.X, 0 ) < 0 || mpi_cmp_mpi( &ctx->Q.X, &ctx->P ) >= 0 ||
+        mpi_cmp_int( &ctx->Q.Y, 0 ) < 0 || mpi_cmp_mpi( &ctx->Q.Y, &ctx->P ) >= 0 )
+        return( POLARSSL_ERR_ECDSA_BAD_INPUT_DATA );
+
+    mpi_init( &YY, &RHS, NULL );
+
+    MPI_CHK( ecp_mul_mod( ctx, &YY, &ctx->Q.Y, &ctx->Q.Y ) );
+    MPI_CHK( ecp_mul_mod( ctx, &RHS, &ctx->Q.X, &ctx->Q.X ) );
+    MPI_CHK( ecp_mul_mod( ctx, &RHS, &RHS, &ctx->Q.X ) );
+    MPI_CHK( ecp_sub_mod( ctx, &RHS, &RHS, &ctx->Q.X ) );
+    MPI_CHK( ecp_sub_mod( ctx, &RHS, &RHS, &ctx->Q.X ) );
+    MPI_CHK( ecp_sub_mod( ctx, &RHS, &RHS, &ctx->Q.X ) );
+    MPI_CHK( ecp_add_mod( ctx, &RHS, &RHS, &ctx->B ) );
+
+    if( mpi_cmp_mpi( &YY, &RHS ) != 0 )
+        ret = POLARSSL_ERR_ECDSA_BAD_INPUT_DATA;
+
+cleanup:
+
+    mpi_free( &RHS, &YY, NULL );
+
+    return( ret );
+}
+
+/*
+ * r = (k * G).x mod N, s = k^-1 * (e + r * D) mod N
+ */
+int ecdsa_sign( ecdsa_context *ctx,
+                unsigned char *hash, int hashlen,
+                mpi *r, mpi *s )
+{
+    int ret, count = 0;
+    mpi e, k, ki;
+    ecp_point R;
+
+    mpi_init( &e, &k, &ki, NULL );
+    ecp_point_init( &R );
+
+    /* leftmost size(N) bytes of the digest, N has a whole number of bytes */
+    MPI_CHK( mpi_read_binary( &e, hash,
+                              hashlen > ctx->len ? ctx->len : hashlen ) );
+
+    do
+    {
+        if( ++count > 10 )
+        {
+            ret = POLARSSL_ERR_ECDSA_SIGN_FAILED;
+            goto cleanup;
+        }
+
+        MPI_CHK( ecdsa_gen_scalar( ctx, &k ) );
+        MPI_CHK( ecp_mul_base( ctx, &R, &k ) );
+        MPI_CHK( mpi_mod_mpi( r, &R.X, &ctx->N ) );
+
+        if( mpi_cmp_int( r, 0 ) == 0 )
+            continue;
+
+        MPI_CHK( mpi_mul_mpi( s, r, &ctx->D ) );
+        MPI_CHK( mpi_add_mpi( s, s, &e ) );
+        MPI_CHK( mpi_mod_mpi( s, s, &ctx->N ) );
+        MPI_CHK( mpi_inv_mod( &ki, &k, &ctx->N ) );
+        MPI_CHK( mpi_mul_mpi( s, s, &ki ) );
+        MPI_CHK( mpi_mod_mpi( s, s, &ctx->N ) );
+    }
+    while( mpi_cmp_int( r, 0 ) == 0 || mpi_cmp_int( s, 0 ) == 0 );
+
+cleanup:
+
+    ecp_point_free( &R );
+    mpi_free( &ki, &k, &e, NULL );
+
+    if( ret != 0 )
+        return( POLARSSL_ERR_ECDSA_SIGN_FAILED | ret );
+
+    return( 0 );
+}
+
+/*
+ * Export the public key as an uncompressed point
+ */
+int ecdsa_write_pubkey( ecdsa_context *ctx,
+                        unsigned char *buf, int buflen )
+{
+    int ret;
+
+    if( buflen < 2 * ctx->len + 1 )
+        return( POLARSSL_ERR_ECDSA_BAD_INPUT_DATA );
+
+    buf[0] = 0x04;
+    MPI_CHK( mpi_write_binary( &ctx->Q.X, buf + 1, ctx->len ) );
+    MPI_CHK( mpi_write_binary( &ctx->Q.Y, buf + 1 + ctx->len, ctx->len ) );
+
+cleanup:
+
+    return( ret );
+}
+
+/*
+ * Free the components of an ECDSA key
+ */
+void ecdsa_free( ecdsa_context *ctx )
+{
+    ecp_point_free( &ctx->Q );
+    ecp_point_free( &ctx->G );
+    mpi_free( &ctx->D, &ctx->N, &ctx->B, &ctx->P, NULL );
+}
+
+#endif
@@ -35,6 +35,8 @@
 #ifndef POLARSSL_BIGNUM_H
 #define POLARSSL_BIGNUM_H
 
+#include <limits.h>
+
 #include <stdio.h>
 
 #define POLARSSL_ERR_MPI_FILE_IO_ERROR                     -0x0002
@@ -64,10 +66,18 @@ typedef unsigned long  t_dbl;
   #else
     #if defined(__amd64__) || defined(__x86_64__)    || \
         defined(__ppc64__) || defined(__powerpc64__) || \
-        defined(__ia64__)  || defined(__alpha__)
+        defined(__ia64__)  || defined(__alpha__)     || \
+        defined(__SIZEOF_INT128__)
     typedef unsigned int t_dbl __attribute__((mode(TI)));
     #else
     typedef unsigned long long t_dbl;
+    #if ULONG_MAX > 0xFFFFFFFFUL
+    /*
+     * t_dbl is not wider than t_int here, the double-width
+     * products would be truncated
+     */
+    #undef POLARSSL_HAVE_LONGLONG
+    #endif
     #endif
   #endif
 #endif
@@ -56,9 +56,10 @@
  */
 
 /*
- * Uncomment if the compiler supports long long.
-#define POLARSSL_HAVE_LONGLONG
+ * Comment if the compiler does not support long long. Ignored on 64-bit
+ * targets without a 128-bit integer type (see bignum.h).
  */
+#define POLARSSL_HAVE_LONGLONG
 
 
 /*
@@ -180,6 +181,14 @@
  */
 #define POLARSSL_DHM_C
 
+/*
+ * Module:  library/ecdsa.c
+ * Caller:  library/x509write.c
+ *
+ * This module adds ECDSA key generation and signing on NIST P-256.
+ */
+#define POLARSSL_ECDSA_C
+
 /*
  * Module:  library/havege.c
  * Caller:
@@ -0,0 +1,134 @@
+/**
+ * \file ecdsa.h
+ *
+ *  Copyright (C) 2015 OpenWrt.org
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License, version 2.1 as published by the Free Software Foundation.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ *  MA  02110-1301  USA
+ */
+#ifndef POLARSSL_ECDSA_H
+#define POLARSSL_ECDSA_H
+
+#include "polarssl/bignum.h"
+
+#define POLARSSL_ERR_ECDSA_BAD_INPUT_DATA                  -0x0500
+#define POLARSSL_ERR_ECDSA_KEY_GEN_FAILED                  -0x0510
+#define POLARSSL_ERR_ECDSA_SIGN_FAILED                     -0x0520
+
+/**
+ * \brief          Point on the curve in jacobian coordinates,
+ *                 Z = 0 is the point at infinity
+ */
+typedef struct
+{
+    mpi X;                      /*!<  X coordinate      */
+    mpi Y;                      /*!<  Y coordinate      */
+    mpi Z;                      /*!<  Z coordinate      */
+}
+ecp_point;
+
+/**
+ * \brief          ECDSA context structure (NIST P-256 only)
+ */
+typedef struct
+{
+    int len;                    /*!<  size(N) in chars  */
+
+    mpi P;                      /*!<  field prime       */
+    mpi B;                      /*!<  curve constant b  */
+    mpi N;                      /*!<  group order       */
+    ecp_point G;                /*!<  base point        */
+
+    mpi D;                      /*!<  private key       */
+    ecp_point Q;                /*!<  public key, Z = 1 */
+
+    int (*f_rng)(void *);       /*!<  RNG function      */
+    void *p_rng;                /*!<  RNG parameter     */
+}
+ecdsa_context;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief          Initialize an ECDSA context with the P-256 curve
+ *
+ * \param ctx      ECDSA context to be initialized
+ * \param f_rng    RNG function
+ * \param p_rng    RNG parameter
+ */
+void ecdsa_init( ecdsa_context *ctx,
+                 int (*f_rng)(void *),
+                 void *p_rng );
+
+/**
+ * \brief          Generate a key pair
+ *
+ * \param ctx      ECDSA context that will hold the key
+ *
+ * \note           ecdsa_init() must be called beforehand to setup
+ *                 the curve and the RNG.
+ *
+ * \return         0 if successful, or an POLARSSL_ERR_ECDSA_XXX error code
+ */
+int ecdsa_gen_key( ecdsa_context *ctx );
+
+/**
+ * \brief          Check that the public key lies on the curve
+ *
+ * \param ctx      ECDSA context holding the key
+ *
+ * \return         0 if successful, or an POLARSSL_ERR_ECDSA_XXX error code
+ */
+int ecdsa_check_pubkey( ecdsa_context *ctx );
+
+/**
+ * \brief          Sign a message digest with the private key
+ *
+ * \param ctx      ECDSA context holding the key
+ * \param hash     buffer holding the message digest
+ * \param hashlen  message digest length, truncated to size(N)
+ * \param r        first half of the signature
+ * \param s        second half of the signature
+ *
+ * \return         0 if successful, or an POLARSSL_ERR_ECDSA_XXX error code
+ */
+int ecdsa_sign( ecdsa_context *ctx,
+                unsigned char *hash, int hashlen,
+                mpi *r, mpi *s );
+
+/**
+ * \brief          Export the public key as an uncompressed point
+ *                 (0x04 || X || Y)
+ *
+ * \param ctx      ECDSA context holding the key
+ * \param buf      output buffer
+ * \param buflen   size of buf, at least 2 * size(N) + 1
+ *
+ * \return         0 if successful, or an POLARSSL_ERR_ECDSA_XXX error code
+ */
+int ecdsa_write_pubkey( ecdsa_context *ctx,
+                        unsigned char *buf, int buflen );
+
+/**
+ * \brief          Free the components of an ECDSA key
+ */
+void ecdsa_free( ecdsa_context *ctx );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ecdsa.h */
@@ -36,6 +36,7 @@
 #define POLARSSL_X509_H
 
 #include "polarssl/rsa.h"
+#include "polarssl/ecdsa.h"
 
 #define POLARSSL_ERR_ASN1_OUT_OF_DATA                      -0x0014
 #define POLARSSL_ERR_ASN1_UNEXPECTED_TAG                   -0x0016
@@ -120,6 +121,9 @@
 #define OID_PKCS1_RSA_SHA       "\x2A\x86\x48\x86\xF7\x0D\x01\x01\x05"
 #define OID_PKCS9               "\x2A\x86\x48\x86\xF7\x0D\x01\x09"
 #define OID_PKCS9_EMAIL         "\x2A\x86\x48\x86\xF7\x0D\x01\x09\x01"
+#define OID_EC_PUBKEY           "\x2A\x86\x48\xCE\x3D\x02\x01"
+#define OID_EC_SECP256R1        "\x2A\x86\x48\xCE\x3D\x03\x01\x07"
+#define OID_ECDSA_SHA256        "\x2A\x86\x48\xCE\x3D\x04\x03\x02"
 
 /*
  * Structures for parsing X.509 certificates
@@ -358,6 +362,19 @@ int x509write_keyfile( rsa_context *rsa,
                        char *path,
                        int format );
 
+/*
+ * \brief          Write a private EC key (SEC1) into a file
+ *
+ * \param ec       points to an ECDSA key
+ * \param path     filename to write the key to
+ * \param format   X509_OUTPUT_DER or X509_OUTPUT_PEM
+ *
+ * \return         0 if successful, or a specific X509 error code
+ */
+int x509write_ec_keyfile( ecdsa_context *ec,
+                          char *path,
+                          int format );
+
 /**
  * \brief          Add a public key to certificate
  *
@@ -368,6 +385,16 @@ int x509write_keyfile( rsa_context *rsa,
  */
 int x509write_add_pubkey( x509_raw *chain, rsa_context *pubkey );
 
+/**
+ * \brief          Add an EC public key to certificate
+ *
+ * \param chain    points to the raw certificate data
+ * \param pubkey   points to an ECDSA key
+ *
+ * \return         0 if successful, or a specific X509 error code
+ */
+int x509write_add_ec_pubkey( x509_raw *chain, ecdsa_context *pubkey );
+
 /**
  * \brief          Create x509 subject/issuer field to raw certificate
  *                 from string or CA cert. Make string NULL if you will
@@ -501,6 +528,26 @@ int x509write_create_selfsign( x509_raw *crt, rsa_context *raw );
  */
 int x509write_create_sign( x509_raw *crt, rsa_context *raw );
 
+/**
+ * \brief          Create a self-signed certificate with an EC key
+ *
+ * \param chain    points to the raw certificate data
+ * \param ec       a private key to sign the certificate
+ *
+ * \return         0 if successful, or a specific X509 error code
+ */
+int x509write_create_ec_selfsign( x509_raw *crt, ecdsa_context *ec );
+
+/**
+ * \brief          Create a certificate signed with an EC key
+ *
+ * \param chain    points to the raw certificate data
+ * \param ec       a private key to sign the certificate
+ *
+ * \return         0 if successful, or a specific X509 error code
+ */
+int x509write_create_ec_sign( x509_raw *crt, ecdsa_context *ec );
+
 /**
  * \brief          Create a certificate signing request
  *
@@ -522,6 +569,16 @@ int x509write_create_csr( x509_raw *chain, rsa_context *privkey );
  */
 int x509write_serialize_key( rsa_context *rsa, x509_node *node );
 
+/**
+ * \brief           Serialize an EC key into DER (SEC1 ECPrivateKey)
+ *
+ * \param ec        an ECDSA key for output
+ * \param node      a x509 node for write into
+ *
+ * \return          0 if successful, or a specific X509 error code
+ */
+int x509write_serialize_ec_key( ecdsa_context *ec, x509_node *node );
+
 /**
  * \brief          Unallocate all raw certificate data
  */
@@ -27,6 +27,8 @@
 #include "polarssl/bignum.h"
 #include "polarssl/x509.h"
 #include "polarssl/rsa.h"
+#include "polarssl/ecdsa.h"
+#include "polarssl/timing.h"
 
 #define PX5G_VERSION "0.1"
 #define PX5G_COPY "Copyright (c) 2009 Steven Barth <steven@midlink.org>"
@@ -75,12 +77,59 @@ int rsakey(char **arg) {
 	return 0;
 }
 
+static int eccurve(const char *name) {
+	return !strcmp(name, "prime256v1") || !strcmp(name, "secp256r1") ||
+		!strcmp(name, "P-256");
+}
+
+int eckey(char **arg) {
+	havege_state hs;
+	ecdsa_context ec;
+
+	char *path = NULL;
+	int flag = X509_OUTPUT_PEM;
+
+	while (*arg && **arg == '-') {
+		if (!strcmp(*arg, "-out") && arg[1]) {
+			path = arg[1];
+			arg++;
+		} else if (!strcmp(*arg, "-der")) {
+			flag = X509_OUTPUT_DER;
+		}
+		arg++;
+	}
+
+	if (*arg && !eccurve(*arg)) {
+		fprintf(stderr, "error: unsupported curve %s\n", *arg);
+		return 1;
+	}
+
+	havege_init(&hs);
+	ecdsa_init(&ec, havege_rand, &hs);
+
+	fprintf(stderr, "Generating EC private key, prime256v1 curve\n");
+	if (ecdsa_gen_key(&ec)) {
+		fprintf(stderr, "error: key generation failed\n");
+		return 1;
+	}
+
+	if (x509write_ec_keyfile(&ec, path, flag)) {
+		fprintf(stderr, "error: I/O error\n");
+		return 1;
+	}
+
+	ecdsa_free(&ec);
+	return 0;
+}
+
 int selfsigned(char **arg) {
 	havege_state hs;
 	rsa_context rsa;
+	ecdsa_context ec;
 	x509_node node;
 
 	char *subject = "";
+	int use_ec = 0;
 	unsigned int ksize = 512;
 	int exp = 65537;
 	unsigned int days = 30;
@@ -93,11 +142,16 @@ int selfsigned(char **arg) {
 		if (!strcmp(*arg, "-der")) {
 			flag = X509_OUTPUT_DER;
 		} else if (!strcmp(*arg, "-newkey") && arg[1]) {
-			if (strncmp(arg[1], "rsa:", 4)) {
+			if (!strcmp(arg[1], "ec") ||
+			    (!strncmp(arg[1], "ec:", 3) && eccurve(arg[1] + 3))) {
+				use_ec = 1;
+			} else if (!strncmp(arg[1], "rsa:", 4)) {
+				use_ec = 0;
+				ksize = (unsigned int)atoi(arg[1] + 4);
+			} else {
 				fprintf(stderr, "error: invalid algorithm");
 				return 1;
 			}
-			ksize = (unsigned int)atoi(arg[1] + 4);
 			arg++;
 		} else if (!strcmp(*arg, "-days") && arg[1]) {
 			days = (unsigned int)atoi(arg[1]);
@@ -140,16 +194,26 @@ int selfsigned(char **arg) {
 	}
 
 	havege_init(&hs);
-	rsa_init(&rsa, RSA_PKCS_V15, 0, havege_rand, &hs);
 	x509write_init_node(&node);
-	fprintf(stderr, "Generating RSA private key, %i bit long modulus\n", ksize);
-	if (rsa_gen_key(&rsa, ksize, exp)) {
-		fprintf(stderr, "error: key generation failed\n");
-		return 1;
+	if (use_ec) {
+		ecdsa_init(&ec, havege_rand, &hs);
+		fprintf(stderr, "Generating EC private key, prime256v1 curve\n");
+		if (ecdsa_gen_key(&ec)) {
+			fprintf(stderr, "error: key generation failed\n");
+			return 1;
+		}
+	} else {
+		rsa_init(&rsa, RSA_PKCS_V15, 0, havege_rand, &hs);
+		fprintf(stderr, "Generating RSA private key, %i bit long modulus\n", ksize);
+		if (rsa_gen_key(&rsa, ksize, exp)) {
+			fprintf(stderr, "error: key generation failed\n");
+			return 1;
+		}
 	}
 
 	if (keypath) {
-		if (x509write_keyfile(&rsa, keypath, flag)) {
+		if (use_ec ? x509write_ec_keyfile(&ec, keypath, flag)
+		           : x509write_keyfile(&rsa, keypath, flag)) {
 			fprintf(stderr, "error: I/O error\n");
 			return 1;
 		}
@@ -164,12 +228,16 @@ int selfsigned(char **arg) {
 
 	x509_raw cert;
 	x509write_init_raw(&cert);
-	x509write_add_pubkey(&cert, &rsa);
+	if (use_ec)
+		x509write_add_ec_pubkey(&cert, &ec);
+	else
+		x509write_add_pubkey(&cert, &rsa);
 	x509write_add_subject(&cert, (unsigned char*)subject);
 	x509write_add_validity(&cert, (unsigned char*)fstr, (unsigned char*)tstr);
 	fprintf(stderr, "Generating selfsigned certificate with subject '%s'"
 			" and validity %s-%s\n", subject, fstr, tstr);
-	if (x509write_create_selfsign(&cert, &rsa)) {
+	if (use_ec ? x509write_create_ec_selfsign(&cert, &ec)
+	           : x509write_create_selfsign(&cert, &rsa)) {
 		fprintf(stderr, "error: certificate generation failed\n");
 	}
 
@@ -179,7 +247,99 @@ int selfsigned(char **arg) {
 	}
 
 	x509write_free_raw(&cert);
-	rsa_free(&rsa);
+	if (use_ec)
+		ecdsa_free(&ec);
+	else
+		rsa_free(&rsa);
+	return 0;
+}
+
+#define BENCH_MPI(label, bits, expr) do { \
+	unsigned long n = 0, ms; \
+	get_timer(&timer, 1); \
+	do { \
+		expr; \
+		n++; \
+	} while ((ms = get_timer(&timer, 0)) < 250); \
+	fprintf(stderr, "mpi %u %s: %lu ns/op\n", bits, label, \
+		(unsigned long)(ms * 1000000ULL / n)); \
+} while (0)
+
+static void bench_mpi(havege_state *hs, unsigned int bits) {
+	struct hr_time timer;
+	unsigned char buf[512];
+	unsigned int i, len = bits / 8;
+	mpi A, B, E, N, X, RR;
+
+	mpi_init(&A, &B, &E, &N, &X, &RR, NULL);
+	for (i = 0; i < len; i++)
+		buf[i] = havege_rand(hs);
+	mpi_read_binary(&A, buf, len);
+	mpi_read_binary(&E, buf, len);
+	for (i = 0; i < len; i++)
+		buf[i] = havege_rand(hs);
+	mpi_read_binary(&B, buf, len);
+	buf[0] |= 0x80;
+	buf[len - 1] |= 1;
+	mpi_read_binary(&N, buf, len);
+	mpi_mod_mpi(&A, &A, &N);
+
+	BENCH_MPI("mul", bits, mpi_mul_mpi(&X, &A, &B));
+	BENCH_MPI("sqr", bits, mpi_mul_mpi(&X, &A, &A));
+	BENCH_MPI("exp_mod", bits, mpi_exp_mod(&X, &A, &E, &N, &RR));
+
+	mpi_free(&RR, &X, &N, &E, &B, &A, NULL);
+}
+
+int bench(char **arg) {
+	havege_state hs;
+	rsa_context rsa;
+	ecdsa_context ec;
+	struct hr_time timer;
+	unsigned char hash[32];
+	unsigned int ksize = 2048;
+	mpi r, s;
+
+	if (*arg) {
+		ksize = (unsigned int)atoi(*arg);
+	}
+
+	get_timer(&timer, 1);
+	havege_init(&hs);
+	fprintf(stderr, "havege init: %lu ms\n", get_timer(&timer, 1));
+
+	ecdsa_init(&ec, havege_rand, &hs);
+	if (ecdsa_gen_key(&ec)) {
+		fprintf(stderr, "error: key generation failed\n");
+		return 1;
+	}
+	fprintf(stderr, "ec prime256v1 keygen: %lu ms\n", get_timer(&timer, 1));
+
+	memset(hash, 0x5a, sizeof(hash));
+	mpi_init(&r, &s, NULL);
+	if (ecdsa_sign(&ec, hash, sizeof(hash), &r, &s)) {
+		fprintf(stderr, "error: signing failed\n");
+		return 1;
+	}
+	fprintf(stderr, "ec prime256v1 sign: %lu ms\n", get_timer(&timer, 1));
+	mpi_free(&s, &r, NULL);
+	ecdsa_free(&ec);
+
+	bench_mpi(&hs, 1024);
+	bench_mpi(&hs, 2048);
+	get_timer(&timer, 1);
+
+	if (ksize) {
+		rsa_init(&rsa, RSA_PKCS_V15, 0, havege_rand, &hs);
+		if (rsa_gen_key(&rsa, ksize, 65537)) {
+			fprintf(stderr, "error: key generation failed\n");
+			return 1;
+		}
+		fprintf(stderr, "rsa %u keygen: %lu ms\n", ksize,
+			get_timer(&timer, 1));
+		rsa_free(&rsa);
+	}
+
 	return 0;
 }
 
@@ -188,13 +348,17 @@ int main(int argc, char *argv[]) {
 		//Usage
 	} else if (!strcmp(argv[1], "rsakey")) {
 		return rsakey(argv+2);
+	} else if (!strcmp(argv[1], "eckey")) {
+		return eckey(argv+2);
 	} else if (!strcmp(argv[1], "selfsigned")) {
 		return selfsigned(argv+2);
+	} else if (!strcmp(argv[1], "bench")) {
+		return bench(argv+2);
 	}
 
 	fprintf(stderr,
 		"PX5G X.509 Certificate Generator Utility v" PX5G_VERSION "\n" PX5G_COPY
 		"\nbased on PolarSSL by Christophe Devine and Paul Bakker\n\n");
-	fprintf(stderr, "Usage: %s [rsakey|selfsigned]\n", *argv);
+	fprintf(stderr, "Usage: %s [rsakey|eckey|selfsigned|bench]\n", *argv);
 	return 1;
 }
@@ -247,6 +247,8 @@ else
       STRIP:=$(STAGING_DIR_HOST)/bin/sstrip
     endif
   endif
+  # stripped files are cached in $(TMP_DIR)/rstrip-cache, rstrip removes
+  # entries that have not been used for two weeks
   RSTRIP:= \
     export CROSS="$(TARGET_CROSS)" \
 		$(if $(CONFIG_KERNEL_KALLSYMS),NO_RENAME=1) \
@@ -254,6 +256,7 @@ else
     NM="$(TARGET_CROSS)nm" \
     STRIP="$(STRIP)" \
     STRIP_KMOD="$(SCRIPT_DIR)/strip-kmod.sh" \
+    RSTRIP_CACHE="$(TMP_DIR)/rstrip-cache" \
     $(SCRIPT_DIR)/rstrip.sh
 endif
 
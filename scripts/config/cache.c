@@ -0,0 +1,891 @@
+/*
+ * Cache for the parsed configuration tree
+ *
+ * Parsing the full OpenWrt tree (tmp/.config-package.in and friends) is
+ * the dominating cost of every conf/mconf run. If KCONFIG_CACHE names a
+ * file, the menu/symbol/property/expression graph is stored there after a
+ * successful parse and loaded on the next run instead of parsing again,
+ * as long as the content of every input file, the result of every glob'd
+ * "source" statement and all environment values baked into the tree are
+ * unchanged.
+ *
+ * The cache is a private, host-local format; it is rebuilt whenever it is
+ * missing, stale or unreadable.
+ *
+ * Released under the terms of the GNU GPL v2.0.
+ */
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/utsname.h>
+
+#include "lkc.h"
+
+#define CACHE_MAGIC	0x4b434331	/* "KCC1" */
+#define CACHE_VERSION	1
+
+/*
+ * Objects are referenced by their index + 1 in the table of their type,
+ * 0 is NULL. Symbols and menus reserve a few references for the
+ * statically allocated objects.
+ */
+enum {
+	SYM_REF_NULL,
+	SYM_REF_YES,
+	SYM_REF_MOD,
+	SYM_REF_NO,
+	SYM_REF_EMPTY,
+	SYM_REF_FIRST,
+};
+
+enum {
+	MENU_REF_NULL,
+	MENU_REF_ROOT,
+	MENU_REF_FIRST,
+};
+
+enum {
+	CT_FILE,
+	CT_SYM,
+	CT_PROP,
+	CT_MENU,
+	CT_EXPR,
+	CT_MAX
+};
+
+struct cache_glob {
+	struct cache_glob *next;
+	char *pattern;
+	struct gstr paths;
+};
+
+static struct cache_glob *cache_globs;
+
+struct cache_buf {
+	char *data;
+	size_t len;
+	size_t size;
+};
+
+/* ordered list of objects of one type plus a pointer -> index map */
+struct cache_table {
+	const void **obj;
+	unsigned int n;
+	unsigned int done;
+	unsigned int size;
+	const void **hkey;
+	unsigned int *hval;
+	unsigned int hsize;
+	struct cache_buf buf;
+};
+
+struct cache_reader {
+	const char *p;
+	const char *end;
+	bool err;
+};
+
+static uint64_t cache_hash(uint64_t h, const void *data, size_t len)
+{
+	const unsigned char *p = data;
+
+	/* FNV-1a */
+	while (len--) {
+		h ^= *p++;
+		h *= 0x100000001b3ULL;
+	}
+	return h;
+}
+
+#define CACHE_HASH_INIT	0xcbf29ce484222325ULL
+
+static bool cache_hash_file(const char *name, uint64_t *hash, uint64_t *size)
+{
+	char buf[65536];
+	size_t len;
+	FILE *f;
+
+	f = zconf_fopen(name);
+	if (!f)
+		return false;
+
+	*hash = CACHE_HASH_INIT;
+	*size = 0;
+	while ((len = fread(buf, 1, sizeof(buf), f)) > 0) {
+		*hash = cache_hash(*hash, buf, len);
+		*size += len;
+	}
+	fclose(f);
+
+	return true;
+}
+
+/*
+ * Called by the lexer for every "source" statement, so the result of
+ * wildcard patterns can be revalidated when loading the cache.
+ */
+void zconf_cache_add_glob(const char *pattern, size_t pathc, char **pathv)
+{
+	struct cache_glob *g;
+	size_t i;
+
+	if (!getenv("KCONFIG_CACHE"))
+		return;
+
+	g = xcalloc(1, sizeof(*g));
+	g->pattern = strdup(pattern);
+	g->paths = str_new();
+	for (i = 0; i < pathc; i++) {
+		str_append(&g->paths, pathv[i]);
+		str_append(&g->paths, "\n");
+	}
+	g->next = cache_globs;
+	cache_globs = g;
+}
+
+static bool cache_glob_matches(const char *pattern, const char *paths)
+{
+	struct gstr cur = str_new();
+	bool ret;
+	glob_t gl;
+	int err, i;
+
+	err = glob(pattern, GLOB_ERR | GLOB_MARK, NULL, &gl);
+	if (err && err != GLOB_NOMATCH)
+		return false;
+
+	if (!err) {
+		for (i = 0; i < gl.gl_pathc; i++) {
+			str_append(&cur, gl.gl_pathv[i]);
+			str_append(&cur, "\n");
+		}
+		globfree(&gl);
+	}
+
+	ret = !strcmp(str_get(&cur), paths);
+	str_free(&cur);
+
+	return ret;
+}
+
+/*
+ * writer
+ */
+
+static void cache_put(struct cache_buf *b, const void *data, size_t len)
+{
+	if (b->len + len > b->size) {
+		b->size = (b->len + len) * 2 + 4096;
+		b->data = realloc(b->data, b->size);
+		if (!b->data) {
+			fprintf(stderr, "Out of memory.\n");
+			exit(1);
+		}
+	}
+	memcpy(b->data + b->len, data, len);
+	b->len += len;
+}
+
+static void cache_put_u32(struct cache_buf *b, uint32_t val)
+{
+	cache_put(b, &val, sizeof(val));
+}
+
+static void cache_put_u64(struct cache_buf *b, uint64_t val)
+{
+	cache_put(b, &val, sizeof(val));
+}
+
+/* strings are stored with their terminating NUL, length 0 means NULL */
+static void cache_put_str(struct cache_buf *b, const char *s)
+{
+	size_t len = s ? strlen(s) + 1 : 0;
+
+	cache_put_u32(b, len);
+	if (len)
+		cache_put(b, s, len);
+}
+
+static unsigned int cache_ptr_hash(const void *ptr, unsigned int size)
+{
+	uintptr_t v = (uintptr_t) ptr;
+
+	v ^= v >> 17;
+	v *= 0x9e3779b1;
+	return (v ^ (v >> 15)) & (size - 1);
+}
+
+static void cache_table_grow(struct cache_table *t)
+{
+	unsigned int i, h, hsize = t->hsize ? t->hsize * 2 : 1024;
+	const void **hkey = xcalloc(hsize, sizeof(*hkey));
+	unsigned int *hval = xcalloc(hsize, sizeof(*hval));
+
+	for (i = 0; i < t->hsize; i++) {
+		if (!t->hkey[i])
+			continue;
+
+		h = cache_ptr_hash(t->hkey[i], hsize);
+		while (hkey[h])
+			h = (h + 1) & (hsize - 1);
+
+		hkey[h] = t->hkey[i];
+		hval[h] = t->hval[i];
+	}
+
+	free(t->hkey);
+	free(t->hval);
+	t->hkey = hkey;
+	t->hval = hval;
+	t->hsize = hsize;
+}
+
+/* return the reference of an object, assigning the next one if unknown */
+static uint32_t cache_ref(struct cache_table *t, const void *ptr, uint32_t first)
+{
+	unsigned int h;
+
+	if (!ptr)
+		return 0;
+
+	if ((t->n + 1) * 2 > t->hsize)
+		cache_table_grow(t);
+
+	h = cache_ptr_hash(ptr, t->hsize);
+	while (t->hkey[h]) {
+		if (t->hkey[h] == ptr)
+			return t->hval[h] + first;
+		h = (h + 1) & (t->hsize - 1);
+	}
+
+	if (t->n == t->size) {
+		t->size = t->size ? t->size * 2 : 1024;
+		t->obj = realloc(t->obj, t->size * sizeof(*t->obj));
+		if (!t->obj) {
+			fprintf(stderr, "Out of memory.\n");
+			exit(1);
+		}
+	}
+
+	t->hkey[h] = ptr;
+	t->hval[h] = t->n;
+	t->obj[t->n] = ptr;
+
+	return t->n++ + first;
+}
+
+static struct cache_table cache_tables[CT_MAX];
+
+static uint32_t cache_file_ref(const struct file *file)
+{
+	return cache_ref(&cache_tables[CT_FILE], file, 1);
+}
+
+static uint32_t cache_sym_ref(const struct symbol *sym)
+{
+	if (sym == &symbol_yes)
+		return SYM_REF_YES;
+	if (sym == &symbol_mod)
+		return SYM_REF_MOD;
+	if (sym == &symbol_no)
+		return SYM_REF_NO;
+	if (sym == &symbol_empty)
+		return SYM_REF_EMPTY;
+
+	return cache_ref(&cache_tables[CT_SYM], sym, SYM_REF_FIRST);
+}
+
+static uint32_t cache_prop_ref(const struct property *prop)
+{
+	return cache_ref(&cache_tables[CT_PROP], prop, 1);
+}
+
+static uint32_t cache_menu_ref(const struct menu *menu)
+{
+	if (menu == &rootmenu)
+		return MENU_REF_ROOT;
+
+	return cache_ref(&cache_tables[CT_MENU], menu, MENU_REF_FIRST);
+}
+
+static uint32_t cache_expr_ref(const struct expr *e)
+{
+	return cache_ref(&cache_tables[CT_EXPR], e, 1);
+}
+
+static void cache_put_file(struct cache_buf *b, const struct file *file)
+{
+	cache_put_str(b, file->name);
+	cache_put_u32(b, cache_file_ref(file->next));
+	cache_put_u32(b, cache_file_ref(file->parent));
+	cache_put_u32(b, file->lineno);
+}
+
+static void cache_put_sym(struct cache_buf *b, const struct symbol *sym)
+{
+	cache_put_str(b, sym->name);
+	cache_put_u32(b, cache_sym_ref(sym->next));
+	cache_put_u32(b, sym->type);
+	cache_put_u32(b, sym->visible);
+	cache_put_u32(b, sym->flags & ~SYMBOL_VALID);
+	cache_put_u32(b, cache_prop_ref(sym->prop));
+	cache_put_u32(b, cache_expr_ref(sym->dir_dep.expr));
+	cache_put_u32(b, cache_expr_ref(sym->rev_dep.expr));
+}
+
+static void cache_put_prop(struct cache_buf *b, const struct property *prop)
+{
+	cache_put_str(b, prop->text);
+	cache_put_u32(b, cache_prop_ref(prop->next));
+	cache_put_u32(b, cache_sym_ref(prop->sym));
+	cache_put_u32(b, prop->type);
+	cache_put_u32(b, cache_expr_ref(prop->visible.expr));
+	cache_put_u32(b, cache_expr_ref(prop->expr));
+	cache_put_u32(b, cache_menu_ref(prop->menu));
+	cache_put_u32(b, cache_file_ref(prop->file));
+	cache_put_u32(b, prop->lineno);
+}
+
+static void cache_put_menu(struct cache_buf *b, const struct menu *menu)
+{
+	cache_put_str(b, menu->help);
+	cache_put_u32(b, cache_menu_ref(menu->next));
+	cache_put_u32(b, cache_menu_ref(menu->parent));
+	cache_put_u32(b, cache_menu_ref(menu->list));
+	cache_put_u32(b, cache_sym_ref(menu->sym));
+	cache_put_u32(b, cache_prop_ref(menu->prompt));
+	cache_put_u32(b, cache_expr_ref(menu->visibility));
+	cache_put_u32(b, cache_expr_ref(menu->dep));
+	cache_put_u32(b, menu->flags);
+	cache_put_u32(b, cache_file_ref(menu->file));
+	cache_put_u32(b, menu->lineno);
+}
+
+static void cache_put_expr(struct cache_buf *b, const struct expr *e)
+{
+	cache_put_u32(b, e->type);
+
+	switch (e->type) {
+	case E_SYMBOL:
+		cache_put_u32(b, cache_sym_ref(e->left.sym));
+		cache_put_u32(b, 0);
+		break;
+	case E_EQUAL:
+	case E_UNEQUAL:
+	case E_RANGE:
+		cache_put_u32(b, cache_sym_ref(e->left.sym));
+		cache_put_u32(b, cache_sym_ref(e->right.sym));
+		break;
+	case E_LIST:
+		cache_put_u32(b, cache_expr_ref(e->left.expr));
+		cache_put_u32(b, cache_sym_ref(e->right.sym));
+		break;
+	case E_NOT:
+		cache_put_u32(b, cache_expr_ref(e->left.expr));
+		cache_put_u32(b, 0);
+		break;
+	case E_OR:
+	case E_AND:
+		cache_put_u32(b, cache_expr_ref(e->left.expr));
+		cache_put_u32(b, cache_expr_ref(e->right.expr));
+		break;
+	default:
+		cache_put_u32(b, 0);
+		cache_put_u32(b, 0);
+		break;
+	}
+}
+
+static void cache_put_objects(void)
+{
+	struct cache_table *t;
+	bool progress;
+	int i;
+
+	do {
+		progress = false;
+		for (i = 0; i < CT_MAX; i++) {
+			t = &cache_tables[i];
+			while (t->done < t->n) {
+				const void *obj = t->obj[t->done++];
+
+				switch (i) {
+				case CT_FILE:
+					cache_put_file(&t->buf, obj);
+					break;
+				case CT_SYM:
+					cache_put_sym(&t->buf, obj);
+					break;
+				case CT_PROP:
+					cache_put_prop(&t->buf, obj);
+					break;
+				case CT_MENU:
+					cache_put_menu(&t->buf, obj);
+					break;
+				case CT_EXPR:
+					cache_put_expr(&t->buf, obj);
+					break;
+				}
+				progress = true;
+			}
+		}
+	} while (progress);
+}
+
+void conf_cache_save(const char *name)
+{
+	const char *cache_name = getenv("KCONFIG_CACHE");
+	struct cache_buf hdr = {}, root = {};
+	struct cache_glob *g;
+	struct symbol *sym;
+	struct file *file;
+	struct utsname uts;
+	struct expr *e;
+	char tmpname[PATH_MAX + 1];
+	uint64_t hash, size;
+	uint32_t n;
+	FILE *out;
+	int i;
+
+	if (!cache_name || !*cache_name)
+		return;
+
+	uname(&uts);
+
+	cache_put_u32(&hdr, CACHE_MAGIC);
+	cache_put_u32(&hdr, CACHE_VERSION);
+	cache_put_str(&hdr, name);
+	cache_put_str(&hdr, uts.release);
+
+	for (n = 0, e = sym_env_list; e; e = e->left.expr)
+		n++;
+	cache_put_u32(&hdr, n);
+	expr_list_for_each_sym(sym_env_list, e, sym) {
+		struct property *prop = sym_get_env_prop(sym);
+		const char *env = prop_get_symbol(prop)->name;
+
+		cache_put_str(&hdr, env);
+		cache_put_str(&hdr, getenv(env));
+	}
+
+	for (n = 0, g = cache_globs; g; g = g->next)
+		n++;
+	cache_put_u32(&hdr, n);
+	for (g = cache_globs; g; g = g->next) {
+		cache_put_str(&hdr, g->pattern);
+		cache_put_str(&hdr, str_get(&g->paths));
+	}
+
+	for (n = 0, file = file_list; file; file = file->next)
+		n++;
+	cache_put_u32(&hdr, n);
+	for (file = file_list; file; file = file->next) {
+		if (!cache_hash_file(file->name, &hash, &size))
+			return;
+
+		cache_put_str(&hdr, file->name);
+		cache_put_u64(&hdr, size);
+		cache_put_u64(&hdr, hash);
+	}
+
+	/* global roots of the graph */
+	cache_put_u32(&root, cache_file_ref(file_list));
+	cache_put_u32(&root, cache_sym_ref(modules_sym));
+	cache_put_u32(&root, cache_sym_ref(sym_defconfig_list));
+	cache_put_u32(&root, cache_expr_ref(sym_env_list));
+	cache_put_menu(&root, &rootmenu);
+
+	for (n = 0, i = 0; i < SYMBOL_HASHSIZE; i++)
+		if (symbol_hash[i])
+			n++;
+	cache_put_u32(&root, n);
+	for (i = 0; i < SYMBOL_HASHSIZE; i++) {
+		if (!symbol_hash[i])
+			continue;
+
+		cache_put_u32(&root, i);
+		cache_put_u32(&root, cache_sym_ref(symbol_hash[i]));
+	}
+
+	cache_put_objects();
+
+	for (i = 0; i < CT_MAX; i++)
+		cache_put_u32(&hdr, cache_tables[i].n);
+
+	snprintf(tmpname, sizeof(tmpname), "%s.%d", cache_name, (int) getpid());
+	out = fopen(tmpname, "w");
+	if (!out)
+		return;
+
+	xfwrite(hdr.data, hdr.len, 1, out);
+	xfwrite(root.data, root.len, 1, out);
+	for (i = 0; i < CT_MAX; i++)
+		if (cache_tables[i].buf.len)
+			xfwrite(cache_tables[i].buf.data, cache_tables[i].buf.len, 1, out);
+
+	if (fclose(out) || rename(tmpname, cache_name))
+		unlink(tmpname);
+}
+
+/*
+ * reader
+ */
+
+static uint32_t cache_get_u32(struct cache_reader *r)
+{
+	uint32_t val;
+
+	if (r->end - r->p < sizeof(val)) {
+		r->err = true;
+		return 0;
+	}
+	memcpy(&val, r->p, sizeof(val));
+	r->p += sizeof(val);
+
+	return val;
+}
+
+static uint64_t cache_get_u64(struct cache_reader *r)
+{
+	uint64_t val;
+
+	if (r->end - r->p < sizeof(val)) {
+		r->err = true;
+		return 0;
+	}
+	memcpy(&val, r->p, sizeof(val));
+	r->p += sizeof(val);
+
+	return val;
+}
+
+/* strings are returned in place, the buffer is never released */
+static const char *cache_get_str(struct cache_reader *r)
+{
+	uint32_t len = cache_get_u32(r);
+	const char *s = r->p;
+
+	if (!len)
+		return NULL;
+
+	if (r->end - r->p < len || s[len - 1]) {
+		r->err = true;
+		return NULL;
+	}
+	r->p += len;
+
+	return s;
+}
+
+static bool cache_str_eq(const char *a, const char *b)
+{
+	if (!a || !b)
+		return a == b;
+
+	return !strcmp(a, b);
+}
+
+static struct file *cache_files;
+static struct symbol *cache_syms;
+static struct property *cache_props;
+static struct menu *cache_menus;
+static struct expr *cache_exprs;
+static uint32_t cache_count[CT_MAX];
+
+static void *cache_obj(struct cache_reader *r, uint32_t ref, uint32_t first,
+		       int type, void *base, size_t size)
+{
+	if (ref < first)
+		return NULL;
+
+	ref -= first;
+	if (ref >= cache_count[type]) {
+		r->err = true;
+		return NULL;
+	}
+
+	return (char *) base + ref * size;
+}
+
+static struct file *cache_get_file(struct cache_reader *r)
+{
+	return cache_obj(r, cache_get_u32(r), 1, CT_FILE,
+			 cache_files, sizeof(*cache_files));
+}
+
+static struct symbol *cache_get_sym(struct cache_reader *r)
+{
+	uint32_t ref = cache_get_u32(r);
+
+	switch (ref) {
+	case SYM_REF_YES:
+		return &symbol_yes;
+	case SYM_REF_MOD:
+		return &symbol_mod;
+	case SYM_REF_NO:
+		return &symbol_no;
+	case SYM_REF_EMPTY:
+		return &symbol_empty;
+	}
+
+	return cache_obj(r, ref, SYM_REF_FIRST, CT_SYM,
+			 cache_syms, sizeof(*cache_syms));
+}
+
+static struct property *cache_get_prop(struct cache_reader *r)
+{
+	return cache_obj(r, cache_get_u32(r), 1, CT_PROP,
+			 cache_props, sizeof(*cache_props));
+}
+
+static struct menu *cache_get_menu(struct cache_reader *r)
+{
+	uint32_t ref = cache_get_u32(r);
+
+	if (ref == MENU_REF_ROOT)
+		return &rootmenu;
+
+	return cache_obj(r, ref, MENU_REF_FIRST, CT_MENU,
+			 cache_menus, sizeof(*cache_menus));
+}
+
+static struct expr *cache_get_expr(struct cache_reader *r)
+{
+	return cache_obj(r, cache_get_u32(r), 1, CT_EXPR,
+			 cache_exprs, sizeof(*cache_exprs));
+}
+
+static void cache_get_menu_data(struct cache_reader *r, struct menu *menu)
+{
+	menu->help = (char *) cache_get_str(r);
+	menu->next = cache_get_menu(r);
+	menu->parent = cache_get_menu(r);
+	menu->list = cache_get_menu(r);
+	menu->sym = cache_get_sym(r);
+	menu->prompt = cache_get_prop(r);
+	menu->visibility = cache_get_expr(r);
+	menu->dep = cache_get_expr(r);
+	menu->flags = cache_get_u32(r);
+	menu->file = cache_get_file(r);
+	menu->lineno = cache_get_u32(r);
+}
+
+static bool cache_check_inputs(struct cache_reader *r, const char *name)
+{
+	struct utsname uts;
+	uint64_t hash, size;
+	uint32_t i, n;
+
+	if (cache_get_u32(r) != CACHE_MAGIC ||
+	    cache_get_u32(r) != CACHE_VERSION)
+		return false;
+
+	uname(&uts);
+	if (!cache_str_eq(cache_get_str(r), name) ||
+	    !cache_str_eq(cache_get_str(r), uts.release))
+		return false;
+
+	n = cache_get_u32(r);
+	for (i = 0; i < n && !r->err; i++) {
+		const char *env = cache_get_str(r);
+		const char *val = cache_get_str(r);
+
+		if (!env || !cache_str_eq(getenv(env), val))
+			return false;
+	}
+
+	n = cache_get_u32(r);
+	for (i = 0; i < n && !r->err; i++) {
+		const char *pattern = cache_get_str(r);
+		const char *paths = cache_get_str(r);
+
+		if (!pattern || !paths || !cache_glob_matches(pattern, paths))
+			return false;
+	}
+
+	n = cache_get_u32(r);
+	for (i = 0; i < n && !r->err; i++) {
+		const char *file = cache_get_str(r);
+		uint64_t c_size = cache_get_u64(r);
+		uint64_t c_hash = cache_get_u64(r);
+
+		if (!file || !cache_hash_file(file, &hash, &size) ||
+		    size != c_size || hash != c_hash)
+			return false;
+	}
+
+	return !r->err;
+}
+
+bool conf_cache_load(const char *name)
+{
+	const char *cache_name = getenv("KCONFIG_CACHE");
+	struct cache_reader r;
+	struct symbol *hash[SYMBOL_HASHSIZE] = {};
+	struct file *files;
+	struct symbol *msym, *dsym;
+	struct expr *env_list;
+	struct menu root = {};
+	char *data;
+	long len;
+	uint32_t i, n;
+	FILE *f;
+
+	if (!cache_name || !*cache_name)
+		return false;
+
+	f = fopen(cache_name, "r");
+	if (!f)
+		return false;
+
+	if (fseek(f, 0, SEEK_END) || (len = ftell(f)) <= 0 ||
+	    fseek(f, 0, SEEK_SET)) {
+		fclose(f);
+		return false;
+	}
+
+	data = xmalloc(len);
+	if (fread(data, 1, len, f) != len) {
+		fclose(f);
+		free(data);
+		return false;
+	}
+	fclose(f);
+
+	r.p = data;
+	r.end = data + len;
+	r.err = false;
+
+	if (!cache_check_inputs(&r, name))
+		goto error;
+
+	for (i = 0; i < CT_MAX; i++)
+		cache_count[i] = cache_get_u32(&r);
+	if (r.err)
+		goto error;
+
+	cache_files = xcalloc(cache_count[CT_FILE] + 1, sizeof(*cache_files));
+	cache_syms = xcalloc(cache_count[CT_SYM] + 1, sizeof(*cache_syms));
+	cache_props = xcalloc(cache_count[CT_PROP] + 1, sizeof(*cache_props));
+	cache_menus = xcalloc(cache_count[CT_MENU] + 1, sizeof(*cache_menus));
+	cache_exprs = xcalloc(cache_count[CT_EXPR] + 1, sizeof(*cache_exprs));
+
+	files = cache_get_file(&r);
+	msym = cache_get_sym(&r);
+	dsym = cache_get_sym(&r);
+	env_list = cache_get_expr(&r);
+	cache_get_menu_data(&r, &root);
+
+	n = cache_get_u32(&r);
+	for (i = 0; i < n && !r.err; i++) {
+		uint32_t bucket = cache_get_u32(&r);
+
+		if (bucket >= SYMBOL_HASHSIZE)
+			goto error;
+		hash[bucket] = cache_get_sym(&r);
+	}
+
+	for (i = 0; i < cache_count[CT_FILE] && !r.err; i++) {
+		struct file *file = &cache_files[i];
+
+		file->name = cache_get_str(&r);
+		file->next = cache_get_file(&r);
+		file->parent = cache_get_file(&r);
+		file->lineno = cache_get_u32(&r);
+	}
+
+	for (i = 0; i < cache_count[CT_SYM] && !r.err; i++) {
+		struct symbol *sym = &cache_syms[i];
+
+		sym->name = (char *) cache_get_str(&r);
+		sym->next = cache_get_sym(&r);
+		sym->type = cache_get_u32(&r);
+		sym->visible = cache_get_u32(&r);
+		sym->flags = cache_get_u32(&r);
+		sym->prop = cache_get_prop(&r);
+		sym->dir_dep.expr = cache_get_expr(&r);
+		sym->rev_dep.expr = cache_get_expr(&r);
+	}
+
+	for (i = 0; i < cache_count[CT_PROP] && !r.err; i++) {
+		struct property *prop = &cache_props[i];
+
+		prop->text = cache_get_str(&r);
+		prop->next = cache_get_prop(&r);
+		prop->sym = cache_get_sym(&r);
+		prop->type = cache_get_u32(&r);
+		prop->visible.expr = cache_get_expr(&r);
+		prop->expr = cache_get_expr(&r);
+		prop->menu = cache_get_menu(&r);
+		prop->file = cache_get_file(&r);
+		prop->lineno = cache_get_u32(&r);
+	}
+
+	for (i = 0; i < cache_count[CT_MENU] && !r.err; i++)
+		cache_get_menu_data(&r, &cache_menus[i]);
+
+	for (i = 0; i < cache_count[CT_EXPR] && !r.err; i++) {
+		struct expr *e = &cache_exprs[i];
+
+		e->type = cache_get_u32(&r);
+		switch (e->type) {
+		case E_SYMBOL:
+			e->left.sym = cache_get_sym(&r);
+			cache_get_u32(&r);
+			break;
+		case E_EQUAL:
+		case E_UNEQUAL:
+		case E_RANGE:
+			e->left.sym = cache_get_sym(&r);
+			e->right.sym = cache_get_sym(&r);
+			break;
+		case E_LIST:
+			e->left.expr = cache_get_expr(&r);
+			e->right.sym = cache_get_sym(&r);
+			break;
+		case E_NOT:
+			e->left.expr = cache_get_expr(&r);
+			cache_get_u32(&r);
+			break;
+		case E_OR:
+		case E_AND:
+			e->left.expr = cache_get_expr(&r);
+			e->right.expr = cache_get_expr(&r);
+			break;
+		default:
+			cache_get_u32(&r);
+			cache_get_u32(&r);
+			break;
+		}
+	}
+
+	if (r.err || r.p != r.end)
+		goto error;
+
+	memcpy(symbol_hash, hash, sizeof(hash));
+	rootmenu = root;
+	file_list = files;
+	modules_sym = msym;
+	sym_defconfig_list = dsym;
+	sym_env_list = env_list;
+
+	return true;
+
+error:
+	free(cache_files);
+	free(cache_syms);
+	free(cache_props);
+	free(cache_menus);
+	free(cache_exprs);
+	cache_files = NULL;
+	cache_syms = NULL;
+	cache_props = NULL;
+	cache_menus = NULL;
+	cache_exprs = NULL;
+	free(data);
+
+	return false;
+}
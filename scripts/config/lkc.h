@@ -119,6 +119,11 @@ void menu_add_option(int token, char *arg);
 void menu_finalize(struct menu *parent);
 void menu_set_type(int type);
 
+/* cache.c */
+void zconf_cache_add_glob(const char *pattern, size_t pathc, char **pathv);
+bool conf_cache_load(const char *name);
+void conf_cache_save(const char *name);
+
 /* util.c */
 struct file *file_lookup(const char *name);
 int file_write_dep(const char *name);
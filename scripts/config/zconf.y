@@ -499,6 +499,11 @@ void conf_parse(const char *name)
 	struct symbol *sym;
 	int i;
 
+	if (conf_cache_load(name)) {
+		sym_set_change_count(1);
+		return;
+	}
+
 	zconf_initscan(name);
 
 	sym_init();
@@ -532,6 +537,7 @@ void conf_parse(const char *name)
         }
 	if (zconfnerrs)
 		exit(1);
+	conf_cache_save(name);
 	sym_set_change_count(1);
 }
 
@@ -750,3 +756,4 @@ void zconfdump(FILE *out)
 #include "expr.c"
 #include "symbol.c"
 #include "menu.c"
+#include "cache.c"
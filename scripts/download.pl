@@ -10,6 +10,8 @@ use strict;
 use warnings;
 use File::Basename;
 use File::Copy;
+use Digest::MD5;
+use POSIX ":sys_wait_h";
 
 @ARGV > 2 or die "Syntax: $0 <target dir> <filename> <md5sum> [<mirror> ...]\n";
 
@@ -17,7 +19,9 @@ my $target = shift @ARGV;
 my $filename = shift @ARGV;
 my $md5sum = shift @ARGV;
 my $scriptdir = dirname($0);
+my $parallel = $ENV{DOWNLOAD_PARALLEL} || 3;
 my @mirrors;
+my $store;
 my $ok;
 
 sub localmirrors {
@@ -36,6 +40,7 @@ sub localmirrors {
 				my @local_mirrors = split(/;/, $1);
 				push @mlist, @local_mirrors;
 			};
+			/^CONFIG_DOWNLOAD_STORE="(.+)"/ and $store = $1;
 		}
 		close CONFIG;
 	};
@@ -43,43 +48,106 @@ sub localmirrors {
 	return @mlist;
 }
 
-sub which($) {
-	my $prog = shift;
-	my $res = `which $prog`;
-	$res or return undef;
-	$res =~ /^no / and return undef;
-	$res =~ /not found/ and return undef;
-	return $res;
+sub md5file($) {
+	my $file = shift;
+	my $ctx = Digest::MD5->new;
+
+	open my $fh, "<", $file or return "";
+	binmode $fh;
+	$ctx->addfile($fh);
+	close $fh;
+
+	return $ctx->hexdigest;
+}
+
+# Returns true if the file matches the requested md5sum, or if there is
+# no md5sum to check against
+sub verify($) {
+	my $file = shift;
+
+	$md5sum =~ /\w{32}/ or return 1;
+
+	my $sum = md5file($file);
+	$sum eq $md5sum and return 1;
+
+	print STDERR "MD5 sum of the downloaded file does not match (file: $sum, requested: $md5sum) - deleting download.\n";
+	return 0;
+}
+
+# Partial downloads can only be continued, possibly from another mirror,
+# if the result is checked against an md5sum afterwards
+sub resumable() {
+	return $md5sum =~ /\w{32}/;
+}
+
+sub finish($) {
+	my $file = shift;
+
+	unlink "$target/$filename";
+	rename($file, "$target/$filename") or
+		system("mv", $file, "$target/$filename");
+	cleanup();
 }
 
-my $md5cmd = which("md5sum") || which("md5") || die 'no md5 checksum program found, please install md5 or md5sum';
-chomp $md5cmd;
+# The content store keeps every verified download as <store>/xx/<md5sum>,
+# so that it can be found again without searching for the file name.
+sub store_path() {
+	$store and $md5sum =~ /^(\w\w)\w{30}$/ or return undef;
+	return "$store/$1/$md5sum";
+}
+
+sub store_fetch() {
+	my $path = store_path() or return 0;
+	-f $path or return 0;
+
+	if (md5file($path) ne $md5sum) {
+		print STDERR "Removing corrupted $path from the content store.\n";
+		unlink $path;
+		return 0;
+	}
+
+	print("Copying $filename from the content store\n");
+	copy($path, "$target/$filename.copy") or return 0;
+	finish("$target/$filename.copy");
+	return 1;
+}
+
+sub store_add() {
+	my $path = store_path() or return;
+	-f $path and return;
+
+	system("mkdir", "-p", dirname($path));
+	link("$target/$filename", "$path.$$") or
+		copy("$target/$filename", "$path.$$") or return;
+	rename("$path.$$", $path) or unlink "$path.$$";
+}
 
-sub download
+sub download_local
 {
 	my $mirror = shift;
-	my $options = $ENV{WGET_OPTIONS} || "";
 
 	$mirror =~ s!/$!!;
+	$mirror =~ s!^file://!!;
 
-	if ($mirror =~ s!^file://!!) {
-		if (! -d "$mirror") {
-			print STDERR "Wrong local cache directory -$mirror-.\n";
-			cleanup();
-			return;
-		}
+	if (! -d "$mirror") {
+		print STDERR "Wrong local cache directory -$mirror-.\n";
+		return;
+	}
 
-		if (! -d "$target") {
-			system("mkdir", "-p", "$target/");
-		}
+	my $link;
 
+	# look up the file by name and by md5sum (content store layout)
+	# before searching the whole mirror
+	if (-f "$mirror/$filename") {
+		$link = "$mirror/$filename";
+	} elsif ($md5sum =~ /^(\w\w)\w{30}$/ and -f "$mirror/$1/$md5sum") {
+		$link = "$mirror/$1/$md5sum";
+	} else {
 		if (! open TMPDLS, "find $mirror -follow -name $filename 2>/dev/null |") {
 			print("Failed to search for $filename in $mirror\n");
 			return;
 		}
 
-		my $link;
-
 		while (defined(my $line = readline TMPDLS)) {
 			chomp ($link = $line);
 			if ($. > 1) {
@@ -89,58 +157,125 @@ sub download
 		}
 
 		close TMPDLS;
+	}
 
-		if (! $link) {
-			print("No instances of $filename found in $mirror.\n");
-			return;
-		}
+	if (! $link) {
+		print("No instances of $filename found in $mirror.\n");
+		return;
+	}
 
-		print("Copying $filename from $link\n");
-		copy($link, "$target/$filename.dl");
+	print("Copying $filename from $link\n");
+	copy($link, "$target/$filename.copy");
 
-		if (system("$md5cmd '$target/$filename.dl' > '$target/$filename.md5sum'")) {
-			print("Failed to generate md5 sum for $filename\n");
-			return;
-		}
-	} else {
-		open WGET, "wget -t5 --timeout=20 --no-check-certificate $options -O- '$mirror/$filename' |" or die "Cannot launch wget.\n";
-		open MD5SUM, "| $md5cmd > '$target/$filename.md5sum'" or die "Cannot launch md5sum.\n";
-		open OUTPUT, "> $target/$filename.dl" or die "Cannot create file $target/$filename.dl: $!\n";
-		my $buffer;
-		while (read WGET, $buffer, 1048576) {
-			print MD5SUM $buffer;
-			print OUTPUT $buffer;
-		}
-		close MD5SUM;
-		close WGET;
-		close OUTPUT;
+	if (!verify("$target/$filename.copy")) {
+		unlink "$target/$filename.copy";
+		return;
+	}
 
-		if ($? >> 8) {
-			print STDERR "Download failed.\n";
-			cleanup();
-			return;
-		}
+	finish("$target/$filename.copy");
+}
+
+# Runs in a child process: download one mirror into $file, continuing a
+# partial download if there is one and it is resumable.
+sub fetch_remote($$)
+{
+	my ($url, $file) = @_;
+	my $options = $ENV{WGET_OPTIONS} || "";
+	my $wget = "wget -nv -t5 --timeout=20 --no-check-certificate $options";
+
+	if (-s $file and resumable()) {
+		system("$wget -c -O '$file' '$url'") == 0 and verify($file) and return 0;
+		print STDERR "Could not continue the partial download from $url, restarting.\n";
 	}
 
-	my $sum = `cat "$target/$filename.md5sum"`;
-	$sum =~ /^(\w+)\s*/ or die "Could not generate md5sum\n";
-	$sum = $1;
+	unlink $file;
+	system("$wget -O '$file' '$url'") == 0 or do {
+		print STDERR "Download from $url failed.\n";
+		return 1;
+	};
 
-	if (($md5sum =~ /\w{32}/) and ($sum ne $md5sum)) {
-		print STDERR "MD5 sum of the downloaded file does not match (file: $sum, requested: $md5sum) - deleting download.\n";
-		cleanup();
-		return;
+	verify($file) and return 0;
+
+	unlink $file;
+	return 1;
+}
+
+my %jobs;
+my @partial;
+my @files;
+
+sub stop_jobs()
+{
+	foreach my $pid (keys %jobs) {
+		kill 'TERM', -$pid;
+		waitpid($pid, 0);
+		push @partial, $jobs{$pid}->[1] if -s $jobs{$pid}->[1];
+		delete $jobs{$pid};
 	}
+}
 
-	unlink "$target/$filename";
-	system("mv", "$target/$filename.dl", "$target/$filename");
-	cleanup();
+# Race up to $parallel mirrors against each other, the first verified
+# download wins.  Failed and aborted downloads leave their data behind
+# to be continued by the next mirror, if the result can be verified.
+sub download_remote
+{
+	my $n = 0;
+
+	while (!$ok and (@_ or %jobs)) {
+		while (@_ and keys %jobs < $parallel) {
+			my $url = shift;
+			my $file = "$target/$filename.dl.$n";
+
+			$url =~ s!/$!!;
+			$url .= "/$filename";
+			push @files, $file;
+			$n++;
+
+			@partial = sort { -s $a <=> -s $b } grep { -s $_ } @partial;
+			if (@partial and resumable()) {
+				rename(pop @partial, $file);
+			}
+
+			print("Downloading $url\n");
+
+			my $pid = fork();
+			defined $pid or die "Cannot fork: $!\n";
+			if (!$pid) {
+				$SIG{INT} = $SIG{TERM} = 'DEFAULT';
+				setpgrp(0, 0);
+				POSIX::_exit(fetch_remote($url, $file));
+			}
+			POSIX::setpgid($pid, $pid);
+			$jobs{$pid} = [ $url, $file ];
+		}
+
+		my $pid = waitpid(-1, 0);
+		$pid > 0 or last;
+		my $job = delete $jobs{$pid} or next;
+
+		if ($? == 0 and -f $job->[1]) {
+			stop_jobs();
+			finish($job->[1]);
+			$ok = 1;
+		} else {
+			push @partial, $job->[1] if -s $job->[1];
+		}
+	}
 }
 
 sub cleanup
 {
-	unlink "$target/$filename.dl";
-	unlink "$target/$filename.md5sum";
+	stop_jobs();
+
+	# keep the largest partial download so it can be continued later
+	my @left = sort { -s $a <=> -s $b } grep { -s $_ } @partial;
+	if (@left && resumable() && !-f "$target/$filename") {
+		rename(pop @left, "$target/$filename.dl");
+	} else {
+		unlink "$target/$filename.dl";
+	}
+	unlink @left, @files;
+	@partial = @files = ();
 }
 
 @mirrors = localmirrors();
@@ -191,13 +326,37 @@ foreach my $mirror (@ARGV) {
 push @mirrors, 'http://mirror2.openwrt.org/sources';
 push @mirrors, 'http://downloads.openwrt.org/sources';
 
+$SIG{INT} = $SIG{TERM} = sub { cleanup(); exit 1; };
+
+system("mkdir", "-p", "$target/") unless -d $target;
+
+# continue an interrupted download
+if (-s "$target/$filename.dl" and resumable()) {
+	rename("$target/$filename.dl", "$target/$filename.dl.part");
+	push @partial, "$target/$filename.dl.part";
+} else {
+	unlink "$target/$filename.dl";
+}
+
+$ok = store_fetch();
+
 while (!$ok) {
 	my $mirror = shift @mirrors;
-	$mirror or die "No more mirrors to try - giving up.\n";
+	$mirror or do {
+		cleanup();
+		die "No more mirrors to try - giving up.\n";
+	};
+
+	if ($mirror =~ m!^file://!) {
+		download_local($mirror);
+	} else {
+		my @remote = ($mirror);
+		push @remote, shift @mirrors while @mirrors and $mirrors[0] !~ m!^file://!;
+		download_remote(@remote);
+	}
 
-	download($mirror);
 	-f "$target/$filename" and $ok = 1;
 }
 
-$SIG{INT} = \&cleanup;
+store_add();
 
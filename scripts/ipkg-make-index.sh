@@ -8,6 +8,15 @@ if [ -z $pkg_dir ] || [ ! -d $pkg_dir ]; then
 	exit 1
 fi
 
+# Use the native indexer from tools/pkg-index if it has been built. With
+# PKG_INDEX_STAMPS pointing to a file outside of the package directory, it
+# reuses unchanged entries of the previous index in the same directory
+if which pkg-index >/dev/null 2>&1; then
+	[ -n "$PKG_INDEX_STAMPS" ] && \
+		exec pkg-index -p "$pkg_dir/Packages" -s "$PKG_INDEX_STAMPS" "$pkg_dir"
+	exec pkg-index "$pkg_dir"
+fi
+
 which md5sum >/dev/null 2>&1 || alias md5sum=md5
 
 for pkg in `find $pkg_dir -name '*.ipk' | sort`; do
@@ -20,6 +20,11 @@ TARGETS=$*
   exit 1
 }
 
+# Use the native implementation from tools/rstrip if it has been built
+if which rstrip >/dev/null 2>&1; then
+  exec rstrip $TARGETS
+fi
+
 find $TARGETS -type f -a -exec file {} \; | \
   sed -n -e 's/^\(.*\):.*ELF.*\(executable\|relocatable\|shared object\).*,.* stripped/\1:\2/p' | \
 (
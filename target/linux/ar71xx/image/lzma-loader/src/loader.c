@@ -33,6 +33,7 @@
 #define KSEG0			0x80000000
 #define KSEG1			0xa0000000
 
+#define KSEG0ADDR(a)		((((unsigned)(a)) & 0x1fffffffU) | KSEG0)
 #define KSEG1ADDR(a)		((((unsigned)(a)) & 0x1fffffffU) | KSEG1)
 
 #undef LZMA_DEBUG
@@ -205,7 +206,14 @@ static void lzma_init_data(void)
 	kernel_size = get_be32(&hdr->ih_size);
 	kernel_la = get_be32(&hdr->ih_load);
 
-	lzma_data = flash_base + flash_ofs + kernel_ofs;
+	/*
+	 * Decode through the cached window of the flash, so the data is
+	 * fetched a cache line at a time instead of with a bus cycle per
+	 * byte. The flash is only read here, so the lines never become dirty
+	 * and can be left in the cache when the kernel is started.
+	 */
+	lzma_data = (unsigned char *) KSEG0ADDR(flash_base + flash_ofs +
+						kernel_ofs);
 	lzma_datasize = kernel_size;
 }
 #endif /* (LZMA_WRAPPER) */
@@ -93,32 +93,60 @@ struct trx_header {
 /* beyound the image end, size not known in advance */
 extern unsigned char workspace[];
 
-unsigned int offset;
 unsigned char *data;
+unsigned char *data_end;
+
+/* flash access should be aligned, so the stream is copied out of the
+ * flash in blocks with 32-bit reads and handed to the decoder from RAM,
+ * never reading past the end of the compressed stream */
+#define READ_BLOCK_SIZE	4096
+
+static unsigned int block[READ_BLOCK_SIZE / 4];
+static unsigned char *block_ptr;
+static unsigned int block_left;
+
+static void read_block(void)
+{
+	unsigned int *src = (unsigned int *)data;
+	unsigned int len = data_end - data;
+	unsigned int i;
+
+	if (len > READ_BLOCK_SIZE)
+		len = READ_BLOCK_SIZE;
+
+	/* an unaligned tail is copied with its whole aligned word, the
+	 * bytes past the end of the stream are not handed to the decoder */
+	for (i = 0; i < (len + 3) / 4; i++)
+		block[i] = src[i];
+
+	data += len;
+	block_ptr = (unsigned char *)block;
+	block_left = len;
+}
 
-/* flash access should be aligned, so wrapper is used */
-/* read byte from the flash, all accesses are 32-bit aligned */
 static int read_byte(void *object, unsigned char **buffer, UInt32 *bufferSize)
 {
-	static unsigned int val;
+	if (block_left == 0)
+		read_block();
+
+	/* zero size at the end of the stream makes the decoder fail */
+	*bufferSize = block_left;
+	*buffer = block_ptr;
+	block_left = 0;
 
-	if (((unsigned int)offset % 4) == 0) {
-		val = *(unsigned int *)data;
-		data += 4;
-	}
-	
-	*bufferSize = 1;
-	*buffer = ((unsigned char *)&val) + (offset++ & 3);
-	
 	return LZMA_RESULT_OK;
 }
 
 static __inline__ unsigned char get_byte(void)
 {
-	unsigned char *buffer;
-	UInt32 fake;
-	
-	return read_byte(0, &buffer, &fake), *buffer;
+	if (block_left == 0)
+		read_block();
+
+	if (block_left == 0)
+		return 0;
+
+	block_left--;
+	return *block_ptr++;
 }
 
 /* should be the first function */
@@ -132,6 +160,8 @@ void entry(unsigned long icache_size, unsigned long icache_lsize,
 	unsigned int lp; /* literal pos state bits */
 	unsigned int pb; /* pos state bits */
 	unsigned int osize; /* uncompressed size */
+	unsigned int part; /* trx partition of the kernel */
+	struct trx_header *trx;
 
 	ILzmaInCallback callback;
 	callback.Read = read_byte;
@@ -144,13 +174,14 @@ void entry(unsigned long icache_size, unsigned long icache_lsize,
 
 	if (((struct trx_header *)data)->magic == EDIMAX_PS_HEADER_MAGIC)
 		data += EDIMAX_PS_HEADER_LEN;
-	/* compressed kernel is in the partition 0 or 1 */
-	if (((struct trx_header *)data)->offsets[1] > 65536) 
-		data += ((struct trx_header *)data)->offsets[0];
-	else
-		data += ((struct trx_header *)data)->offsets[1];
-
-	offset = 0;
+	trx = (struct trx_header *)data;
+	/* compressed kernel is in the partition 0 or 1, it ends at the
+	 * start of the next partition or at the end of the image */
+	part = (trx->offsets[1] > 65536) ? 0 : 1;
+	data_end = data + ((trx->offsets[part + 1]) ? trx->offsets[part + 1] : trx->len);
+	data += trx->offsets[part];
+
+	block_left = 0;
 
 	/* lzma args */
 	i = get_byte();
@@ -16,12 +16,174 @@
 #include <linux/init.h>
 #include <linux/kernel.h>
 #include <linux/magic.h>
+#include <linux/slab.h>
+#include <linux/vmalloc.h>
+#include <linux/mutex.h>
+#include <linux/ktime.h>
+#include <linux/workqueue.h>
 #include <linux/mtd/mtd.h>
 #include <linux/mtd/partitions.h>
 #include <linux/byteorder/generic.h>
 
 #include "mtdsplit.h"
 
+/*
+ * The split parsers look at a few small headers at the start of every
+ * eraseblock, and several parsers usually inspect the same blocks. On
+ * SPI flash each of these reads is a separate command transaction, so
+ * the first MTDSPLIT_CACHE_WINDOW bytes of every eraseblock read by a
+ * parser are kept for the parsers run after it. The cache belongs to
+ * the master device, so a rootfs parser running on a partition sees the
+ * blocks the firmware parser already read. It is dropped (and the read
+ * statistics are printed) once no parser used it for a while.
+ */
+#define MTDSPLIT_CACHE_WINDOW	256
+#define MTDSPLIT_CACHE_TIMEOUT	(2 * HZ)
+
+struct mtdsplit_cache {
+	struct mtd_info *master;
+	unsigned int nr_blocks;
+	u8 **blocks;
+
+	unsigned int reads;
+	unsigned int hits;
+	size_t bytes;
+	ktime_t time;
+};
+
+static struct mtdsplit_cache mtdsplit_cache;
+static DEFINE_MUTEX(mtdsplit_cache_lock);
+
+static void mtdsplit_cache_flush(void)
+{
+	struct mtdsplit_cache *c = &mtdsplit_cache;
+	unsigned int i;
+
+	if (!c->master)
+		return;
+
+	pr_info("%s: %u flash reads (%zu bytes) in %lld us, %u cache hits\n",
+		c->master->name, c->reads, c->bytes,
+		(long long) ktime_to_us(c->time), c->hits);
+
+	for (i = 0; i < c->nr_blocks; i++)
+		kfree(c->blocks[i]);
+
+	vfree(c->blocks);
+	memset(c, 0, sizeof(*c));
+}
+
+static void mtdsplit_cache_expire(struct work_struct *work)
+{
+	mutex_lock(&mtdsplit_cache_lock);
+	mtdsplit_cache_flush();
+	mutex_unlock(&mtdsplit_cache_lock);
+}
+
+static DECLARE_DELAYED_WORK(mtdsplit_cache_work, mtdsplit_cache_expire);
+
+static int mtdsplit_read_master(struct mtd_info *master, loff_t from,
+				size_t len, u8 *buf)
+{
+	struct mtdsplit_cache *c = &mtdsplit_cache;
+	ktime_t start = ktime_get();
+	size_t retlen;
+	int ret;
+
+	ret = mtd_read(master, from, len, &retlen, buf);
+
+	c->time = ktime_add(c->time, ktime_sub(ktime_get(), start));
+	c->reads++;
+	c->bytes += retlen;
+
+	if (ret)
+		return ret;
+
+	if (retlen != len)
+		return -EIO;
+
+	return 0;
+}
+
+static u8 *mtdsplit_cache_block(struct mtd_info *master, unsigned int block,
+				size_t *len)
+{
+	struct mtdsplit_cache *c = &mtdsplit_cache;
+	loff_t from = (loff_t) block * master->erasesize;
+	u8 *data;
+
+	*len = min_t(uint64_t, MTDSPLIT_CACHE_WINDOW, master->size - from);
+	*len = min_t(size_t, *len, master->erasesize);
+
+	if (c->blocks[block]) {
+		c->hits++;
+		return c->blocks[block];
+	}
+
+	data = kmalloc(*len, GFP_KERNEL);
+	if (!data)
+		return NULL;
+
+	if (mtdsplit_read_master(master, from, *len, data)) {
+		kfree(data);
+		return NULL;
+	}
+
+	c->blocks[block] = data;
+	return data;
+}
+
+int mtdsplit_read(struct mtd_info *mtd, size_t offset, size_t len, void *buf)
+{
+	struct mtdsplit_cache *c = &mtdsplit_cache;
+	struct mtd_info *master = mtdpart_get_master(mtd);
+	uint64_t from = mtdpart_get_offset(mtd) + offset;
+	unsigned int block, pos;
+	size_t block_len;
+	u8 *data;
+	int ret;
+
+	if (offset + len > mtd->size)
+		return -EINVAL;
+
+	mutex_lock(&mtdsplit_cache_lock);
+
+	if (c->master != master) {
+		mtdsplit_cache_flush();
+
+		c->nr_blocks = mtd_div_by_eb(master->size, master);
+		c->blocks = vzalloc(c->nr_blocks * sizeof(*c->blocks));
+		if (c->blocks)
+			c->master = master;
+	}
+
+	block = mtd_div_by_eb(from, master);
+	pos = mtd_mod_by_eb(from, master);
+	data = NULL;
+
+	if (c->master && block < c->nr_blocks &&
+	    pos + len <= MTDSPLIT_CACHE_WINDOW) {
+		data = mtdsplit_cache_block(master, block, &block_len);
+		if (data && pos + len > block_len)
+			data = NULL;
+	}
+
+	if (data) {
+		memcpy(buf, data + pos, len);
+		ret = 0;
+	} else {
+		ret = mtdsplit_read_master(master, from, len, buf);
+	}
+
+	mod_delayed_work(system_wq, &mtdsplit_cache_work,
+			 MTDSPLIT_CACHE_TIMEOUT);
+
+	mutex_unlock(&mtdsplit_cache_lock);
+
+	return ret;
+}
+EXPORT_SYMBOL_GPL(mtdsplit_read);
+
 struct squashfs_super_block {
 	__le32 s_magic;
 	__le32 pad0[9];
@@ -36,8 +198,8 @@ int mtd_get_squashfs_len(struct mtd_info *master,
 	size_t retlen;
 	int err;
 
-	err = mtd_read(master, offset, sizeof(sb), &retlen, (void *)&sb);
-	if (err || (retlen != sizeof(sb))) {
+	err = mtdsplit_read(master, offset, sizeof(sb), &sb);
+	if (err) {
 		pr_alert("error occured while reading from \"%s\"\n",
 			 master->name);
 		return -EIO;
@@ -73,17 +235,12 @@ static ssize_t mtd_next_eb(struct mtd_info *mtd, size_t offset)
 int mtd_check_rootfs_magic(struct mtd_info *mtd, size_t offset)
 {
 	u32 magic;
-	size_t retlen;
 	int ret;
 
-	ret = mtd_read(mtd, offset, sizeof(magic), &retlen,
-		       (unsigned char *) &magic);
+	ret = mtdsplit_read(mtd, offset, sizeof(magic), &magic);
 	if (ret)
 		return ret;
 
-	if (retlen != sizeof(magic))
-		return -EIO;
-
 	if (le32_to_cpu(magic) != SQUASHFS_MAGIC &&
 	    magic != 0x19852003)
 		return -EINVAL;
@@ -19,6 +19,8 @@
 #define ROOTFS_SPLIT_NAME	"rootfs_data"
 
 #ifdef CONFIG_MTD_SPLIT
+int mtdsplit_read(struct mtd_info *mtd, size_t offset, size_t len, void *buf);
+
 int mtd_get_squashfs_len(struct mtd_info *master,
 			 size_t offset,
 			 size_t *squashfs_len);
@@ -31,6 +33,19 @@ int mtd_find_rootfs_from(struct mtd_info *mtd,
 			 size_t *ret_offset);
 
 #else
+static inline int mtdsplit_read(struct mtd_info *mtd, size_t offset,
+				size_t len, void *buf)
+{
+	size_t retlen;
+	int ret;
+
+	ret = mtd_read(mtd, offset, len, &retlen, buf);
+	if (ret)
+		return ret;
+
+	return retlen == len ? 0 : -EIO;
+}
+
 static inline int mtd_get_squashfs_len(struct mtd_info *master,
 				       size_t offset,
 				       size_t *squashfs_len)
@@ -32,20 +32,17 @@ static int mtdsplit_parse_lzma(struct mtd_info *master,
 			       struct mtd_part_parser_data *data)
 {
 	struct lzma_header hdr;
-	size_t hdr_len, retlen;
+	size_t hdr_len;
 	size_t rootfs_offset;
 	u32 t;
 	struct mtd_partition *parts;
 	int err;
 
 	hdr_len = sizeof(hdr);
-	err = mtd_read(master, 0, hdr_len, &retlen, (void *) &hdr);
+	err = mtdsplit_read(master, 0, hdr_len, &hdr);
 	if (err)
 		return err;
 
-	if (retlen != hdr_len)
-		return -EIO;
-
 	/* verify LZMA properties */
 	if (hdr.props[0] >= (9 * 5 * 5))
 		return -EINVAL;
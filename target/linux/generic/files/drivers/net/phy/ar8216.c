@@ -45,6 +45,8 @@
 #define AR8X16_MAX_PORTS	8
 
 #define AR8XXX_MIB_WORK_DELAY	2000 /* msecs */
+#define AR8XXX_MIB_WORK_MAX_DELAY	16000 /* msecs */
+#define AR8XXX_MIB_CACHE_TIME	1000 /* msecs */
 
 struct ar8xxx_priv;
 
@@ -149,8 +151,11 @@ struct ar8xxx_priv {
 
 	struct mutex mib_lock;
 	struct delayed_work mib_work;
-	int mib_next_port;
+	unsigned int mib_poll_interval;
+	unsigned int mib_idle;
+	unsigned long mib_updated;
 	u64 *mib_stats;
+	struct ar8xxx_mib_dump *mib_dump;
 
 	struct list_head list;
 	unsigned int use_count;
@@ -169,6 +174,13 @@ struct ar8xxx_priv {
 	int monitor_port;
 };
 
+/* value of the "mibs" attribute, in host byte order */
+struct ar8xxx_mib_dump {
+	u32 ports;
+	u32 num_mibs;
+	u64 stats[];
+};
+
 #define MIB_DESC(_s , _o, _n)	\
 	{			\
 		.size = (_s),	\
@@ -494,11 +506,13 @@ ar8xxx_mib_flush(struct ar8xxx_priv *priv)
 	return ar8xxx_mib_op(priv, AR8216_MIB_FUNC_FLUSH);
 }
 
-static void
+/* returns true if any of the counters has changed since the last fetch */
+static bool
 ar8xxx_mib_fetch_port_stat(struct ar8xxx_priv *priv, int port, bool flush)
 {
 	unsigned int base;
 	u64 *mib_stats;
+	bool changed = false;
 	int i;
 
 	WARN_ON(port >= priv->dev.ports);
@@ -531,7 +545,92 @@ ar8xxx_mib_fetch_port_stat(struct ar8xxx_priv *priv, int port, bool flush)
 			mib_stats[i] = 0;
 		else
 			mib_stats[i] += t;
+
+		if (t)
+			changed = true;
 	}
+
+	return changed;
+}
+
+/*
+ * Capture the counters once and fetch them for all ports, so that no
+ * captured values are left unread. The counters of flush_port (if not
+ * negative) are cleared instead of accumulated.
+ */
+static int
+ar8xxx_mib_update(struct ar8xxx_priv *priv, int flush_port)
+{
+	bool changed = false;
+	int ret;
+	int i;
+
+	lockdep_assert_held(&priv->mib_lock);
+
+	ret = ar8xxx_mib_capture(priv);
+	if (ret)
+		return ret;
+
+	for (i = 0; i < priv->dev.ports; i++)
+		if (ar8xxx_mib_fetch_port_stat(priv, i, i == flush_port))
+			changed = true;
+
+	priv->mib_updated = jiffies;
+	if (changed)
+		priv->mib_idle = 0;
+	else if (priv->mib_idle < 3)
+		priv->mib_idle++;
+
+	return 0;
+}
+
+/* reuse the counters if they have been fetched very recently */
+static int
+ar8xxx_mib_refresh(struct ar8xxx_priv *priv)
+{
+	if (priv->mib_updated &&
+	    time_before(jiffies, priv->mib_updated +
+			msecs_to_jiffies(AR8XXX_MIB_CACHE_TIME)))
+		return 0;
+
+	return ar8xxx_mib_update(priv, -1);
+}
+
+/*
+ * While no counter changes, the poll interval is doubled up to
+ * AR8XXX_MIB_WORK_MAX_DELAY, which is short enough that the 32 bit
+ * hardware counters cannot wrap in between.  Without a configured
+ * interval the counters are still polled at that rate for this reason.
+ */
+static unsigned int
+ar8xxx_mib_poll_delay(struct ar8xxx_priv *priv)
+{
+	unsigned int delay;
+
+	if (!priv->mib_poll_interval)
+		return AR8XXX_MIB_WORK_MAX_DELAY;
+
+	delay = priv->mib_poll_interval << priv->mib_idle;
+	return min(delay, (unsigned int) AR8XXX_MIB_WORK_MAX_DELAY);
+}
+
+static void
+ar8xxx_mib_start(struct ar8xxx_priv *priv)
+{
+	if (!ar8xxx_has_mib_counters(priv))
+		return;
+
+	schedule_delayed_work(&priv->mib_work,
+			      msecs_to_jiffies(ar8xxx_mib_poll_delay(priv)));
+}
+
+static void
+ar8xxx_mib_stop(struct ar8xxx_priv *priv)
+{
+	if (!ar8xxx_has_mib_counters(priv))
+		return;
+
+	cancel_delayed_work_sync(&priv->mib_work);
 }
 
 static void
@@ -2241,12 +2340,10 @@ ar8xxx_sw_set_port_reset_mib(struct switch_dev *dev,
 		return -EINVAL;
 
 	mutex_lock(&priv->mib_lock);
-	ret = ar8xxx_mib_capture(priv);
+	ret = ar8xxx_mib_update(priv, port);
 	if (ret)
 		goto unlock;
 
-	ar8xxx_mib_fetch_port_stat(priv, port, true);
-
 	ret = 0;
 
 unlock:
@@ -2275,12 +2372,10 @@ ar8xxx_sw_get_port_mib(struct switch_dev *dev,
 		return -EINVAL;
 
 	mutex_lock(&priv->mib_lock);
-	ret = ar8xxx_mib_capture(priv);
+	ret = ar8xxx_mib_refresh(priv);
 	if (ret)
 		goto unlock;
 
-	ar8xxx_mib_fetch_port_stat(priv, port, false);
-
 	len += snprintf(buf + len, sizeof(priv->buf) - len,
 			"Port %d MIB counters\n",
 			port);
@@ -2302,6 +2397,70 @@ unlock:
 	return ret;
 }
 
+static int
+ar8xxx_sw_get_mibs(struct switch_dev *dev,
+		   const struct switch_attr *attr,
+		   struct switch_val *val)
+{
+	struct ar8xxx_priv *priv = swdev_to_ar8xxx(dev);
+	struct ar8xxx_mib_dump *dump = priv->mib_dump;
+	unsigned int len;
+	int ret;
+
+	if (!ar8xxx_has_mib_counters(priv))
+		return -EOPNOTSUPP;
+
+	len = dev->ports * priv->chip->num_mibs * sizeof(*priv->mib_stats);
+
+	mutex_lock(&priv->mib_lock);
+	ret = ar8xxx_mib_refresh(priv);
+	if (ret)
+		goto unlock;
+
+	dump->ports = dev->ports;
+	dump->num_mibs = priv->chip->num_mibs;
+	memcpy(dump->stats, priv->mib_stats, len);
+
+	val->value.s = (const char *) dump;
+	val->len = sizeof(*dump) + len;
+
+unlock:
+	mutex_unlock(&priv->mib_lock);
+	return ret;
+}
+
+static int
+ar8xxx_sw_set_mib_poll_interval(struct switch_dev *dev,
+				const struct switch_attr *attr,
+				struct switch_val *val)
+{
+	struct ar8xxx_priv *priv = swdev_to_ar8xxx(dev);
+
+	if (!ar8xxx_has_mib_counters(priv))
+		return -EOPNOTSUPP;
+
+	if (val->value.i > AR8XXX_MIB_WORK_MAX_DELAY)
+		return -EINVAL;
+
+	ar8xxx_mib_stop(priv);
+	priv->mib_poll_interval = val->value.i;
+	priv->mib_idle = 0;
+	ar8xxx_mib_start(priv);
+
+	return 0;
+}
+
+static int
+ar8xxx_sw_get_mib_poll_interval(struct switch_dev *dev,
+				const struct switch_attr *attr,
+				struct switch_val *val)
+{
+	struct ar8xxx_priv *priv = swdev_to_ar8xxx(dev);
+
+	val->value.i = priv->mib_poll_interval;
+	return 0;
+}
+
 static struct switch_attr ar8xxx_sw_attr_globals[] = {
 	{
 		.type = SWITCH_TYPE_INT,
@@ -2317,6 +2476,22 @@ static struct switch_attr ar8xxx_sw_attr_globals[] = {
 		.description = "Reset all MIB counters",
 		.set = ar8xxx_sw_set_reset_mibs,
 	},
+	{
+		.type = SWITCH_TYPE_BINARY,
+		.name = "mibs",
+		.description = "MIB counters of all ports (u32 ports, u32 counters, "
+			       "u64 values in the order of the port mib attribute)",
+		.get = ar8xxx_sw_get_mibs,
+	},
+	{
+		.type = SWITCH_TYPE_INT,
+		.name = "mib_poll_interval",
+		.description = "MIB counter poll interval in ms, 0 to only "
+			       "poll as often as needed to catch counter wraps",
+		.set = ar8xxx_sw_set_mib_poll_interval,
+		.get = ar8xxx_sw_get_mib_poll_interval,
+		.max = AR8XXX_MIB_WORK_MAX_DELAY
+	},
 	{
 		.type = SWITCH_TYPE_INT,
 		.name = "enable_mirror_rx",
@@ -2366,6 +2541,22 @@ static struct switch_attr ar8327_sw_attr_globals[] = {
 		.description = "Reset all MIB counters",
 		.set = ar8xxx_sw_set_reset_mibs,
 	},
+	{
+		.type = SWITCH_TYPE_BINARY,
+		.name = "mibs",
+		.description = "MIB counters of all ports (u32 ports, u32 counters, "
+			       "u64 values in the order of the port mib attribute)",
+		.get = ar8xxx_sw_get_mibs,
+	},
+	{
+		.type = SWITCH_TYPE_INT,
+		.name = "mib_poll_interval",
+		.description = "MIB counter poll interval in ms, 0 to only "
+			       "poll as often as needed to catch counter wraps",
+		.set = ar8xxx_sw_set_mib_poll_interval,
+		.get = ar8xxx_sw_get_mib_poll_interval,
+		.max = AR8XXX_MIB_WORK_MAX_DELAY
+	},
 	{
 		.type = SWITCH_TYPE_INT,
 		.name = "enable_mirror_rx",
@@ -2530,26 +2721,17 @@ static void
 ar8xxx_mib_work_func(struct work_struct *work)
 {
 	struct ar8xxx_priv *priv;
-	int err;
+	unsigned int delay;
 
 	priv = container_of(work, struct ar8xxx_priv, mib_work.work);
 
 	mutex_lock(&priv->mib_lock);
 
-	err = ar8xxx_mib_capture(priv);
-	if (err)
-		goto next_port;
-
-	ar8xxx_mib_fetch_port_stat(priv, priv->mib_next_port, false);
-
-next_port:
-	priv->mib_next_port++;
-	if (priv->mib_next_port >= priv->dev.ports)
-		priv->mib_next_port = 0;
+	ar8xxx_mib_update(priv, -1);
+	delay = ar8xxx_mib_poll_delay(priv);
 
 	mutex_unlock(&priv->mib_lock);
-	schedule_delayed_work(&priv->mib_work,
-			      msecs_to_jiffies(AR8XXX_MIB_WORK_DELAY));
+	schedule_delayed_work(&priv->mib_work, msecs_to_jiffies(delay));
 }
 
 static int
@@ -2569,26 +2751,16 @@ ar8xxx_mib_init(struct ar8xxx_priv *priv)
 	if (!priv->mib_stats)
 		return -ENOMEM;
 
-	return 0;
-}
-
-static void
-ar8xxx_mib_start(struct ar8xxx_priv *priv)
-{
-	if (!ar8xxx_has_mib_counters(priv))
-		return;
-
-	schedule_delayed_work(&priv->mib_work,
-			      msecs_to_jiffies(AR8XXX_MIB_WORK_DELAY));
-}
+	priv->mib_dump = kzalloc(sizeof(*priv->mib_dump) + len, GFP_KERNEL);
+	if (!priv->mib_dump) {
+		kfree(priv->mib_stats);
+		priv->mib_stats = NULL;
+		return -ENOMEM;
+	}
 
-static void
-ar8xxx_mib_stop(struct ar8xxx_priv *priv)
-{
-	if (!ar8xxx_has_mib_counters(priv))
-		return;
+	priv->mib_poll_interval = AR8XXX_MIB_WORK_DELAY;
 
-	cancel_delayed_work(&priv->mib_work);
+	return 0;
 }
 
 static struct ar8xxx_priv *
@@ -2614,6 +2786,7 @@ ar8xxx_free(struct ar8xxx_priv *priv)
 		priv->chip->cleanup(priv);
 
 	kfree(priv->mib_stats);
+	kfree(priv->mib_dump);
 	kfree(priv);
 }
 
@@ -315,6 +315,7 @@ static const struct nla_policy switch_policy[SWITCH_ATTR_MAX+1] = {
 	[SWITCH_ATTR_OP_VALUE_INT] = { .type = NLA_U32 },
 	[SWITCH_ATTR_OP_VALUE_STR] = { .type = NLA_NUL_STRING },
 	[SWITCH_ATTR_OP_VALUE_PORTS] = { .type = NLA_NESTED },
+	[SWITCH_ATTR_OP_VALUE_BINARY] = { .type = NLA_BINARY },
 	[SWITCH_ATTR_TYPE] = { .type = NLA_U32 },
 };
 
@@ -336,16 +337,11 @@ swconfig_unlock(void)
 }
 
 static struct switch_dev *
-swconfig_get_dev(struct genl_info *info)
+swconfig_get_dev_by_id(int id)
 {
 	struct switch_dev *dev = NULL;
 	struct switch_dev *p;
-	int id;
-
-	if (!info->attrs[SWITCH_ATTR_ID])
-		goto done;
 
-	id = nla_get_u32(info->attrs[SWITCH_ATTR_ID]);
 	swconfig_lock();
 	list_for_each_entry(p, &swdevs, dev_list) {
 		if (id != p->id)
@@ -359,10 +355,19 @@ swconfig_get_dev(struct genl_info *info)
 	else
 		pr_debug("device %d not found\n", id);
 	swconfig_unlock();
-done:
+
 	return dev;
 }
 
+static struct switch_dev *
+swconfig_get_dev(struct genl_info *info)
+{
+	if (!info->attrs[SWITCH_ATTR_ID])
+		return NULL;
+
+	return swconfig_get_dev_by_id(nla_get_u32(info->attrs[SWITCH_ATTR_ID]));
+}
+
 static inline void
 swconfig_put_dev(struct switch_dev *dev)
 {
@@ -815,6 +820,11 @@ swconfig_get_attr(struct sk_buff *skb, struct genl_info *info)
 		if (nla_put_string(msg, SWITCH_ATTR_OP_VALUE_STR, val.value.s))
 			goto nla_put_failure;
 		break;
+	case SWITCH_TYPE_BINARY:
+		if (nla_put(msg, SWITCH_ATTR_OP_VALUE_BINARY, val.len,
+			    val.value.s))
+			goto nla_put_failure;
+		break;
 	case SWITCH_TYPE_PORTS:
 		err = swconfig_send_ports(&msg, info,
 				SWITCH_ATTR_OP_VALUE_PORTS, &val);
@@ -843,6 +853,202 @@ error:
 	return err;
 }
 
+enum {
+	SWCONFIG_DUMP_GLOBAL,
+	SWCONFIG_DUMP_PORT,
+	SWCONFIG_DUMP_VLAN,
+	__SWCONFIG_DUMP_MAX
+};
+
+static int
+swconfig_put_ports(struct sk_buff *msg, const struct switch_val *val)
+{
+	struct nlattr *n, *p;
+	int i;
+
+	n = nla_nest_start(msg, SWITCH_ATTR_OP_VALUE_PORTS);
+	if (!n)
+		return -EMSGSIZE;
+
+	for (i = 0; i < val->len; i++) {
+		const struct switch_port *port = &val->value.ports[i];
+
+		p = nla_nest_start(msg, SWITCH_ATTR_PORT);
+		if (!p)
+			return -EMSGSIZE;
+		if (nla_put_u32(msg, SWITCH_PORT_ID, port->id))
+			return -EMSGSIZE;
+		if ((port->flags & (1 << SWITCH_PORT_FLAG_TAGGED)) &&
+		    nla_put_flag(msg, SWITCH_PORT_FLAG_TAGGED))
+			return -EMSGSIZE;
+		nla_nest_end(msg, p);
+	}
+
+	nla_nest_end(msg, n);
+	return 0;
+}
+
+static int
+swconfig_dump_val(struct sk_buff *msg, struct netlink_callback *cb,
+		struct switch_dev *dev, const struct switch_attr *attr,
+		int id, int group, int port_vlan)
+{
+	struct switch_val val;
+	void *hdr;
+
+	hdr = genlmsg_put(msg, NETLINK_CB(cb->skb).portid, cb->nlh->nlmsg_seq,
+			&switch_fam, NLM_F_MULTI, SWITCH_CMD_NEW_ATTR);
+	if (!hdr)
+		return -EMSGSIZE;
+
+	if (nla_put_u32(msg, SWITCH_ATTR_OP_ID, id))
+		goto nla_put_failure;
+	if (group == SWCONFIG_DUMP_PORT &&
+	    nla_put_u32(msg, SWITCH_ATTR_OP_PORT, port_vlan))
+		goto nla_put_failure;
+	if (group == SWCONFIG_DUMP_VLAN &&
+	    nla_put_u32(msg, SWITCH_ATTR_OP_VLAN, port_vlan))
+		goto nla_put_failure;
+
+	memset(&val, 0, sizeof(val));
+	val.attr = attr;
+	val.port_vlan = port_vlan;
+	if (attr->type == SWITCH_TYPE_PORTS) {
+		val.value.ports = dev->portbuf;
+		memset(dev->portbuf, 0,
+			sizeof(struct switch_port) * dev->ports);
+	}
+
+	/* attributes that cannot be read are sent without a value */
+	if (attr->get && !attr->get(dev, attr, &val)) {
+		switch (attr->type) {
+		case SWITCH_TYPE_INT:
+			if (nla_put_u32(msg, SWITCH_ATTR_OP_VALUE_INT,
+					val.value.i))
+				goto nla_put_failure;
+			break;
+		case SWITCH_TYPE_STRING:
+			if (nla_put_string(msg, SWITCH_ATTR_OP_VALUE_STR,
+					val.value.s))
+				goto nla_put_failure;
+			break;
+		case SWITCH_TYPE_BINARY:
+			if (nla_put(msg, SWITCH_ATTR_OP_VALUE_BINARY,
+				    val.len, val.value.s))
+				goto nla_put_failure;
+			break;
+		case SWITCH_TYPE_PORTS:
+			if (swconfig_put_ports(msg, &val))
+				goto nla_put_failure;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return genlmsg_end(msg, hdr);
+
+nla_put_failure:
+	genlmsg_cancel(msg, hdr);
+	return -EMSGSIZE;
+}
+
+/*
+ * Dump the values of all global, port and vlan attributes, one message
+ * per value. The position is kept in cb->args: device id, group,
+ * port/vlan index and attribute index.
+ */
+static int
+swconfig_dump_attrs(struct sk_buff *skb, struct netlink_callback *cb)
+{
+	struct nlattr *tb[SWITCH_ATTR_MAX + 1];
+	const struct switch_attrlist *alist;
+	const struct switch_attr *attr;
+	struct switch_attr *def_list;
+	unsigned long *def_active;
+	struct switch_dev *dev;
+	int group = cb->args[1];
+	int idx = cb->args[2];
+	int pos = cb->args[3];
+	int n_def, count, id;
+	int err;
+
+	if (!cb->args[0]) {
+		err = nlmsg_parse(cb->nlh, GENL_HDRLEN + switch_fam.hdrsize,
+				tb, SWITCH_ATTR_MAX, switch_policy);
+		if (err)
+			return err;
+		if (!tb[SWITCH_ATTR_ID])
+			return -EINVAL;
+		cb->args[0] = nla_get_u32(tb[SWITCH_ATTR_ID]);
+	}
+
+	dev = swconfig_get_dev_by_id(cb->args[0]);
+	if (!dev)
+		return -EINVAL;
+
+	for (; group < __SWCONFIG_DUMP_MAX; group++, idx = 0, pos = 0) {
+		switch (group) {
+		case SWCONFIG_DUMP_GLOBAL:
+			alist = &dev->ops->attr_global;
+			def_list = default_global;
+			def_active = &dev->def_global;
+			n_def = ARRAY_SIZE(default_global);
+			count = 1;
+			break;
+		case SWCONFIG_DUMP_PORT:
+			alist = &dev->ops->attr_port;
+			def_list = default_port;
+			def_active = &dev->def_port;
+			n_def = ARRAY_SIZE(default_port);
+			count = dev->ports;
+			break;
+		default:
+			alist = &dev->ops->attr_vlan;
+			def_list = default_vlan;
+			def_active = &dev->def_vlan;
+			n_def = ARRAY_SIZE(default_vlan);
+			count = dev->vlans;
+			break;
+		}
+
+		for (; idx < count; idx++, pos = 0) {
+			for (; pos < alist->n_attr + n_def; pos++) {
+				if (pos < alist->n_attr) {
+					attr = &alist->attr[pos];
+					id = pos;
+				} else {
+					id = pos - alist->n_attr;
+					if (!test_bit(id, def_active))
+						continue;
+					attr = &def_list[id];
+					id += SWITCH_ATTR_DEFAULTS_OFFSET;
+				}
+
+				if (attr->disabled ||
+				    attr->type == SWITCH_TYPE_NOVAL)
+					continue;
+
+				if (swconfig_dump_val(skb, cb, dev, attr, id,
+						group, idx) < 0)
+					goto out;
+			}
+		}
+	}
+
+out:
+	cb->args[1] = group;
+	cb->args[2] = idx;
+	cb->args[3] = pos;
+	swconfig_put_dev(dev);
+
+	/* a single value did not fit into an empty message */
+	if (!skb->len && group < __SWCONFIG_DUMP_MAX)
+		return -EMSGSIZE;
+
+	return skb->len;
+}
+
 static int
 swconfig_send_switch(struct sk_buff *msg, u32 pid, u32 seq, int flags,
 		const struct switch_dev *dev)
@@ -974,6 +1180,12 @@ static struct genl_ops swconfig_ops[] = {
 		.dumpit = swconfig_dump_switches,
 		.policy = switch_policy,
 		.done = swconfig_done,
+	},
+	{
+		.cmd = SWITCH_CMD_DUMP_ATTRS,
+		.dumpit = swconfig_dump_attrs,
+		.policy = switch_policy,
+		.done = swconfig_done,
 	}
 };
 
@@ -18,6 +18,7 @@
 #include <linux/workqueue.h>
 
 #define SWCONFIG_LED_TIMER_INTERVAL	(HZ / 10)
+#define SWCONFIG_LED_TIMER_MAX		HZ
 #define SWCONFIG_LED_NUM_PORTS		32
 
 struct switch_led_trigger {
@@ -25,6 +26,8 @@ struct switch_led_trigger {
 	struct switch_dev *swdev;
 
 	struct delayed_work sw_led_work;
+	unsigned long interval;
+	unsigned long link_changed;
 	u32 port_mask;
 	u32 port_link;
 	unsigned long port_traffic[SWCONFIG_LED_NUM_PORTS];
@@ -80,11 +83,15 @@ swconfig_trig_update_port_mask(struct led_trigger *trigger)
 
 	sw_trig->port_mask = port_mask;
 
-	if (port_mask)
+	if (port_mask) {
+		/* read the link state of newly added ports */
+		sw_trig->link_changed = ~0UL;
+		sw_trig->interval = SWCONFIG_LED_TIMER_INTERVAL;
 		schedule_delayed_work(&sw_trig->sw_led_work,
 				      SWCONFIG_LED_TIMER_INTERVAL);
-	else
+	} else {
 		cancel_delayed_work_sync(&sw_trig->sw_led_work);
+	}
 }
 
 static ssize_t
@@ -248,11 +255,20 @@ swconfig_trig_update_leds(struct switch_led_trigger *sw_trig)
 	read_unlock(&trigger->leddev_list_lock);
 }
 
+/*
+ * Ports are read once per run for all LEDs bound to the trigger. Ports
+ * without link are not polled for traffic, and the interval is doubled up
+ * to SWCONFIG_LED_TIMER_MAX while neither link nor traffic changes. If the
+ * driver reports link changes, only those ports have their link state
+ * read, and polling stops entirely while no link is up or the driver has
+ * no traffic counters.
+ */
 static void
 swconfig_led_work_func(struct work_struct *work)
 {
 	struct switch_led_trigger *sw_trig;
 	struct switch_dev *swdev;
+	bool changed = false;
 	u32 port_mask;
 	u32 link;
 	int i;
@@ -263,7 +279,7 @@ swconfig_led_work_func(struct work_struct *work)
 	port_mask = sw_trig->port_mask;
 	swdev = sw_trig->swdev;
 
-	link = 0;
+	link = sw_trig->port_link & port_mask;
 	for (i = 0; i < SWCONFIG_LED_NUM_PORTS; i++) {
 		u32 port_bit;
 
@@ -271,7 +287,9 @@ swconfig_led_work_func(struct work_struct *work)
 		if ((port_mask & port_bit) == 0)
 			continue;
 
-		if (swdev->ops->get_port_link) {
+		if (swdev->ops->get_port_link &&
+		    (!swdev->link_notify ||
+		     test_and_clear_bit(i, &sw_trig->link_changed))) {
 			struct switch_port_link port_link;
 
 			memset(&port_link, '\0', sizeof(port_link));
@@ -279,26 +297,68 @@ swconfig_led_work_func(struct work_struct *work)
 
 			if (port_link.link)
 				link |= port_bit;
+			else
+				link &= ~port_bit;
 		}
 
-		if (swdev->ops->get_port_stats) {
+		if ((link & port_bit) && swdev->ops->get_port_stats) {
 			struct switch_port_stats port_stats;
+			unsigned long traffic;
 
 			memset(&port_stats, '\0', sizeof(port_stats));
 			swdev->ops->get_port_stats(swdev, i, &port_stats);
-			sw_trig->port_traffic[i] = port_stats.tx_bytes +
-						   port_stats.rx_bytes;
+			traffic = port_stats.tx_bytes + port_stats.rx_bytes;
+			if (traffic != sw_trig->port_traffic[i])
+				changed = true;
+			sw_trig->port_traffic[i] = traffic;
 		}
 	}
 
+	if (link != sw_trig->port_link)
+		changed = true;
+
 	sw_trig->port_link = link;
 
 	swconfig_trig_update_leds(sw_trig);
 
-	schedule_delayed_work(&sw_trig->sw_led_work,
-			      SWCONFIG_LED_TIMER_INTERVAL);
+	if (changed)
+		sw_trig->interval = SWCONFIG_LED_TIMER_INTERVAL;
+	else if (sw_trig->interval < SWCONFIG_LED_TIMER_MAX)
+		sw_trig->interval = min_t(unsigned long, sw_trig->interval * 2,
+					  SWCONFIG_LED_TIMER_MAX);
+
+	if (swdev->link_notify && (!link || !swdev->ops->get_port_stats))
+		return;
+
+	schedule_delayed_work(&sw_trig->sw_led_work, sw_trig->interval);
 }
 
+/**
+ * switch_port_link_changed - report a link change on a switch port
+ * @swdev: switch device
+ * @port: port number
+ *
+ * Drivers that set @swdev->link_notify must call this whenever the link
+ * of a port goes up or down. It may be called from interrupt context.
+ */
+void
+switch_port_link_changed(struct switch_dev *swdev, int port)
+{
+	struct switch_led_trigger *sw_trig = swdev->led_trigger;
+
+	if (!sw_trig || port < 0 || port >= SWCONFIG_LED_NUM_PORTS)
+		return;
+
+	set_bit(port, &sw_trig->link_changed);
+	if (!(sw_trig->port_mask & BIT(port)))
+		return;
+
+	sw_trig->interval = SWCONFIG_LED_TIMER_INTERVAL;
+	cancel_delayed_work(&sw_trig->sw_led_work);
+	schedule_delayed_work(&sw_trig->sw_led_work, 0);
+}
+EXPORT_SYMBOL_GPL(switch_port_link_changed);
+
 static int
 swconfig_create_led_trigger(struct switch_dev *swdev)
 {
@@ -313,6 +373,7 @@ swconfig_create_led_trigger(struct switch_dev *swdev)
 		return -ENOMEM;
 
 	sw_trig->swdev = swdev;
+	sw_trig->interval = SWCONFIG_LED_TIMER_INTERVAL;
 	sw_trig->trig.name = swdev->devname;
 	sw_trig->trig.activate = swconfig_trig_activate;
 	sw_trig->trig.deactivate = swconfig_trig_deactivate;
@@ -346,6 +407,10 @@ swconfig_destroy_led_trigger(struct switch_dev *swdev)
 }
 
 #else /* SWCONFIG_LEDS */
+void
+switch_port_link_changed(struct switch_dev *swdev, int port) { }
+EXPORT_SYMBOL_GPL(switch_port_link_changed);
+
 static inline int
 swconfig_create_led_trigger(struct switch_dev *swdev) { return 0; }
 
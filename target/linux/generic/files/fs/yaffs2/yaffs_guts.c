@@ -44,6 +44,9 @@ static int yaffs_wr_data_obj(struct yaffs_obj *in, int inode_chunk,
 static void yaffs_fix_null_name(struct yaffs_obj *obj, YCHAR *name,
 				int buffer_size);
 
+static void yaffs_gc_index_update(struct yaffs_dev *dev, int block_no,
+				  struct yaffs_block_info *bi);
+
 /* Function to calculate chunk and offset */
 
 void yaffs_addr_to_chunk(struct yaffs_dev *dev, loff_t addr,
@@ -438,6 +441,7 @@ static int yaffs_alloc_chunk(struct yaffs_dev *dev, int use_reserver,
 		/* If the block is full set the state to full */
 		if (dev->alloc_page >= dev->param.chunks_per_block) {
 			bi->block_state = YAFFS_BLOCK_STATE_FULL;
+			yaffs_gc_index_update(dev, dev->alloc_block, bi);
 			dev->alloc_block = -1;
 		}
 
@@ -478,6 +482,7 @@ void yaffs_skip_rest_of_block(struct yaffs_dev *dev)
 		bi = yaffs_get_block_info(dev, dev->alloc_block);
 		if (bi->block_state == YAFFS_BLOCK_STATE_ALLOCATING) {
 			bi->block_state = YAFFS_BLOCK_STATE_FULL;
+			yaffs_gc_index_update(dev, dev->alloc_block, bi);
 			dev->alloc_block = -1;
 		}
 	}
@@ -625,6 +630,7 @@ static void yaffs_retire_block(struct yaffs_dev *dev, int flash_block)
 	bi->block_state = YAFFS_BLOCK_STATE_DEAD;
 	bi->gc_prioritise = 0;
 	bi->needs_retiring = 0;
+	yaffs_gc_index_update(dev, flash_block, bi);
 
 	dev->n_retired_blocks++;
 }
@@ -649,6 +655,237 @@ static u16 yaffs_calc_name_sum(const YCHAR *name)
 	return sum;
 }
 
+static u32 yaffs_calc_name_hash(const YCHAR *name)
+{
+	u32 hash = 2166136261u;
+	int i;
+
+	/* FNV-1a over the significant part of the name, case sensitive */
+	for (i = 0; name[i] && i < YAFFS_MAX_NAME_LENGTH; i++) {
+		hash ^= (u32) name[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/*---------------- Directory name index ------------*/
+
+/* buffer must hold YAFFS_MAX_NAME_LENGTH + 1 characters */
+static void yaffs_obj_name_hash(struct yaffs_obj *obj, YCHAR *buffer)
+{
+	if (obj->name_hashed)
+		return;
+
+	yaffs_get_obj_name(obj, buffer, YAFFS_MAX_NAME_LENGTH + 1);
+	obj->name_hash = yaffs_calc_name_hash(buffer);
+	obj->name_hashed = 1;
+}
+
+static void yaffs_dir_index_insert(struct yaffs_dir_index *index,
+				   struct yaffs_obj *obj)
+{
+	if (obj->name_hashed)
+		list_add(&obj->name_link, &index->buckets[obj->name_hash &
+							  (index->n_buckets - 1)]);
+	else
+		list_add(&obj->name_link, &index->pending);
+}
+
+static struct yaffs_dir_index *yaffs_dir_index_alloc(u32 n_buckets)
+{
+	struct yaffs_dir_index *index;
+	u32 i;
+
+	index = kmalloc(sizeof(*index) + n_buckets * sizeof(struct list_head),
+			GFP_NOFS);
+	if (!index)
+		return NULL;
+
+	index->n_buckets = n_buckets;
+	index->n_entries = 0;
+	INIT_LIST_HEAD(&index->pending);
+	for (i = 0; i < n_buckets; i++)
+		INIT_LIST_HEAD(&index->buckets[i]);
+
+	return index;
+}
+
+static void yaffs_dir_index_grow(struct yaffs_obj *dir)
+{
+	struct yaffs_dir_index *index = dir->variant.dir_variant.index;
+	struct yaffs_dir_index *new_index;
+	struct list_head *lh;
+	struct list_head *n;
+	struct yaffs_obj *obj;
+
+	if (index->n_buckets >= YAFFS_DIR_INDEX_MAX_BUCKETS ||
+	    index->n_entries <= index->n_buckets * 2)
+		return;
+
+	new_index = yaffs_dir_index_alloc(index->n_buckets * 4);
+	if (!new_index)
+		return;
+
+	list_for_each_safe(lh, n, &dir->variant.dir_variant.children) {
+		obj = list_entry(lh, struct yaffs_obj, siblings);
+		if (list_empty(&obj->name_link))
+			continue;
+		list_del(&obj->name_link);
+		yaffs_dir_index_insert(new_index, obj);
+		new_index->n_entries++;
+	}
+
+	kfree(index);
+	dir->variant.dir_variant.index = new_index;
+}
+
+static void yaffs_dir_index_add(struct yaffs_obj *dir, struct yaffs_obj *obj)
+{
+	struct yaffs_dir_index *index = dir->variant.dir_variant.index;
+
+	if (!index) {
+		dir->variant.dir_variant.index_small = 0;
+		return;
+	}
+
+	yaffs_dir_index_insert(index, obj);
+	index->n_entries++;
+	yaffs_dir_index_grow(dir);
+}
+
+static void yaffs_dir_index_remove(struct yaffs_obj *obj)
+{
+	if (list_empty(&obj->name_link))
+		return;
+
+	list_del_init(&obj->name_link);
+	obj->parent->variant.dir_variant.index->n_entries--;
+}
+
+/* Move an indexed object to the bucket matching its (new) name */
+static void yaffs_dir_index_rehash(struct yaffs_obj *obj)
+{
+	if (list_empty(&obj->name_link))
+		return;
+
+	list_del(&obj->name_link);
+	yaffs_dir_index_insert(obj->parent->variant.dir_variant.index, obj);
+}
+
+static void yaffs_dir_index_free(struct yaffs_obj *dir)
+{
+	struct yaffs_dir_index *index = dir->variant.dir_variant.index;
+	struct list_head *lh;
+	struct yaffs_obj *obj;
+
+	if (!index)
+		return;
+
+	list_for_each(lh, &dir->variant.dir_variant.children) {
+		obj = list_entry(lh, struct yaffs_obj, siblings);
+		list_del_init(&obj->name_link);
+	}
+
+	kfree(index);
+	dir->variant.dir_variant.index = NULL;
+}
+
+static void yaffs_dir_index_free_all(struct yaffs_dev *dev)
+{
+	struct list_head *lh;
+	struct yaffs_obj *obj;
+	int i;
+
+	for (i = 0; i < YAFFS_NOBJECT_BUCKETS; i++) {
+		list_for_each(lh, &dev->obj_bucket[i].list) {
+			obj = list_entry(lh, struct yaffs_obj, hash_link);
+			if (obj->variant_type == YAFFS_OBJECT_TYPE_DIRECTORY)
+				yaffs_dir_index_free(obj);
+		}
+	}
+}
+
+/*
+ * Returns 1 if the directory has a name index, building it if the directory
+ * is large enough to be worth one.
+ */
+static int yaffs_dir_index_build(struct yaffs_obj *dir, YCHAR *buffer)
+{
+	struct yaffs_dir_index *index;
+	struct list_head *lh;
+	struct yaffs_obj *obj;
+	u32 n_children = 0;
+	u32 n_buckets = 64;
+
+	if (dir->variant.dir_variant.index)
+		return 1;
+
+	if (dir->variant.dir_variant.index_small)
+		return 0;
+
+	list_for_each(lh, &dir->variant.dir_variant.children)
+		n_children++;
+
+	if (n_children < YAFFS_DIR_INDEX_MIN) {
+		dir->variant.dir_variant.index_small = 1;
+		return 0;
+	}
+
+	while (n_buckets < n_children && n_buckets < YAFFS_DIR_INDEX_MAX_BUCKETS)
+		n_buckets <<= 1;
+
+	index = yaffs_dir_index_alloc(n_buckets);
+	if (!index)
+		return 0;
+
+	list_for_each(lh, &dir->variant.dir_variant.children) {
+		obj = list_entry(lh, struct yaffs_obj, siblings);
+		yaffs_obj_name_hash(obj, buffer);
+		yaffs_dir_index_insert(index, obj);
+		index->n_entries++;
+	}
+
+	dir->variant.dir_variant.index = index;
+
+	yaffs_trace(YAFFS_TRACE_OS,
+		"built name index for directory %d, %d entries, %d buckets",
+		dir->obj_id, index->n_entries, index->n_buckets);
+
+	return 1;
+}
+
+static struct yaffs_obj *yaffs_dir_index_find(struct yaffs_obj *dir,
+					      const YCHAR *name,
+					      YCHAR *buffer)
+{
+	struct yaffs_dir_index *index = dir->variant.dir_variant.index;
+	struct list_head *lh;
+	struct list_head *n;
+	struct yaffs_obj *l;
+	u32 hash;
+
+	/* Resolve the names of objects added since the last lookup */
+	list_for_each_safe(lh, n, &index->pending) {
+		l = list_entry(lh, struct yaffs_obj, name_link);
+		yaffs_obj_name_hash(l, buffer);
+		list_del(&l->name_link);
+		yaffs_dir_index_insert(index, l);
+	}
+
+	hash = yaffs_calc_name_hash(name);
+
+	list_for_each(lh, &index->buckets[hash & (index->n_buckets - 1)]) {
+		l = list_entry(lh, struct yaffs_obj, name_link);
+
+		if (l->name_hash != hash)
+			continue;
+
+		yaffs_get_obj_name(l, buffer, YAFFS_MAX_NAME_LENGTH + 1);
+		if (!strncmp(name, buffer, YAFFS_MAX_NAME_LENGTH))
+			return l;
+	}
+	return NULL;
+}
 
 void yaffs_set_obj_name(struct yaffs_obj *obj, const YCHAR * name)
 {
@@ -665,6 +902,21 @@ void yaffs_set_obj_name(struct yaffs_obj *obj, const YCHAR * name)
 	}
 
 	obj->sum = yaffs_calc_name_sum(name);
+
+	/*
+	 * Hash the name yaffs_get_obj_name() reports.  A long name of an
+	 * object without a header yet is reported as objNNN until the header
+	 * is written, so leave that to the next lookup.
+	 */
+	if (obj->obj_id == YAFFS_OBJECTID_LOSTNFOUND)
+		name = YAFFS_LOSTNFOUND_NAME;
+	else if (!obj->short_name[0] && obj->hdr_chunk <= 0)
+		name = NULL;
+
+	obj->name_hashed = name ? 1 : 0;
+	if (name)
+		obj->name_hash = yaffs_calc_name_hash(name);
+	yaffs_dir_index_rehash(obj);
 }
 
 void yaffs_set_obj_name_from_oh(struct yaffs_obj *obj,
@@ -1185,6 +1437,7 @@ static void yaffs_soft_del_chunk(struct yaffs_dev *dev, int chunk)
 		the_block->soft_del_pages++;
 		dev->n_free_chunks++;
 		yaffs2_update_oldest_dirty_seq(dev, block_no, the_block);
+		yaffs_gc_index_update(dev, block_no, the_block);
 	}
 }
 
@@ -1255,6 +1508,7 @@ static void yaffs_remove_obj_from_dir(struct yaffs_obj *obj)
 	if (dev && dev->param.remove_obj_fn)
 		dev->param.remove_obj_fn(obj);
 
+	yaffs_dir_index_remove(obj);
 	list_del_init(&obj->siblings);
 	obj->parent = NULL;
 
@@ -1289,6 +1543,7 @@ void yaffs_add_obj_to_dir(struct yaffs_obj *directory, struct yaffs_obj *obj)
 	/* Now add it */
 	list_add(&obj->siblings, &directory->variant.dir_variant.children);
 	obj->parent = directory;
+	yaffs_dir_index_add(directory, obj);
 
 	if (directory == obj->my_dev->unlinked_dir
 	    || directory == obj->my_dev->del_dir) {
@@ -1631,6 +1886,9 @@ static void yaffs_free_obj(struct yaffs_obj *obj)
 		return;
 	}
 
+	if (obj->variant_type == YAFFS_OBJECT_TYPE_DIRECTORY)
+		yaffs_dir_index_free(obj);
+
 	yaffs_unhash_obj(obj);
 
 	yaffs_free_raw_obj(dev, obj);
@@ -1812,12 +2070,14 @@ static struct yaffs_obj *yaffs_alloc_empty_obj(struct yaffs_dev *dev)
 	INIT_LIST_HEAD(&(obj->hard_links));
 	INIT_LIST_HEAD(&(obj->hash_link));
 	INIT_LIST_HEAD(&obj->siblings);
+	INIT_LIST_HEAD(&obj->name_link);
 
 	/* Now make the directory sane */
 	if (dev->root_dir) {
 		obj->parent = dev->root_dir;
 		list_add(&(obj->siblings),
 			 &dev->root_dir->variant.dir_variant.children);
+		yaffs_dir_index_add(dev->root_dir, obj);
 	}
 
 	/* Add it to the lost and found directory.
@@ -2237,6 +2497,117 @@ struct yaffs_obj *yaffs_link_obj(struct yaffs_obj *parent, const YCHAR * name,
 
 /*---------------------- Block Management and Page Allocation -------------*/
 
+/*
+ * GC victim index.
+ * Keeps FULL blocks on lists by their number of live chunks. Callers
+ * that change a block's state, pages_in_use or soft_del_pages call
+ * yaffs_gc_index_update() to move the block to the right list. Places
+ * that don't (eg. scanning) are covered by yaffs_gc_index_rebuild() and
+ * by the check made when a block is picked off a list.
+ */
+static void yaffs_gc_index_update(struct yaffs_dev *dev, int block_no,
+				  struct yaffs_block_info *bi)
+{
+	struct yaffs_gc_node *nodes = dev->gc_nodes;
+	struct yaffs_gc_node *node;
+	int base = dev->internal_start_block;
+	int bucket = -1;
+
+	if (!nodes)
+		return;
+
+	node = &nodes[block_no - base];
+
+	if (bi->block_state == YAFFS_BLOCK_STATE_FULL) {
+		bucket = bi->pages_in_use - bi->soft_del_pages;
+		if (bucket < 0)
+			bucket = 0;
+		if (bucket > dev->param.chunks_per_block)
+			bucket = dev->param.chunks_per_block;
+	}
+
+	if (bucket == node->bucket)
+		return;
+
+	if (node->bucket >= 0) {
+		if (node->prev >= 0)
+			nodes[node->prev - base].next = node->next;
+		else
+			dev->gc_heads[node->bucket] = node->next;
+		if (node->next >= 0)
+			nodes[node->next - base].prev = node->prev;
+	}
+
+	node->bucket = bucket;
+
+	if (bucket >= 0) {
+		node->prev = -1;
+		node->next = dev->gc_heads[bucket];
+		if (node->next >= 0)
+			nodes[node->next - base].prev = block_no;
+		dev->gc_heads[bucket] = block_no;
+	}
+}
+
+static void yaffs_gc_index_rebuild(struct yaffs_dev *dev)
+{
+	struct yaffs_block_info *bi;
+	int i;
+
+	if (!dev->gc_nodes)
+		return;
+
+	for (i = 0; i <= dev->param.chunks_per_block; i++)
+		dev->gc_heads[i] = -1;
+
+	for (i = dev->internal_start_block; i <= dev->internal_end_block; i++)
+		dev->gc_nodes[i - dev->internal_start_block].bucket = -1;
+
+	bi = dev->block_info;
+	for (i = dev->internal_start_block; i <= dev->internal_end_block; i++)
+		yaffs_gc_index_update(dev, i, bi++);
+}
+
+/*
+ * Pick the dirtiest FULL block with at most max_live live chunks that
+ * may be collected, looking at no more than max_blocks candidates.
+ */
+static unsigned yaffs_gc_index_select(struct yaffs_dev *dev, int max_live,
+				      int max_blocks, int *live)
+{
+	struct yaffs_block_info *bi;
+	int bucket;
+	int blk;
+	int next;
+
+	if (max_live >= dev->param.chunks_per_block)
+		max_live = dev->param.chunks_per_block - 1;
+
+	for (bucket = 0; bucket <= max_live && max_blocks > 0; bucket++) {
+		for (blk = dev->gc_heads[bucket];
+		     blk >= 0 && max_blocks > 0;
+		     blk = next) {
+			next = dev->gc_nodes[blk -
+					dev->internal_start_block].next;
+			bi = yaffs_get_block_info(dev, blk);
+			max_blocks--;
+			dev->gc_select_blocks++;
+
+			/* Re-file the block if it was missed by an update */
+			yaffs_gc_index_update(dev, blk, bi);
+
+			if (dev->gc_nodes[blk -
+				dev->internal_start_block].bucket == bucket &&
+			    yaffs_block_ok_for_gc(dev, bi)) {
+				*live = bucket;
+				return blk;
+			}
+		}
+	}
+
+	return 0;
+}
+
 static void yaffs_deinit_blocks(struct yaffs_dev *dev)
 {
 	if (dev->block_info_alt && dev->block_info)
@@ -2254,6 +2625,16 @@ static void yaffs_deinit_blocks(struct yaffs_dev *dev)
 		kfree(dev->chunk_bits);
 	dev->chunk_bits_alt = 0;
 	dev->chunk_bits = NULL;
+
+	if (dev->gc_nodes_alt && dev->gc_nodes)
+		vfree(dev->gc_nodes);
+	else
+		kfree(dev->gc_nodes);
+	dev->gc_nodes_alt = 0;
+	dev->gc_nodes = NULL;
+
+	kfree(dev->gc_heads);
+	dev->gc_heads = NULL;
 }
 
 static int yaffs_init_blocks(struct yaffs_dev *dev)
@@ -2292,9 +2673,37 @@ static int yaffs_init_blocks(struct yaffs_dev *dev)
 	if (!dev->chunk_bits)
 		goto alloc_error;
 
+	if (dev->param.gc_index) {
+		dev->gc_nodes =
+			kmalloc(n_blocks * sizeof(struct yaffs_gc_node),
+				GFP_NOFS);
+		if (!dev->gc_nodes) {
+			dev->gc_nodes =
+			    vmalloc(n_blocks * sizeof(struct yaffs_gc_node));
+			dev->gc_nodes_alt = 1;
+		} else {
+			dev->gc_nodes_alt = 0;
+		}
+		dev->gc_heads = kmalloc((dev->param.chunks_per_block + 1) *
+					sizeof(int), GFP_NOFS);
+
+		/* The index is only an optimisation, do without if need be */
+		if (!dev->gc_nodes || !dev->gc_heads) {
+			if (dev->gc_nodes_alt)
+				vfree(dev->gc_nodes);
+			else
+				kfree(dev->gc_nodes);
+			kfree(dev->gc_heads);
+			dev->gc_nodes = NULL;
+			dev->gc_heads = NULL;
+			dev->gc_nodes_alt = 0;
+		}
+	}
+
 
 	memset(dev->block_info, 0, n_blocks * sizeof(struct yaffs_block_info));
 	memset(dev->chunk_bits, 0, dev->chunk_bit_stride * n_blocks);
+	yaffs_gc_index_rebuild(dev);
 	return YAFFS_OK;
 
 alloc_error:
@@ -2321,6 +2730,7 @@ void yaffs_block_became_dirty(struct yaffs_dev *dev, int block_no)
 	yaffs2_clear_oldest_dirty_seq(dev, bi);
 
 	bi->block_state = YAFFS_BLOCK_STATE_DIRTY;
+	yaffs_gc_index_update(dev, block_no, bi);
 
 	/* If this is the block being garbage collected then stop gc'ing */
 	if (block_no == dev->gc_block)
@@ -2546,8 +2956,10 @@ static int yaffs_gc_block(struct yaffs_dev *dev, int block, int whole_block)
 
 	/*yaffs_verify_free_chunks(dev); */
 
-	if (bi->block_state == YAFFS_BLOCK_STATE_FULL)
+	if (bi->block_state == YAFFS_BLOCK_STATE_FULL) {
 		bi->block_state = YAFFS_BLOCK_STATE_COLLECTING;
+		yaffs_gc_index_update(dev, block, bi);
+	}
 
 	bi->has_shrink_hdr = 0;	/* clear the flag so that the block can erase */
 
@@ -2593,6 +3005,7 @@ static int yaffs_gc_block(struct yaffs_dev *dev, int block, int whole_block)
 		 * because checkpointing does not restore gc.
 		 */
 		bi->block_state = YAFFS_BLOCK_STATE_FULL;
+		yaffs_gc_index_update(dev, block, bi);
 	} else {
 		/* The gc completed. */
 		/* Do any required cleanups */
@@ -2710,6 +3123,16 @@ static unsigned yaffs_find_gc_block(struct yaffs_dev *dev,
 				iterations = 100;
 		}
 
+		if (dev->gc_nodes) {
+			dev->gc_dirtiest = yaffs_gc_index_select(dev,
+					threshold,
+					aggressive ? n_blocks : iterations,
+					&pages_used);
+			if (dev->gc_dirtiest)
+				dev->gc_pages_in_use = pages_used;
+			iterations = 0;
+		}
+
 		for (i = 0;
 		     i < iterations &&
 		     (dev->gc_dirtiest < 1 ||
@@ -2734,6 +3157,7 @@ static unsigned yaffs_find_gc_block(struct yaffs_dev *dev,
 				dev->gc_pages_in_use = pages_used;
 			}
 		}
+		dev->gc_select_blocks += i;
 
 		if (dev->gc_dirtiest > 0 && dev->gc_pages_in_use <= threshold)
 			selected = dev->gc_dirtiest;
@@ -2857,10 +3281,14 @@ static int yaffs_check_gc(struct yaffs_dev *dev, int background)
 			dev->n_clean_ups = 0;
 		}
 		if (dev->gc_block < 1) {
+			u64 start = Y_CLOCK_NS();
+
 			dev->gc_block =
 			    yaffs_find_gc_block(dev, aggressive, background);
 			dev->gc_chunk = 0;
 			dev->n_clean_ups = 0;
+			dev->gc_select_ns += Y_CLOCK_NS() - start;
+			dev->gc_select_calls++;
 		}
 
 		if (dev->gc_block > 0) {
@@ -2971,6 +3399,7 @@ void yaffs_chunk_del(struct yaffs_dev *dev, int chunk_id, int mark_flash,
 		dev->n_free_chunks++;
 		yaffs_clear_chunk_bit(dev, block, page);
 		bi->pages_in_use--;
+		yaffs_gc_index_update(dev, block, bi);
 
 		if (bi->pages_in_use == 0 &&
 		    !bi->has_shrink_hdr &&
@@ -4343,6 +4772,10 @@ struct yaffs_obj *yaffs_find_by_name(struct yaffs_obj *directory,
 		BUG();
 	}
 
+	if (directory->my_dev->param.dir_index &&
+	    yaffs_dir_index_build(directory, buffer))
+		return yaffs_dir_index_find(directory, name, buffer);
+
 	sum = yaffs_calc_name_sum(name);
 
 	list_for_each(i, &directory->variant.dir_variant.children) {
@@ -4914,6 +5347,8 @@ int yaffs_guts_initialise(struct yaffs_dev *dev)
 		yaffs_fix_hanging_objs(dev);
 		if (dev->param.empty_lost_n_found)
 			yaffs_empty_l_n_f(dev);
+
+		yaffs_gc_index_rebuild(dev);
 	}
 
 	if (init_failed) {
@@ -4952,6 +5387,7 @@ void yaffs_deinitialise(struct yaffs_dev *dev)
 		int i;
 
 		yaffs_deinit_blocks(dev);
+		yaffs_dir_index_free_all(dev);
 		yaffs_deinit_tnodes_and_objs(dev);
 		yaffs_summary_deinit(dev);
 
@@ -91,6 +91,10 @@
 
 #define YAFFS_SHORT_NAME_LENGTH		15
 
+/* Directories with at least this many children get a name index */
+#define YAFFS_DIR_INDEX_MIN		32
+#define YAFFS_DIR_INDEX_MAX_BUCKETS	4096
+
 /* Some special object ids for pseudo objects */
 #define YAFFS_OBJECTID_ROOT		1
 #define YAFFS_OBJECTID_LOSTNFOUND	2
@@ -306,6 +310,17 @@ struct yaffs_block_info {
 
 };
 
+/*
+ * Entry of the optional gc victim index. FULL blocks are kept on doubly
+ * linked lists, one per count of live (in use, not soft deleted) chunks,
+ * so the dirtiest block can be found without walking the block array.
+ */
+struct yaffs_gc_node {
+	int next;
+	int prev;
+	int bucket;		/* -1 when the block is not indexed */
+};
+
 /* -------------------------- Object structure -------------------------------*/
 /* This is the object structure as stored on NAND */
 
@@ -376,9 +391,23 @@ struct yaffs_file_var {
 	struct yaffs_tnode *top;
 };
 
+/*
+ * Optional name index of a large directory.
+ * Children are hashed by their full name, children whose name is not known
+ * yet are kept on the pending list until the next lookup.
+ */
+struct yaffs_dir_index {
+	u32 n_buckets;		/* power of 2 */
+	u32 n_entries;
+	struct list_head pending;
+	struct list_head buckets[0];
+};
+
 struct yaffs_dir_var {
 	struct list_head children;	/* list of child links */
 	struct list_head dirty;	/* Entry for list of dirty directories */
+	struct yaffs_dir_index *index;	/* name index, built on demand */
+	int index_small;	/* too few children for an index, until one is added */
 };
 
 struct yaffs_symlink_var {
@@ -428,9 +457,11 @@ struct yaffs_obj {
 				 * or not. */
 	u8 has_xattr:1;		/* This object has xattribs.
 				 * Only valid if xattr_known. */
+	u8 name_hashed:1;	/* name_hash is valid */
 
 	u8 serial;		/* serial number of chunk in NAND.*/
 	u16 sum;		/* sum of the name to speed searching */
+	u32 name_hash;		/* full name hash for the directory index */
 
 	struct yaffs_dev *my_dev;	/* The device I'm on */
 
@@ -442,6 +473,7 @@ struct yaffs_obj {
 	/* also used for linking up the free list */
 	struct yaffs_obj *parent;
 	struct list_head siblings;
+	struct list_head name_link;	/* entry in the parent's name index */
 
 	/* Where's my object header in NAND? */
 	int hdr_chunk;
@@ -594,6 +626,10 @@ struct yaffs_param {
 	int disable_summary;
 	int disable_bad_block_marking;
 
+	int dir_index;		/* Index large directories by name hash */
+	int batch_scan;		/* Read a whole block's tags at once on scan */
+	int gc_index;		/* Index full blocks by dirtiness for gc */
+
 };
 
 struct yaffs_driver {
@@ -604,6 +640,12 @@ struct yaffs_driver {
 				   u8 *data, int data_len,
 				   u8 *oob, int oob_len,
 				   enum yaffs_ecc_result *ecc_result);
+	/* Optional: read oob_len bytes of oob from each of n_chunks
+	 * consecutive chunks, packed back to back into oob.
+	 */
+	int (*drv_read_oob_fn) (struct yaffs_dev *dev, int nand_chunk,
+				int n_chunks, u8 *oob, int oob_len,
+				enum yaffs_ecc_result *ecc_result);
 	int (*drv_erase_fn) (struct yaffs_dev *dev, int block_no);
 	int (*drv_mark_bad_fn) (struct yaffs_dev *dev, int block_no);
 	int (*drv_check_bad_fn) (struct yaffs_dev *dev, int block_no);
@@ -618,6 +660,9 @@ struct yaffs_tags_handler {
 	int (*read_chunk_tags_fn) (struct yaffs_dev *dev,
 				   int nand_chunk, u8 *data,
 				   struct yaffs_ext_tags *tags);
+	int (*read_multi_tags_fn) (struct yaffs_dev *dev,
+				   int nand_chunk, int n_chunks,
+				   struct yaffs_ext_tags *tags);
 
 	int (*query_block_fn) (struct yaffs_dev *dev, int block_no,
 			       enum yaffs_block_state *state,
@@ -693,6 +738,9 @@ struct yaffs_dev {
 	int chunk_bit_stride;	/* Number of bytes of chunk_bits per block.
 				 * Must be consistent with chunks_per_block.
 				 */
+	struct yaffs_gc_node *gc_nodes;	/* gc index entry of each block */
+	int *gc_heads;		/* gc index list heads by live chunks */
+	unsigned gc_nodes_alt:1;	/* allocated using alternative alloc */
 
 	int n_erased_blocks;
 	int alloc_block;	/* Current block being allocated off */
@@ -796,6 +844,10 @@ struct yaffs_dev {
 	u32 cache_hits;
 	u32 tags_used;
 	u32 summary_used;
+	u32 batch_reads;
+	u32 gc_select_calls;
+	u32 gc_select_blocks;	/* block infos looked at while selecting */
+	u64 gc_select_ns;
 
 };
 
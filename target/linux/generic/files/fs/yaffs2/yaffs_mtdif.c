@@ -168,6 +168,68 @@ static int yaffs_mtd_read(struct yaffs_dev *dev, int nand_chunk,
 	return YAFFS_OK;
 }
 
+static int yaffs_mtd_read_oob(struct yaffs_dev *dev, int nand_chunk,
+			      int n_chunks, u8 *oob, int oob_len,
+			      enum yaffs_ecc_result *ecc_result)
+{
+	struct mtd_info *mtd = yaffs_dev_to_mtd(dev);
+	loff_t addr;
+	struct mtd_oob_ops ops;
+	u8 *buf = oob;
+	int avail = mtd->oobavail;
+	int retval;
+	int i;
+
+	if (oob_len > avail)
+		return YAFFS_FAIL;
+
+	/* MTD returns all of the free oob of each page, so read into a
+	 * bounce buffer when the caller wants less than that.
+	 */
+	if (oob_len < avail) {
+		buf = kmalloc(n_chunks * avail, GFP_NOFS);
+		if (!buf)
+			return YAFFS_FAIL;
+	}
+
+	addr = ((loff_t) nand_chunk) * dev->param.total_bytes_per_chunk;
+	memset(&ops, 0, sizeof(ops));
+	ops.mode = MTD_OPS_AUTO_OOB;
+	ops.len = 0;
+	ops.ooblen = n_chunks * avail;
+	ops.datbuf = NULL;
+	ops.oobbuf = buf;
+
+#if (MTD_VERSION_CODE < MTD_VERSION(2, 6, 20))
+	ops.len = ops.ooblen;
+#endif
+	retval = mtd_read_oob(mtd, addr, &ops);
+	if (retval)
+		yaffs_trace(YAFFS_TRACE_MTD,
+			"read_oob failed, chunk %d count %d, mtd error %d",
+			nand_chunk, n_chunks, retval);
+
+	if (buf != oob) {
+		for (i = 0; i < n_chunks; i++)
+			memcpy(oob + i * oob_len, buf + i * avail, oob_len);
+		kfree(buf);
+	}
+
+	switch (retval) {
+	case 0:
+		*ecc_result = YAFFS_ECC_RESULT_NO_ERROR;
+		break;
+	case -EUCLEAN:
+		*ecc_result = YAFFS_ECC_RESULT_FIXED;
+		break;
+	default:
+		*ecc_result = YAFFS_ECC_RESULT_UNFIXED;
+		return YAFFS_FAIL;
+	}
+
+	return YAFFS_OK;
+}
+
 static 	int yaffs_mtd_erase(struct yaffs_dev *dev, int block_no)
 {
 	struct mtd_info *mtd = yaffs_dev_to_mtd(dev);
@@ -238,6 +300,7 @@ void yaffs_mtd_drv_install(struct yaffs_dev *dev)
 
 	drv->drv_write_chunk_fn = yaffs_mtd_write;
 	drv->drv_read_chunk_fn = yaffs_mtd_read;
+	drv->drv_read_oob_fn = yaffs_mtd_read_oob;
 	drv->drv_erase_fn = yaffs_mtd_erase;
 	drv->drv_mark_bad_fn = yaffs_mtd_mark_bad;
 	drv->drv_check_bad_fn = yaffs_mtd_check_bad;
@@ -47,6 +47,28 @@ int yaffs_rd_chunk_tags_nand(struct yaffs_dev *dev, int nand_chunk,
 	return result;
 }
 
+/*
+ * Read the tags of n_chunks consecutive chunks in one driver call.
+ * Fails if the driver can't do that or if any of the chunks needs ECC
+ * attention; the caller then falls back to reading chunk by chunk so
+ * that errors get handled as usual.
+ */
+int yaffs_rd_multi_tags_nand(struct yaffs_dev *dev, int nand_chunk,
+			      int n_chunks, struct yaffs_ext_tags *tags)
+{
+	int result;
+	int flash_chunk = apply_chunk_offset(dev, nand_chunk);
+
+	if (!dev->tagger.read_multi_tags_fn)
+		return YAFFS_FAIL;
+
+	result = dev->tagger.read_multi_tags_fn(dev, flash_chunk,
+						n_chunks, tags);
+	if (result == YAFFS_OK)
+		dev->n_page_reads += n_chunks;
+	return result;
+}
+
 int yaffs_wr_chunk_tags_nand(struct yaffs_dev *dev,
 				int nand_chunk,
 				const u8 *buffer, struct yaffs_ext_tags *tags)
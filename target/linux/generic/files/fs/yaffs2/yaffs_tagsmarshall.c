@@ -130,6 +130,63 @@ static int yaffs_tags_marshall_read(struct yaffs_dev *dev,
 		return YAFFS_FAIL;
 }
 
+static int yaffs_tags_marshall_read_multi(struct yaffs_dev *dev,
+				   int nand_chunk, int n_chunks,
+				   struct yaffs_ext_tags *tags)
+{
+	int retval = YAFFS_OK;
+	u8 *buffer;
+	int per_read;
+	int n;
+	int i;
+	enum yaffs_ecc_result ecc_result;
+
+	struct yaffs_packed_tags2 pt;
+
+	int packed_tags_size =
+	    dev->param.no_tags_ecc ? sizeof(pt.t) : sizeof(pt);
+	void *packed_tags_ptr =
+	    dev->param.no_tags_ecc ? (void *)&pt.t : (void *)&pt;
+
+	yaffs_trace(YAFFS_TRACE_MTD,
+		"yaffs_tags_marshall_read_multi chunk %d count %d",
+		nand_chunk, n_chunks);
+
+	if (dev->param.inband_tags || !dev->drv.drv_read_oob_fn)
+		return YAFFS_FAIL;
+
+	buffer = yaffs_get_temp_buffer(dev);
+	per_read = dev->param.total_bytes_per_chunk / packed_tags_size;
+
+	while (retval == YAFFS_OK && n_chunks > 0) {
+		n = (n_chunks < per_read) ? n_chunks : per_read;
+
+		ecc_result = YAFFS_ECC_RESULT_NO_ERROR;
+		retval = dev->drv.drv_read_oob_fn(dev, nand_chunk, n,
+					buffer, packed_tags_size,
+					&ecc_result);
+
+		/* Any ECC activity is left to the single chunk path. */
+		if (ecc_result != YAFFS_ECC_RESULT_NO_ERROR)
+			retval = YAFFS_FAIL;
+
+		for (i = 0; retval == YAFFS_OK && i < n; i++, tags++) {
+			memcpy(packed_tags_ptr, buffer + i * packed_tags_size,
+				packed_tags_size);
+			yaffs_unpack_tags2(tags, &pt, !dev->param.no_tags_ecc);
+			if (tags->ecc_result > YAFFS_ECC_RESULT_NO_ERROR)
+				retval = YAFFS_FAIL;
+		}
+
+		nand_chunk += n;
+		n_chunks -= n;
+	}
+
+	yaffs_release_temp_buffer(dev, buffer);
+
+	return retval;
+}
+
 static int yaffs_tags_marshall_query_block(struct yaffs_dev *dev, int block_no,
 			       enum yaffs_block_state *state,
 			       u32 *seq_number)
@@ -190,6 +247,9 @@ void yaffs_tags_marshall_install(struct yaffs_dev *dev)
 	if (!dev->tagger.read_chunk_tags_fn)
 		dev->tagger.read_chunk_tags_fn = yaffs_tags_marshall_read;
 
+	if (!dev->tagger.read_multi_tags_fn)
+		dev->tagger.read_multi_tags_fn = yaffs_tags_marshall_read_multi;
+
 	if (!dev->tagger.query_block_fn)
 		dev->tagger.query_block_fn = yaffs_tags_marshall_query_block;
 
@@ -2508,6 +2508,9 @@ struct yaffs_options {
 	int empty_lost_and_found;
 	int empty_lost_and_found_overridden;
 	int disable_summary;
+	int dir_index;
+	int batch_scan;
+	int gc_index;
 };
 
 #define MAX_OPT_LEN 30
@@ -2557,6 +2560,18 @@ static int yaffs_parse_options(struct yaffs_options *options,
 		} else if (!strcmp(cur_opt, "empty-lost-and-found-on")) {
 			options->empty_lost_and_found = 1;
 			options->empty_lost_and_found_overridden = 1;
+		} else if (!strcmp(cur_opt, "dir-index-on")) {
+			options->dir_index = 1;
+		} else if (!strcmp(cur_opt, "dir-index-off")) {
+			options->dir_index = 0;
+		} else if (!strcmp(cur_opt, "batch-scan-on")) {
+			options->batch_scan = 1;
+		} else if (!strcmp(cur_opt, "batch-scan-off")) {
+			options->batch_scan = 0;
+		} else if (!strcmp(cur_opt, "gc-index-on")) {
+			options->gc_index = 1;
+		} else if (!strcmp(cur_opt, "gc-index-off")) {
+			options->gc_index = 0;
 		} else if (!strcmp(cur_opt, "no-cache")) {
 			options->no_cache = 1;
 		} else if (!strcmp(cur_opt, "no-checkpoint-read")) {
@@ -2768,6 +2783,9 @@ static struct super_block *yaffs_internal_read_super(int yaffs_version,
 	param->empty_lost_n_found = 1;
 	param->refresh_period = 500;
 	param->disable_summary = options.disable_summary;
+	param->dir_index = options.dir_index;
+	param->batch_scan = options.batch_scan;
+	param->gc_index = options.gc_index;
 
 
 #ifdef CONFIG_YAFFS_DISABLE_BAD_BLOCK_MARKING
@@ -3021,6 +3039,9 @@ static char *yaffs_dump_dev_part0(char *buf, struct yaffs_dev *dev)
 				param->disable_lazy_load);
 	buf += sprintf(buf, "disable_bad_block_mrk %d\n",
 				param->disable_bad_block_marking);
+	buf += sprintf(buf, "dir_index............ %d\n", param->dir_index);
+	buf += sprintf(buf, "batch_scan........... %d\n", param->batch_scan);
+	buf += sprintf(buf, "gc_index............. %d\n", param->gc_index);
 	buf += sprintf(buf, "refresh_period....... %d\n",
 				param->refresh_period);
 	buf += sprintf(buf, "n_caches............. %d\n", param->n_caches);
@@ -3065,6 +3086,12 @@ static char *yaffs_dump_dev_part1(char *buf, struct yaffs_dev *dev)
 				dev->oldest_dirty_gc_count);
 	buf += sprintf(buf, "n_gc_blocks.......... %u\n", dev->n_gc_blocks);
 	buf += sprintf(buf, "bg_gcs............... %u\n", dev->bg_gcs);
+	buf += sprintf(buf, "gc_select_calls...... %u\n",
+				dev->gc_select_calls);
+	buf += sprintf(buf, "gc_select_blocks..... %u\n",
+				dev->gc_select_blocks);
+	buf += sprintf(buf, "gc_select_ns......... %llu\n",
+				(unsigned long long)dev->gc_select_ns);
 	buf += sprintf(buf, "n_retried_writes..... %u\n",
 				dev->n_retried_writes);
 	buf += sprintf(buf, "n_retired_blocks..... %u\n",
@@ -3083,6 +3110,7 @@ static char *yaffs_dump_dev_part1(char *buf, struct yaffs_dev *dev)
 	buf += sprintf(buf, "n_bg_deletions....... %u\n", dev->n_bg_deletions);
 	buf += sprintf(buf, "tags_used............ %u\n", dev->tags_used);
 	buf += sprintf(buf, "summary_used......... %u\n", dev->summary_used);
+	buf += sprintf(buf, "batch_reads.......... %u\n", dev->batch_reads);
 
 	return buf;
 }
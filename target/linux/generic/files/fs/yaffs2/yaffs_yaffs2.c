@@ -936,7 +936,8 @@ static inline int yaffs2_scan_chunk(struct yaffs_dev *dev,
 		int *found_chunks,
 		u8 *chunk_data,
 		struct list_head *hard_list,
-		int summary_available)
+		int summary_available,
+		struct yaffs_ext_tags *batch_tags)
 {
 	struct yaffs_obj_hdr *oh;
 	struct yaffs_obj *in;
@@ -958,7 +959,11 @@ static inline int yaffs2_scan_chunk(struct yaffs_dev *dev,
 		tags.seq_number = bi->seq_number;
 	}
 
-	if (!summary_available || tags.obj_id == 0) {
+	if (batch_tags) {
+		tags = *batch_tags;
+		result = YAFFS_OK;
+		dev->tags_used++;
+	} else if (!summary_available || tags.obj_id == 0) {
 		result = yaffs_rd_chunk_tags_nand(dev, chunk, NULL, &tags);
 		dev->tags_used++;
 	} else {
@@ -1360,6 +1365,8 @@ int yaffs2_scan_backwards(struct yaffs_dev *dev)
 	struct yaffs_block_index *block_index = NULL;
 	int alt_block_index = 0;
 	int summary_available;
+	struct yaffs_ext_tags *block_tags = NULL;
+	int tags_batched;
 
 	yaffs_trace(YAFFS_TRACE_SCAN,
 		"yaffs2_scan_backwards starts  intstartblk %d intendblk %d...",
@@ -1387,6 +1394,14 @@ int yaffs2_scan_backwards(struct yaffs_dev *dev)
 
 	chunk_data = yaffs_get_temp_buffer(dev);
 
+	/* Room for the tags of a whole block so that blocks without a
+	 * summary can have their tags read with one driver request instead
+	 * of one per chunk. Without it we just scan chunk by chunk.
+	 */
+	if (dev->param.batch_scan && !dev->param.inband_tags)
+		block_tags = kmalloc(dev->param.chunks_per_block *
+				     sizeof(struct yaffs_ext_tags), GFP_NOFS);
+
 	/* Scan all the blocks to determine their state */
 	bi = dev->block_info;
 	for (blk = dev->internal_start_block; blk <= dev->internal_end_block;
@@ -1471,6 +1486,16 @@ int yaffs2_scan_backwards(struct yaffs_dev *dev)
 
 		summary_available = yaffs_summary_read(dev, dev->sum_tags, blk);
 
+		tags_batched = 0;
+		if (!summary_available && block_tags &&
+		    yaffs_rd_multi_tags_nand(dev,
+				blk * dev->param.chunks_per_block,
+				dev->param.chunks_per_block,
+				block_tags) == YAFFS_OK) {
+			tags_batched = 1;
+			dev->batch_reads++;
+		}
+
 		/* For each chunk in each block that needs scanning.... */
 		found_chunks = 0;
 		if (summary_available)
@@ -1488,7 +1513,8 @@ int yaffs2_scan_backwards(struct yaffs_dev *dev)
 			 */
 			if (yaffs2_scan_chunk(dev, bi, blk, c,
 					&found_chunks, chunk_data,
-					&hard_list, summary_available) ==
+					&hard_list, summary_available,
+					tags_batched ? &block_tags[c] : NULL) ==
 					YAFFS_FAIL)
 				alloc_failed = 1;
 		}
@@ -1509,6 +1535,8 @@ int yaffs2_scan_backwards(struct yaffs_dev *dev)
 
 	yaffs_skip_rest_of_block(dev);
 
+	kfree(block_tags);
+
 	if (alt_block_index)
 		vfree(block_index);
 	else
@@ -28,6 +28,7 @@ struct switch_led_trigger;
 
 int register_switch(struct switch_dev *dev, struct net_device *netdev);
 void unregister_switch(struct switch_dev *dev);
+void switch_port_link_changed(struct switch_dev *dev, int port);
 
 /**
  * struct switch_attrlist - attribute list
@@ -78,6 +79,9 @@ struct switch_port_stats {
  *
  * @apply_config: apply all changed settings to the switch
  * @reset_switch: resetting the switch
+ *
+ * @get_port_link: read the link state of a port
+ * @get_port_stats: read the traffic counters of a port
  */
 struct switch_dev_ops {
 	struct switch_attrlist attr_global, attr_port, attr_vlan;
@@ -112,6 +116,9 @@ struct switch_dev {
 	int vlans;
 	int cpu_port;
 
+	/* link changes are reported with switch_port_link_changed() */
+	bool link_notify;
+
 	/* the following fields are internal for swconfig */
 	int id;
 	struct list_head dev_list;
@@ -143,6 +150,7 @@ struct switch_val {
 	int port_vlan;
 	int len;
 	union {
+		/* also used for SWITCH_TYPE_BINARY, with len bytes */
 		const char *s;
 		u32 i;
 		struct switch_port *ports;
@@ -53,6 +53,7 @@ enum {
 	SWITCH_ATTR_OP_DESCRIPTION,
 	/* port lists */
 	SWITCH_ATTR_PORT,
+	SWITCH_ATTR_OP_VALUE_BINARY,
 	SWITCH_ATTR_MAX
 };
 
@@ -77,7 +78,8 @@ enum {
 	SWITCH_CMD_SET_PORT,
 	SWITCH_CMD_LIST_VLAN,
 	SWITCH_CMD_GET_VLAN,
-	SWITCH_CMD_SET_VLAN
+	SWITCH_CMD_SET_VLAN,
+	SWITCH_CMD_DUMP_ATTRS
 };
 
 /* data types */
@@ -87,6 +89,7 @@ enum switch_val_type {
 	SWITCH_TYPE_STRING,
 	SWITCH_TYPE_PORTS,
 	SWITCH_TYPE_NOVAL,
+	SWITCH_TYPE_BINARY,
 };
 
 /* port nested attributes */
@@ -79,29 +79,28 @@ static __inline__ void blast_dcache(unsigned long size, unsigned long lsize)
 }
 
 unsigned char *data;
+extern char lzma_start[];
+extern char lzma_end[];
 
+/* the whole stream is linked into the image, so hand the rest of it to
+ * the decoder in one go instead of refilling the buffer byte by byte */
 static int read_byte(void *object, unsigned char **buffer, UInt32 *bufferSize)
 {
-	*bufferSize = 1;
+	*bufferSize = (unsigned char *) lzma_end - data;
 	*buffer = data;
-	++data;
+	data += *bufferSize;
 	return LZMA_RESULT_OK;
 }
 
 static __inline__ unsigned char get_byte(void)
 {
-	unsigned char *buffer;
-	UInt32 fake;
-	
-	return read_byte(0, &buffer, &fake), *buffer;
+	return *data++;
 }
 
 /* This puts lzma workspace 128k below RAM end. 
  * That should be enough for both lzma and stack
  */
 static char *buffer = (char *)(RAMSTART + RAMSIZE - 0x00020000);
-extern char lzma_start[];
-extern char lzma_end[];
 
 /* should be the first function */
 void entry(unsigned long icache_size, unsigned long icache_lsize, 
@@ -121,7 +120,7 @@ void entry(unsigned long icache_size, unsigned long icache_lsize,
 	CLzmaDecoderState vs;
 	callback.Read = read_byte;
 
-	data = lzma_start;
+	data = (unsigned char *) lzma_start;
 
 	/* lzma args */
 	i = get_byte();
@@ -0,0 +1,497 @@
+/*
+ * mib-sim - run the ar8216 MIB counter collection against a simulated switch
+ *
+ * Copyright (C) 2015 OpenWrt.org
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ *
+ * The MIB functions are taken unchanged from ar8216.c (see ../extract.awk)
+ * and built against a minimal set of kernel stand-ins.  Register accesses
+ * go to a simulated MDIO backend which keeps per port counters: a capture
+ * copies the running counters into the readable statistics registers and
+ * clears them, a flush clears both, and the MIB function register reports
+ * busy for a configurable number of reads.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef uint8_t u8;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+#define BIT(_n)			(1UL << (_n))
+#define ARRAY_SIZE(_a)		(sizeof(_a) / sizeof((_a)[0]))
+#define min(_a, _b)		((_a) < (_b) ? (_a) : (_b))
+#define container_of(_p, _t, _m) ((_t *)((char *)(_p) - offsetof(_t, _m)))
+
+#define msecs_to_jiffies(_m)	((unsigned long)(_m))
+#define time_before(_a, _b)	((long)((_a) - (_b)) < 0)
+
+static unsigned long jiffies = 100000;
+static int warnings;
+
+#define WARN_ON(_c)							\
+	((_c) ? (fprintf(stderr, "WARN_ON(%s)\n", #_c), warnings++, 1) : 0)
+
+struct mutex {
+	int locked;
+};
+
+static void mutex_lock(struct mutex *m)
+{
+	m->locked++;
+}
+
+static void mutex_unlock(struct mutex *m)
+{
+	m->locked--;
+}
+
+#define lockdep_assert_held(_m)	WARN_ON(!(_m)->locked)
+
+static void usleep_range(unsigned long min, unsigned long max)
+{
+}
+
+struct work_struct {
+	int pending;
+};
+
+struct delayed_work {
+	struct work_struct work;
+	unsigned long delay;
+};
+
+static bool schedule_delayed_work(struct delayed_work *dw, unsigned long delay)
+{
+	dw->work.pending = 1;
+	dw->delay = delay;
+	return true;
+}
+
+#include "ar8216.h"
+
+struct switch_dev {
+	int ports;
+};
+
+struct ar8xxx_chip {
+	unsigned long caps;
+	const struct ar8xxx_mib_desc *mib_decs;
+	unsigned num_mibs;
+};
+
+struct ar8xxx_priv {
+	struct switch_dev dev;
+
+	u32 (*read)(struct ar8xxx_priv *priv, int reg);
+	void (*write)(struct ar8xxx_priv *priv, int reg, u32 val);
+	u32 (*rmw)(struct ar8xxx_priv *priv, int reg, u32 mask, u32 val);
+
+	u8 chip_ver;
+	const struct ar8xxx_chip *chip;
+
+	struct mutex mib_lock;
+	struct delayed_work mib_work;
+	unsigned int mib_poll_interval;
+	unsigned int mib_idle;
+	unsigned long mib_updated;
+	u64 *mib_stats;
+};
+
+#include "mib-funcs.c"
+
+#define SIM_PORTS	7
+#define SIM_MIBS	64
+
+static struct sim {
+	struct ar8xxx_chip chip;
+	struct ar8xxx_priv priv;
+
+	u32 mib_func_reg;
+	u32 mib_func;
+	int busy_reads;		/* reads of the function register still busy */
+	int stuck;		/* busy never clears */
+
+	u64 live[SIM_PORTS][SIM_MIBS];
+	u64 captured[SIM_PORTS][SIM_MIBS];
+
+	unsigned int reads, captures, flushes;
+} sim;
+
+static u32 sim_stats_base(int port)
+{
+	switch (sim.priv.chip_ver) {
+	case AR8XXX_VER_AR8327:
+	case AR8XXX_VER_AR8337:
+		return AR8327_REG_PORT_STATS_BASE(port);
+	case AR8XXX_VER_AR8236:
+	case AR8XXX_VER_AR8316:
+		return AR8236_REG_PORT_STATS_BASE(port);
+	default:
+		return AR8216_REG_PORT_STATS_BASE(port);
+	}
+}
+
+static u32 sim_read(struct ar8xxx_priv *priv, int reg)
+{
+	const struct ar8xxx_mib_desc *mib;
+	int port, i;
+
+	sim.reads++;
+
+	if (reg == sim.mib_func_reg) {
+		if (sim.stuck || sim.busy_reads > 0) {
+			if (sim.busy_reads > 0)
+				sim.busy_reads--;
+			return sim.mib_func | AR8216_MIB_BUSY;
+		}
+		return sim.mib_func;
+	}
+
+	for (port = 0; port < priv->dev.ports; port++) {
+		for (i = 0; i < priv->chip->num_mibs; i++) {
+			mib = &priv->chip->mib_decs[i];
+			if (reg == sim_stats_base(port) + mib->offset)
+				return (u32) sim.captured[port][i];
+			if (mib->size == 2 &&
+			    reg == sim_stats_base(port) + mib->offset + 4)
+				return (u32) (sim.captured[port][i] >> 32);
+		}
+	}
+
+	fprintf(stderr, "read of unknown register 0x%x\n", reg);
+	warnings++;
+	return 0;
+}
+
+static void sim_write(struct ar8xxx_priv *priv, int reg, u32 val)
+{
+	if (reg != sim.mib_func_reg) {
+		fprintf(stderr, "write of unknown register 0x%x\n", reg);
+		warnings++;
+		return;
+	}
+
+	sim.mib_func = val & ~AR8216_MIB_BUSY;
+
+	switch ((val & AR8216_MIB_FUNC) >> AR8216_MIB_FUNC_S) {
+	case AR8216_MIB_FUNC_CAPTURE:
+		memcpy(sim.captured, sim.live, sizeof(sim.live));
+		memset(sim.live, 0, sizeof(sim.live));
+		sim.captures++;
+		break;
+	case AR8216_MIB_FUNC_FLUSH:
+		memset(sim.captured, 0, sizeof(sim.captured));
+		memset(sim.live, 0, sizeof(sim.live));
+		sim.flushes++;
+		break;
+	}
+}
+
+static u32 sim_rmw(struct ar8xxx_priv *priv, int reg, u32 mask, u32 val)
+{
+	u32 v;
+
+	v = sim_read(priv, reg);
+	v &= ~mask;
+	v |= val;
+	sim_write(priv, reg, v);
+
+	return v;
+}
+
+static void sim_init(u8 chip_ver, int ports, const struct ar8xxx_mib_desc *mibs,
+		     unsigned num_mibs)
+{
+	free(sim.priv.mib_stats);
+	memset(&sim, 0, sizeof(sim));
+
+	sim.chip.caps = AR8XXX_CAP_MIB_COUNTERS;
+	sim.chip.mib_decs = mibs;
+	sim.chip.num_mibs = num_mibs;
+
+	sim.priv.dev.ports = ports;
+	sim.priv.read = sim_read;
+	sim.priv.write = sim_write;
+	sim.priv.rmw = sim_rmw;
+	sim.priv.chip_ver = chip_ver;
+	sim.priv.chip = &sim.chip;
+	sim.priv.mib_poll_interval = AR8XXX_MIB_WORK_DELAY;
+	sim.priv.mib_stats = calloc(ports * num_mibs, sizeof(u64));
+
+	if (chip_ver == AR8XXX_VER_AR8327 || chip_ver == AR8XXX_VER_AR8337)
+		sim.mib_func_reg = AR8327_REG_MIB_FUNC;
+	else
+		sim.mib_func_reg = AR8216_REG_MIB_FUNC;
+
+	jiffies += 100000;
+}
+
+static void sim_init_ar8216(void)
+{
+	sim_init(AR8XXX_VER_AR8216, AR8216_NUM_PORTS, ar8216_mibs,
+		 ARRAY_SIZE(ar8216_mibs));
+}
+
+static int mib_index(const char *name)
+{
+	int i;
+
+	for (i = 0; i < sim.chip.num_mibs; i++)
+		if (!strcmp(sim.chip.mib_decs[i].name, name))
+			return i;
+
+	fprintf(stderr, "unknown counter %s\n", name);
+	exit(2);
+}
+
+static void traffic(int port, const char *name, u64 val)
+{
+	sim.live[port][mib_index(name)] += val;
+}
+
+static u64 stat(int port, const char *name)
+{
+	return sim.priv.mib_stats[port * sim.chip.num_mibs + mib_index(name)];
+}
+
+static int update(int flush_port)
+{
+	int ret;
+
+	mutex_lock(&sim.priv.mib_lock);
+	ret = ar8xxx_mib_update(&sim.priv, flush_port);
+	mutex_unlock(&sim.priv.mib_lock);
+
+	return ret;
+}
+
+static int refresh(void)
+{
+	int ret;
+
+	mutex_lock(&sim.priv.mib_lock);
+	ret = ar8xxx_mib_refresh(&sim.priv);
+	mutex_unlock(&sim.priv.mib_lock);
+
+	return ret;
+}
+
+/* run the poll work once and return the delay it asked for */
+static unsigned long poll(void)
+{
+	sim.priv.mib_work.work.pending = 0;
+	ar8xxx_mib_work_func(&sim.priv.mib_work.work);
+	if (!sim.priv.mib_work.work.pending)
+		return 0;
+
+	jiffies += sim.priv.mib_work.delay;
+	return sim.priv.mib_work.delay;
+}
+
+static int failed;
+
+#define CHECK(_c)							\
+	do {								\
+		if (!(_c)) {						\
+			fprintf(stderr, "%s:%d: check failed: %s\n",	\
+				__FILE__, __LINE__, #_c);		\
+			failed++;					\
+		}							\
+	} while (0)
+
+static void test_accumulate(void)
+{
+	int reads;
+
+	sim_init_ar8216();
+
+	traffic(0, "RxBroad", 5);
+	traffic(5, "TxLateCol", 7);
+	traffic(1, "RxGoodByte", 0x123456789ULL);
+	CHECK(update(-1) == 0);
+	CHECK(stat(0, "RxBroad") == 5);
+	CHECK(stat(5, "TxLateCol") == 7);
+	CHECK(stat(1, "RxGoodByte") == 0x123456789ULL);
+
+	/*
+	 * one capture for all ports (a read-modify-write and a read of the
+	 * function register), then one read per counter word
+	 */
+	reads = sim.reads;
+	traffic(0, "RxBroad", 3);
+	traffic(1, "RxGoodByte", 0xffffffffULL);
+	CHECK(update(-1) == 0);
+	CHECK(sim.captures == 2);
+	CHECK(sim.reads - reads == 2 + AR8216_NUM_PORTS *
+	      (ARRAY_SIZE(ar8216_mibs) + 3));
+	CHECK(stat(0, "RxBroad") == 8);
+	CHECK(stat(1, "RxGoodByte") == 0x123456789ULL + 0xffffffffULL);
+	CHECK(stat(5, "TxLateCol") == 7);
+}
+
+static void test_flush_port(void)
+{
+	sim_init_ar8216();
+
+	traffic(1, "TxByte", 100);
+	traffic(2, "TxByte", 200);
+	CHECK(update(-1) == 0);
+
+	/* the captured values of the flushed port are dropped as well */
+	traffic(1, "TxByte", 10);
+	traffic(2, "TxByte", 20);
+	CHECK(update(2) == 0);
+	CHECK(stat(1, "TxByte") == 110);
+	CHECK(stat(2, "TxByte") == 0);
+
+	traffic(2, "TxByte", 30);
+	CHECK(update(-1) == 0);
+	CHECK(stat(2, "TxByte") == 30);
+}
+
+static void test_cache(void)
+{
+	int reads;
+
+	sim_init_ar8216();
+
+	traffic(3, "RxMulti", 1);
+	CHECK(refresh() == 0);
+	CHECK(stat(3, "RxMulti") == 1);
+
+	/* served from the cache within AR8XXX_MIB_CACHE_TIME */
+	reads = sim.reads;
+	traffic(3, "RxMulti", 1);
+	jiffies += msecs_to_jiffies(AR8XXX_MIB_CACHE_TIME) - 1;
+	CHECK(refresh() == 0);
+	CHECK(sim.reads == reads);
+	CHECK(stat(3, "RxMulti") == 1);
+
+	jiffies += 1;
+	CHECK(refresh() == 0);
+	CHECK(sim.reads > reads);
+	CHECK(stat(3, "RxMulti") == 2);
+
+	/* an explicit update does not use the cache */
+	reads = sim.reads;
+	CHECK(update(-1) == 0);
+	CHECK(sim.reads > reads);
+}
+
+static void test_backoff(void)
+{
+	sim_init_ar8216();
+
+	/* the delay doubles while nothing changes, up to the maximum */
+	CHECK(poll() == 4000);
+	CHECK(poll() == 8000);
+	CHECK(poll() == 16000);
+	CHECK(poll() == 16000);
+	CHECK(sim.priv.mib_idle == 3);
+
+	/* traffic resets the interval */
+	traffic(4, "RxPause", 1);
+	CHECK(poll() == 2000);
+	CHECK(sim.priv.mib_idle == 0);
+	CHECK(stat(4, "RxPause") == 1);
+	CHECK(poll() == 4000);
+
+	/* the cap also applies to a longer configured interval */
+	sim.priv.mib_poll_interval = 5000;
+	sim.priv.mib_idle = 0;
+	CHECK(poll() == 10000);
+	CHECK(poll() == 16000);
+	CHECK(poll() == 16000);
+	CHECK(sim.captures == 9);
+}
+
+static void test_no_interval(void)
+{
+	sim_init_ar8216();
+
+	/* the counters are still polled often enough to catch wraps */
+	sim.priv.mib_poll_interval = 0;
+	ar8xxx_mib_start(&sim.priv);
+	CHECK(sim.priv.mib_work.work.pending);
+	CHECK(sim.priv.mib_work.delay == AR8XXX_MIB_WORK_MAX_DELAY);
+
+	traffic(2, "RxGoodByte", 0xfffffff0ULL);
+	CHECK(poll() == AR8XXX_MIB_WORK_MAX_DELAY);
+	traffic(2, "RxGoodByte", 0x20);
+	CHECK(poll() == AR8XXX_MIB_WORK_MAX_DELAY);
+	CHECK(poll() == AR8XXX_MIB_WORK_MAX_DELAY);
+	CHECK(stat(2, "RxGoodByte") == 0x100000010ULL);
+	CHECK(sim.captures == 3);
+}
+
+static void test_busy(void)
+{
+	unsigned long updated;
+
+	sim_init_ar8216();
+
+	sim.busy_reads = 3;
+	traffic(0, "RxBroad", 1);
+	CHECK(update(-1) == 0);
+	CHECK(stat(0, "RxBroad") == 1);
+
+	/* a capture that never completes leaves the counters alone */
+	updated = sim.priv.mib_updated;
+	sim.stuck = 1;
+	jiffies += 5000;
+	CHECK(update(-1) == -ETIMEDOUT);
+	CHECK(sim.priv.mib_updated == updated);
+	CHECK(stat(0, "RxBroad") == 1);
+}
+
+static void test_ar8327(void)
+{
+	sim_init(AR8XXX_VER_AR8327, SIM_PORTS, ar8236_mibs,
+		 ARRAY_SIZE(ar8236_mibs));
+
+	traffic(6, "Rx1518Byte", 9);
+	traffic(0, "TxByte", 0x100000000ULL);
+	CHECK(update(-1) == 0);
+	CHECK(stat(6, "Rx1518Byte") == 9);
+	CHECK(stat(0, "TxByte") == 0x100000000ULL);
+	CHECK(sim.captures == 1);
+}
+
+static const struct {
+	const char *name;
+	void (*run)(void);
+} tests[] = {
+	{ "accumulate", test_accumulate },
+	{ "flush_port", test_flush_port },
+	{ "cache", test_cache },
+	{ "backoff", test_backoff },
+	{ "no_interval", test_no_interval },
+	{ "busy", test_busy },
+	{ "ar8327", test_ar8327 },
+};
+
+int main(int argc, char **argv)
+{
+	int i, prev;
+
+	for (i = 0; i < ARRAY_SIZE(tests); i++) {
+		prev = failed + warnings;
+		tests[i].run();
+		printf("%s %s\n", failed + warnings == prev ? "ok  " : "FAIL",
+		       tests[i].name);
+	}
+
+	free(sim.priv.mib_stats);
+
+	return failed || warnings;
+}
@@ -0,0 +1,88 @@
+#
+# Copyright (C) 2015 OpenWrt.org
+#
+# This is free software, licensed under the GNU General Public License v2.
+# See /LICENSE for more information.
+#
+# Print the top level definitions of a C file whose names are listed in
+# the space separated "names" variable, in the order of the file.  A
+# definition is named after the identifier before its first "(" or "[",
+# the tag of a struct, the name of a #define, the first enumerator of an
+# anonymous enum or the last identifier of a plain declaration.
+#
+
+BEGIN {
+	n = split(names, list, " ")
+	for (i = 1; i <= n; i++)
+		want[list[i]] = 1
+	depth = 0
+	buf = ""
+}
+
+function def_name(text,    sig, brace) {
+	sig = text
+	gsub(/\n/, " ", sig)
+	gsub(/\/\*([^*]|\*+[^*\/])*\*+\//, "", sig)
+
+	if (match(sig, /^[ \t]*#define[ \t]+[A-Za-z_0-9]+/)) {
+		sig = substr(sig, RSTART, RLENGTH)
+		sub(/^[ \t]*#define[ \t]+/, "", sig)
+		return sig
+	}
+
+	if (match(sig, /^[ \t]*enum[ \t]*\{[ \t]*[A-Za-z_0-9]+/)) {
+		sig = substr(sig, RSTART, RLENGTH)
+		sub(/^.*\{[ \t]*/, "", sig)
+		return sig
+	}
+
+	brace = index(sig, "{")
+	if (brace)
+		sig = substr(sig, 1, brace - 1)
+
+	if (match(sig, /[A-Za-z_0-9]+[ \t]*[\(\[]/)) {
+		sig = substr(sig, RSTART, RLENGTH)
+		sub(/[ \t]*[\(\[]$/, "", sig)
+		return sig
+	}
+
+	if (match(sig, /struct[ \t]+[A-Za-z_0-9]+[ \t]*$/)) {
+		sig = substr(sig, RSTART, RLENGTH)
+		sub(/^struct[ \t]+/, "", sig)
+		sub(/[ \t]*$/, "", sig)
+		return sig
+	}
+
+	if (match(sig, /[A-Za-z_0-9]+[ \t]*(=[^;]*)?;[ \t]*$/)) {
+		sig = substr(sig, RSTART, RLENGTH)
+		sub(/[ \t=;].*$/, "", sig)
+		return sig
+	}
+
+	return ""
+}
+
+function flush() {
+	if (buf != "" && want[def_name(buf)])
+		printf "%s\n", buf
+	buf = ""
+}
+
+{
+	if (depth == 0 && $0 ~ /^[ \t]*$/) {
+		buf = ""
+		next
+	}
+
+	buf = buf $0 "\n"
+	opened = gsub(/\{/, "{")
+	closed = gsub(/\}/, "}")
+	was = depth
+	depth += opened - closed
+
+	if (depth > 0)
+		next
+
+	if (was > 0 || opened > 0 || /^[ \t]*#/ && !/\\$/ || /;[ \t]*$/)
+		flush()
+}
@@ -0,0 +1,237 @@
+/*
+ * loader-bench - run the brcm47xx lzma-loader decompressor on the host
+ *
+ * Copyright (C) 2015 OpenWrt.org
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ *
+ * The decompressor is taken unchanged from decompress.c (see ../extract.awk),
+ * only the cache flushes are replaced.  The image is mapped read-only at
+ * the KSEG1 address of the flash, followed by an inaccessible guard page,
+ * and the kernel is decompressed into a non-executable buffer: the jump to
+ * the kernel faults on its first instruction, which ends a run.
+ */
+
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <setjmp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "LzmaDecode.h"
+
+#define OUT_SIZE	(256 << 20)
+
+static unsigned long load_addr;
+#define LOADADDR	load_addr
+
+static void blast_dcache(unsigned long size, unsigned long lsize)
+{
+}
+
+static void blast_icache(unsigned long size, unsigned long lsize)
+{
+}
+
+#include "decompress-funcs.c"
+
+unsigned char workspace[(LZMA_BASE_SIZE + (LZMA_LIT_SIZE << 12)) * sizeof(CProb)];
+
+static sigjmp_buf jump_env;
+
+static void kernel_entered(int sig, siginfo_t *info, void *ctx)
+{
+	if ((unsigned long) info->si_addr == load_addr)
+		siglongjmp(jump_env, 1);
+
+	/* a real fault, let it happen again without the handler */
+	signal(SIGSEGV, SIG_DFL);
+}
+
+static void *read_file(const char *name, size_t *len)
+{
+	struct stat s;
+	void *buf;
+	int fd;
+
+	fd = open(name, O_RDONLY);
+	if (fd < 0 || fstat(fd, &s)) {
+		perror(name);
+		exit(1);
+	}
+
+	buf = malloc(s.st_size + 1);
+	if (!buf || read(fd, buf, s.st_size) != s.st_size) {
+		perror(name);
+		exit(1);
+	}
+
+	close(fd);
+	*len = s.st_size;
+	return buf;
+}
+
+/* put the image into the flash window, wrapping a bare stream into a trx */
+static unsigned char *map_flash(const unsigned char *img, size_t len)
+{
+	unsigned long flash = KSEG1ADDR(BCM4710_FLASH);
+	long page = sysconf(_SC_PAGESIZE);
+	struct trx_header trx = { 0 };
+	size_t size, hlen = 0;
+	unsigned char *p;
+
+	if (len < 4 || (*(unsigned int *) img != TRX_MAGIC &&
+			*(unsigned int *) img != EDIMAX_PS_HEADER_MAGIC)) {
+		trx.magic = TRX_MAGIC;
+		hlen = sizeof(trx);
+		trx.len = hlen + len;
+		trx.offsets[0] = hlen;
+		trx.offsets[1] = hlen;
+	}
+
+	size = (hlen + len + page - 1) & ~(page - 1);
+	p = mmap((void *) flash, size + page, PROT_READ | PROT_WRITE,
+		 MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+	if (p != (void *) flash) {
+		fprintf(stderr, "Cannot map the flash window at 0x%lx\n", flash);
+		exit(1);
+	}
+
+	memcpy(p, &trx, hlen);
+	memcpy(p + hlen, img, len);
+	mprotect(p, size, PROT_READ);
+	mprotect(p + size, page, PROT_NONE);
+
+	return p;
+}
+
+/* the compressed kernel as the loader finds it */
+static const unsigned char *kernel_stream(const unsigned char *p, size_t *len)
+{
+	const struct trx_header *trx;
+	unsigned int part;
+
+	if (*(unsigned int *) p == EDIMAX_PS_HEADER_MAGIC)
+		p += EDIMAX_PS_HEADER_LEN;
+
+	trx = (const struct trx_header *) p;
+	part = (trx->offsets[1] > 65536) ? 0 : 1;
+	*len = (trx->offsets[part + 1] ? trx->offsets[part + 1] : trx->len) -
+	       trx->offsets[part];
+
+	return p + trx->offsets[part];
+}
+
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int usage(const char *prog)
+{
+	fprintf(stderr, "Usage: %s [-n <runs>] [-k <kernel>] <image>\n"
+		"\n"
+		"<image> is a trx image or a bare lzma compressed kernel.\n"
+		"Options:\n"
+		"	-n <runs>:	Number of runs, the fastest one is reported\n"
+		"	-k <kernel>:	Uncompressed kernel to compare the output with\n",
+		prog);
+	return 1;
+}
+
+int main(int argc, char **argv)
+{
+	const char *image_name, *kernel_name = NULL;
+	unsigned char *img, *kernel = NULL, *flash;
+	const unsigned char *stream;
+	size_t img_len, kernel_len = 0, in_len, out_len;
+	double start, best = 0;
+	struct sigaction sa;
+	int runs = 1, run, ch;
+
+	while ((ch = getopt(argc, argv, "k:n:")) != -1) {
+		switch (ch) {
+		case 'k':
+			kernel_name = optarg;
+			break;
+		case 'n':
+			runs = atoi(optarg);
+			break;
+		default:
+			return usage(argv[0]);
+		}
+	}
+
+	if (optind != argc - 1 || runs < 1)
+		return usage(argv[0]);
+
+	image_name = argv[optind];
+	img = read_file(image_name, &img_len);
+	if (kernel_name)
+		kernel = read_file(kernel_name, &kernel_len);
+
+	flash = map_flash(img, img_len);
+	stream = kernel_stream(flash, &in_len);
+
+	/* the size in the header is unknown for streams with an end marker */
+	out_len = stream[5] | stream[6] << 8 | stream[7] << 16 |
+		  (unsigned int) stream[8] << 24;
+	if (out_len == 0xffffffff)
+		out_len = kernel_len;
+
+	if (out_len > OUT_SIZE || kernel_len > OUT_SIZE) {
+		fprintf(stderr, "Kernel too large\n");
+		return 1;
+	}
+
+	load_addr = (unsigned long) mmap(NULL, OUT_SIZE, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (load_addr == (unsigned long) MAP_FAILED) {
+		perror("mmap");
+		return 1;
+	}
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_sigaction = kernel_entered;
+	sa.sa_flags = SA_SIGINFO;
+	sigaction(SIGSEGV, &sa, NULL);
+
+	for (run = 0; run < runs; run++) {
+		start = now();
+
+		if (!sigsetjmp(jump_env, 1)) {
+			entry(0, 0, 0, 0, 0, 0, 0, 0);
+			fprintf(stderr, "%s: decompression failed\n", image_name);
+			return 1;
+		}
+
+		start = now() - start;
+		if (!run || start < best)
+			best = start;
+	}
+
+	printf("%s: %zu bytes compressed, %.1f ms, %.2f MB/s in",
+	       image_name, in_len, best * 1000, in_len / best / 1e6);
+	if (out_len)
+		printf(", %.2f MB/s out", out_len / best / 1e6);
+	printf("\n");
+
+	if (kernel && memcmp((void *) load_addr, kernel, kernel_len)) {
+		fprintf(stderr, "%s: output differs from %s\n", image_name,
+			kernel_name);
+		return 1;
+	}
+
+	return 0;
+}
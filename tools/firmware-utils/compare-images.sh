@@ -0,0 +1,123 @@
+#!/usr/bin/env bash
+#
+# Copyright (C) 2015 OpenWrt.org
+#
+# This is free software, licensed under the GNU General Public License v2.
+# See /LICENSE for more information.
+#
+# Build trx, mktplinkfw, mkfwimage, mkzynfw and mkcsysimg from the current
+# tree and from a reference revision, run both on the same set of inputs
+# and compare the generated images byte for byte.
+#
+#   tools/firmware-utils/compare-images.sh [<git revision>]
+#
+# The reference defaults to the revision before fw-lib.c was added.
+#
+
+set -e
+
+HOSTCC="${HOSTCC:-cc}"
+HOST_CFLAGS="${HOST_CFLAGS:--O2}"
+
+SELF_DIR="$(cd "$(dirname "$0")" && pwd)"
+TOPDIR="$(cd "$SELF_DIR/../.." && pwd)"
+
+REF="$1"
+[ -n "$REF" ] || {
+	REF="$(cd "$TOPDIR" && git log --diff-filter=A --format=%H -1 -- tools/firmware-utils/src/fw-lib.c)"
+	[ -n "$REF" ] || { echo "Cannot find the reference revision" >&2; exit 1; }
+	REF="$REF^"
+}
+
+WORK="$(mktemp -d)"
+trap 'rm -rf "$WORK"' EXIT
+
+mkdir -p "$WORK/ref" "$WORK/new" "$WORK/in" "$WORK/out/ref" "$WORK/out/new"
+(cd "$TOPDIR" && git archive "$REF" tools/firmware-utils/src) | tar -x -C "$WORK/ref"
+mkdir -p "$WORK/new/tools/firmware-utils"
+cp -a "$SELF_DIR/src" "$WORK/new/tools/firmware-utils/"
+
+# build <dir> <tool> <sources...>
+build() {
+	local dir="$1/tools/firmware-utils/src" tool="$2" srcs="" src
+	shift 2
+
+	for src in "$@"; do
+		[ -f "$dir/$src.c" ] && srcs="$srcs $dir/$src.c"
+	done
+
+	$HOSTCC $HOST_CFLAGS -include endian.h -include byteswap.h -o "$dir/$tool" $srcs -lz
+}
+
+for tree in ref new; do
+	build "$WORK/$tree" trx trx fw-lib
+	build "$WORK/$tree" mktplinkfw mktplinkfw md5 fw-lib
+	build "$WORK/$tree" mkfwimage mkfwimage fw-lib
+	build "$WORK/$tree" mkzynfw mkzynfw fw-lib
+	build "$WORK/$tree" mkcsysimg mkcsysimg fw-lib
+done
+
+# pseudo random input files of the given size
+gen() {
+	perl -e 'srand($ARGV[1]); print pack("C*", map { int(rand(256)) } 1 .. $ARGV[0])' "$2" "$3" > "$WORK/in/$1"
+}
+
+gen loader.gz 7680 1
+gen kernel 917504 2
+gen kernel.odd 1000003 3
+gen rootfs 2097152 4
+gen rootfs.odd 1310721 5
+gen small 4097 6
+printf '\xde\xad\xc0\xde' > "$WORK/in/fs_mark"
+
+# each line: <tool> <arguments>, %I is the input and %O the output directory
+MATRIX='
+trx -o %O/img -f %I/kernel -f %I/rootfs
+trx -o %O/img -f %I/loader.gz -f %I/kernel.odd -a 1024 -f %I/rootfs.odd -a 0x10000 -A %I/fs_mark
+trx -2 -o %O/img -f %I/loader.gz -f %I/kernel -a 0x10000 -f %I/rootfs
+trx -o %O/img -m 4194304 -f %I/small -a 4 -f %I/kernel.odd
+mktplinkfw -B TL-WR741NDv1 -N OpenWrt -V r1 -k %I/kernel -r %I/rootfs -o %O/img
+mktplinkfw -B TL-WR1043NDv1 -N OpenWrt -V r1 -s -k %I/kernel.odd -r %I/rootfs.odd -a 0x10000 -j -o %O/img
+mktplinkfw -H 0x07410001 -W 1 -F 4Mlzma -N OpenWrt -V r1 -X 0x40000 -k %I/kernel -r %I/rootfs -a 0x10000 -j -o %O/img
+mktplinkfw -H 0x07410001 -W 1 -F 4Mlzma -N OpenWrt -V r1 -X 0x40000 -s -k %I/kernel.odd -r %I/rootfs.odd -a 0x10000 -j -o %O/img
+mktplinkfw -c -H 0x07410001 -W 1 -F 8M -N OpenWrt -V r1 -s -k %I/kernel.odd -o %O/img
+mkfwimage -B XS2 -v XS2.ar7240.OpenWrt.r1 -k %I/kernel -r %I/rootfs -o %O/img
+mkfwimage -B XM -v XM.ar7240.v6.0.0-OpenWrt-r1 -k %I/kernel.odd -r %I/rootfs.odd -o %O/img
+mkfwimage -B RSPRO -v RSPRO.ar7100pro.OpenWrt.r1 -k %I/small -r %I/rootfs -o %O/img
+mkzynfw -B ES-2024A -b %I/small -r %I/kernel:0x10000 -o %O/img
+mkzynfw -B ES-2108 -b %I/loader.gz -r %I/kernel.odd -o %O/img
+mkcsysimg -B BR-6104K -d -w -r %I/loader.gz::0x1000 -x %I/kernel:0x10000 -x %I/fs_mark:0x10000 %O/img
+mkcsysimg -B BR-6114WG -d -r %I/loader.gz::0x1000 -x %I/kernel.odd:0x10000 -x %I/fs_mark:0x10000 %O/img
+trx -o %O/img -m 65536 -f %I/kernel
+mktplinkfw -B NO-SUCH-BOARD -k %I/kernel -r %I/rootfs -o %O/img
+mkfwimage -B XS2 -v XS2.ar7240.OpenWrt.r1 -k %I/rootfs -r %I/rootfs -o %O/img
+'
+
+fail=0
+while read -r tool args; do
+	[ -n "$tool" ] || continue
+
+	for tree in ref new; do
+		rm -f "$WORK/out/$tree/img"
+		status=0
+		eval "\"$WORK/$tree/tools/firmware-utils/src/$tool\" $(echo "$args" | sed -e "s#%I#$WORK/in#g" -e "s#%O#$WORK/out/$tree#g")" \
+			> "$WORK/out/$tree/log" 2>&1 || status=$?
+		eval "status_$tree=$status"
+	done
+
+	if [ "$status_ref" != "$status_new" ]; then
+		echo "FAIL $tool $args: exit status $status_ref vs. $status_new"
+		fail=1
+	elif [ -f "$WORK/out/ref/img" ] && cmp -s "$WORK/out/ref/img" "$WORK/out/new/img"; then
+		echo "ok   $tool $args"
+	elif [ ! -f "$WORK/out/ref/img" ] && [ ! -f "$WORK/out/new/img" ]; then
+		echo "ok   $tool $args (no image, exit status $status_ref)"
+	else
+		echo "FAIL $tool $args: images differ"
+		fail=1
+	fi
+done <<EOF
+$MATRIX
+EOF
+
+exit $fail
@@ -0,0 +1,222 @@
+/*
+ * Common helpers for the firmware image tools
+ *
+ * Copyright (C) 2015 OpenWrt.org
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "fw-lib.h"
+
+#define FILL_BUF_LEN	(64 * 1024)
+#define READ_BUF_LEN	(256 * 1024)
+
+static int fw_file_read(struct fw_file *file, int fd)
+{
+	size_t len = 0;
+	ssize_t n;
+
+	for (;;) {
+		if (len == file->size) {
+			uint8_t *p;
+
+			p = realloc(file->data, file->size + READ_BUF_LEN);
+			if (!p)
+				return -1;
+
+			file->data = p;
+			file->size += READ_BUF_LEN;
+		}
+
+		n = read(fd, file->data + len, file->size - len);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+
+		if (n == 0)
+			break;
+
+		len += n;
+	}
+
+	file->size = len;
+	return 0;
+}
+
+int fw_file_map(struct fw_file *file, const char *name)
+{
+	struct stat st;
+	int fd;
+	int ret = -1;
+
+	memset(file, 0, sizeof(*file));
+	file->name = name;
+
+	fd = open(name, O_RDONLY);
+	if (fd < 0)
+		return -1;
+
+	if (fstat(fd, &st))
+		goto out;
+
+	if (S_ISREG(st.st_mode) && st.st_size > 0) {
+		file->data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+				  fd, 0);
+		if (file->data != MAP_FAILED) {
+			file->size = st.st_size;
+			file->mapped = 1;
+			ret = 0;
+			goto out;
+		}
+		file->data = NULL;
+	}
+
+	ret = fw_file_read(file, fd);
+	if (ret) {
+		free(file->data);
+		file->data = NULL;
+		file->size = 0;
+	}
+
+out:
+	close(fd);
+	return ret;
+}
+
+void fw_file_unmap(struct fw_file *file)
+{
+	if (file->mapped)
+		munmap(file->data, file->size);
+	else
+		free(file->data);
+
+	file->data = NULL;
+	file->size = 0;
+	file->mapped = 0;
+}
+
+void fw_writer_init(struct fw_writer *w, FILE *f,
+		    fw_update_fn update, void *ctx)
+{
+	w->f = f;
+	w->pos = 0;
+	w->update = update;
+	w->ctx = ctx;
+}
+
+int fw_write(struct fw_writer *w, const void *buf, size_t len)
+{
+	if (!len)
+		return 0;
+
+	if (w->f && fwrite(buf, len, 1, w->f) != 1)
+		return -1;
+
+	if (w->update)
+		w->update(w->ctx, buf, len);
+
+	w->pos += len;
+	return 0;
+}
+
+int fw_write_fill(struct fw_writer *w, uint8_t c, size_t len)
+{
+	static uint8_t buf[FILL_BUF_LEN];
+	static int buf_c = -1;
+	size_t n;
+
+	if (buf_c != c) {
+		memset(buf, c, sizeof(buf));
+		buf_c = c;
+	}
+
+	while (len > 0) {
+		n = (len < sizeof(buf)) ? len : sizeof(buf);
+		if (fw_write(w, buf, n))
+			return -1;
+		len -= n;
+	}
+
+	return 0;
+}
+
+int fw_write_pad_to(struct fw_writer *w, uint8_t c, size_t offset)
+{
+	if (offset < w->pos)
+		return -1;
+
+	return fw_write_fill(w, c, offset - w->pos);
+}
+
+/*
+ * Slice-by-8 CRC32, the tables are generated on first use.
+ */
+static uint32_t crc32_table[8][256];
+
+static void fw_crc32_init(void)
+{
+	uint32_t c;
+	int i, j;
+
+	for (i = 0; i < 256; i++) {
+		c = i;
+		for (j = 0; j < 8; j++)
+			c = (c & 1) ? (c >> 1) ^ 0xedb88320 : (c >> 1);
+		crc32_table[0][i] = c;
+	}
+
+	for (i = 0; i < 256; i++) {
+		c = crc32_table[0][i];
+		for (j = 1; j < 8; j++) {
+			c = crc32_table[0][c & 0xff] ^ (c >> 8);
+			crc32_table[j][i] = c;
+		}
+	}
+}
+
+uint32_t fw_crc32(uint32_t crc, const void *buf, size_t len)
+{
+	const uint8_t *p = buf;
+	uint32_t lo, hi;
+
+	if (!crc32_table[0][1])
+		fw_crc32_init();
+
+	while (len >= 8) {
+		lo = crc ^ ((uint32_t) p[0] | ((uint32_t) p[1] << 8) |
+			    ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24));
+		hi = (uint32_t) p[4] | ((uint32_t) p[5] << 8) |
+		     ((uint32_t) p[6] << 16) | ((uint32_t) p[7] << 24);
+
+		crc = crc32_table[7][lo & 0xff] ^
+		      crc32_table[6][(lo >> 8) & 0xff] ^
+		      crc32_table[5][(lo >> 16) & 0xff] ^
+		      crc32_table[4][lo >> 24] ^
+		      crc32_table[3][hi & 0xff] ^
+		      crc32_table[2][(hi >> 8) & 0xff] ^
+		      crc32_table[1][(hi >> 16) & 0xff] ^
+		      crc32_table[0][hi >> 24];
+
+		p += 8;
+		len -= 8;
+	}
+
+	while (len--)
+		crc = crc32_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+
+	return crc;
+}
@@ -0,0 +1,60 @@
+/*
+ * Common helpers for the firmware image tools
+ *
+ * Copyright (C) 2015 OpenWrt.org
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ *
+ */
+
+#ifndef _FW_LIB_H
+#define _FW_LIB_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Input files are mapped instead of being copied into a buffer. Things
+ * which can't be mapped (pipes, empty files) are read into memory.
+ */
+struct fw_file {
+	const char	*name;
+	uint8_t		*data;
+	size_t		size;
+	int		mapped;
+};
+
+int fw_file_map(struct fw_file *file, const char *name);
+void fw_file_unmap(struct fw_file *file);
+
+/*
+ * Streaming output. Everything written goes through the optional update
+ * callback (eg. a checksum), and to the file unless it is NULL, which
+ * allows to checksum an image in a first pass before writing it out.
+ */
+typedef void (*fw_update_fn)(void *ctx, const void *buf, size_t len);
+
+struct fw_writer {
+	FILE		*f;
+	size_t		pos;
+	fw_update_fn	update;
+	void		*ctx;
+};
+
+void fw_writer_init(struct fw_writer *w, FILE *f,
+		    fw_update_fn update, void *ctx);
+int fw_write(struct fw_writer *w, const void *buf, size_t len);
+int fw_write_fill(struct fw_writer *w, uint8_t c, size_t len);
+int fw_write_pad_to(struct fw_writer *w, uint8_t c, size_t offset);
+
+/*
+ * Plain reflected CRC32 (polynomial 0xedb88320) without the initial and
+ * final inversion, so it can be chained: zlib's crc32(crc, buf, len) is
+ * ~fw_crc32(~crc, buf, len).
+ */
+uint32_t fw_crc32(uint32_t crc, const void *buf, size_t len);
+
+#endif /* _FW_LIB_H */
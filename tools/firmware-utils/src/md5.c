@@ -49,6 +49,7 @@
 
 /* forward declaration */
 static void Transform ();
+static void Decode ();
 
 static unsigned char PADDING[64] = {
   0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
@@ -126,7 +127,7 @@ unsigned int inLen;
 {
   UINT4 in[16];
   int mdi;
-  unsigned int i, ii;
+  unsigned int n;
 
   /* compute number of bytes mod 64 */
   mdi = (int)((mdContext->i[0] >> 3) & 0x3F);
@@ -137,21 +138,33 @@ unsigned int inLen;
   mdContext->i[0] += ((UINT4)inLen << 3);
   mdContext->i[1] += ((UINT4)inLen >> 29);
 
-  while (inLen--) {
-    /* add new character to buffer, increment mdi */
-    mdContext->in[mdi++] = *inBuf++;
-
-    /* transform if necessary */
-    if (mdi == 0x40) {
-      for (i = 0, ii = 0; i < 16; i++, ii += 4)
-        in[i] = (((UINT4)mdContext->in[ii+3]) << 24) |
-                (((UINT4)mdContext->in[ii+2]) << 16) |
-                (((UINT4)mdContext->in[ii+1]) << 8) |
-                ((UINT4)mdContext->in[ii]);
-      Transform (mdContext->buf, in);
-      mdi = 0;
-    }
+  /* complete a partially filled buffer first */
+  if (mdi) {
+    n = 0x40 - mdi;
+    if (n > inLen)
+      n = inLen;
+    memcpy (&mdContext->in[mdi], inBuf, n);
+    mdi += n;
+    inBuf += n;
+    inLen -= n;
+
+    if (mdi < 0x40)
+      return;
+
+    Decode (in, mdContext->in);
+    Transform (mdContext->buf, in);
   }
+
+  /* transform whole blocks straight from the input */
+  while (inLen >= 0x40) {
+    Decode (in, inBuf);
+    Transform (mdContext->buf, in);
+    inBuf += 0x40;
+    inLen -= 0x40;
+  }
+
+  /* keep the rest for later */
+  memcpy (mdContext->in, inBuf, inLen);
 }
 
 /* The routine MD5Final terminates the message-digest computation and
@@ -198,6 +211,21 @@ MD5_CTX *mdContext;
   memcpy(hash, mdContext->digest, 16);
 }
 
+/* Load a 64 byte block as little endian words.
+ */
+static void Decode (in, block)
+UINT4 *in;
+unsigned char *block;
+{
+  unsigned int i, ii;
+
+  for (i = 0, ii = 0; i < 16; i++, ii += 4)
+    in[i] = (((UINT4)block[ii+3]) << 24) |
+            (((UINT4)block[ii+2]) << 16) |
+            (((UINT4)block[ii+1]) << 8) |
+            ((UINT4)block[ii]);
+}
+
 /* Basic MD5 step. Transforms buf based on in.
  */
 static void Transform (buf, in)
@@ -38,6 +38,7 @@
 #endif
 
 #include "csysimg.h"
+#include "fw-lib.h"
 
 #if (__BYTE_ORDER == __LITTLE_ENDIAN)
 #  define HOST_TO_LE16(x)	(x)
@@ -54,7 +55,6 @@
 #define MAX_NUM_BLOCKS	8
 #define MAX_ARG_COUNT	32
 #define MAX_ARG_LEN	1024
-#define FILE_BUF_LEN	(16*1024)
 #define CSYS_PADC	0xFF
 
 #define BLOCK_TYPE_BOOT	0
@@ -590,10 +590,7 @@ block_writeout_hdr(FILE *outfile, struct csys_block *block)
 int
 block_writeout_file(FILE *outfile, struct csys_block *block)
 {
-	char buf[FILE_BUF_LEN];
-	size_t buflen = sizeof(buf);
-	FILE *f;
-	size_t len;
+	struct fw_file file;
 	int res;
 
 	if (block->file_name == NULL)
@@ -602,35 +599,20 @@ block_writeout_file(FILE *outfile, struct csys_block *block)
 	if (block->file_size == 0)
 		return 0;
 
-	errno = 0;
-	f = fopen(block->file_name,"r");
-	if (errno) {
+	if (fw_file_map(&file, block->file_name)) {
 		ERRS("unable to open file: %s", block->file_name);
 		return ERR_FATAL;
 	}
 
-	len = block->file_size;
-	while (len > 0) {
-		if (len < buflen)
-			buflen = len;
-
-		/* read data from source file */
-		errno = 0;
-		fread(buf, buflen, 1, f);
-		if (errno != 0) {
-			ERRS("unable to read from file: %s", block->file_name);
-			res = ERR_FATAL;
-			break;
-		}
-
-		res = write_out_data(outfile, buf, buflen, block->css);
-		if (res)
-			break;
-
-		len -= buflen;
+	if (file.size < block->file_size) {
+		ERR("unable to read from file: %s", block->file_name);
+		fw_file_unmap(&file);
+		return ERR_FATAL;
 	}
 
-	fclose(f);
+	res = write_out_data(outfile, file.data, block->file_size, block->css);
+
+	fw_file_unmap(&file);
 	return res;
 }
 
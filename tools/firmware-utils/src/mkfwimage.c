@@ -23,13 +23,13 @@
 #include <unistd.h>
 #include <string.h>
 #include <errno.h>
-#include <zlib.h>
 #include <sys/mman.h>
 #include <netinet/in.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
 #include "fw.h"
+#include "fw-lib.h"
 
 typedef struct fw_layout_data {
 	char		name[PATH_MAX];
@@ -114,68 +114,90 @@ typedef struct image_info {
 	part_data_t parts[MAX_SECTIONS];
 } image_info_t;
 
-static void write_header(void* mem, const char *magic, const char* version)
+struct image_crc {
+	uint32_t	image;
+	uint32_t	part;
+};
+
+static void image_crc_update(void *ctx, const void *buf, size_t len)
 {
-	header_t* header = mem;
-	memset(header, 0, sizeof(header_t));
+	struct image_crc *crc = ctx;
 
-	memcpy(header->magic, magic, MAGIC_LENGTH);
-	strncpy(header->version, version, sizeof(header->version));
-	header->crc = htonl(crc32(0L, (unsigned char *)header,
+	crc->image = fw_crc32(crc->image, buf, len);
+	crc->part = fw_crc32(crc->part, buf, len);
+}
+
+static int write_header(struct fw_writer *w, const char *magic, const char* version)
+{
+	header_t header;
+
+	memset(&header, 0, sizeof(header_t));
+
+	memcpy(header.magic, magic, MAGIC_LENGTH);
+	strncpy(header.version, version, sizeof(header.version));
+	header.crc = htonl(~fw_crc32(~0U, &header,
 				sizeof(header_t) - 2 * sizeof(u_int32_t)));
-	header->pad = 0L;
+	header.pad = 0L;
+
+	return fw_write(w, &header, sizeof(header));
 }
 
 
-static void write_signature(void* mem, u_int32_t sig_offset)
+static int write_signature(struct fw_writer *w, struct image_crc *crc)
 {
 	/* write signature */
-	signature_t* sign = (signature_t*)(mem + sig_offset);
-	memset(sign, 0, sizeof(signature_t));
+	signature_t sign;
+
+	memset(&sign, 0, sizeof(signature_t));
 
-	memcpy(sign->magic, MAGIC_END, MAGIC_LENGTH);
-	sign->crc = htonl(crc32(0L,(unsigned char *)mem, sig_offset));
-	sign->pad = 0L;
+	memcpy(sign.magic, MAGIC_END, MAGIC_LENGTH);
+	sign.crc = htonl(~crc->image);
+	sign.pad = 0L;
+
+	return fw_write(w, &sign, sizeof(sign));
 }
 
-static int write_part(void* mem, part_data_t* d)
+static int write_part(struct fw_writer *w, struct image_crc *crc, part_data_t* d)
 {
-	char* addr;
-	int fd;
-	part_t* p = mem;
-	part_crc_t* crc = mem + sizeof(part_t) + d->stats.st_size;
+	struct fw_file file;
+	part_t p;
+	part_crc_t pcrc;
+	int ret;
 
-	fd = open(d->filename, O_RDONLY);
-	if (fd < 0)
+	if (fw_file_map(&file, d->filename))
 	{
 		ERROR("Failed opening file '%s'\n", d->filename);
 		return -1;
 	}
 
-	if ((addr=(char*)mmap(0, d->stats.st_size, PROT_READ, MAP_SHARED, fd, 0)) == MAP_FAILED)
+	if (file.size != d->stats.st_size)
 	{
-		ERROR("Failed mmaping memory for file '%s'\n", d->filename);
-		close(fd);
+		ERROR("File '%s' changed size\n", d->filename);
+		fw_file_unmap(&file);
 		return -2;
 	}
 
-	memcpy(mem + sizeof(part_t), addr, d->stats.st_size);
-	munmap(addr, d->stats.st_size);
-
-	memset(p->name, 0, sizeof(p->name));
-	strncpy(p->magic, MAGIC_PART, MAGIC_LENGTH);
-	strncpy(p->name, d->partition_name, sizeof(p->name));
-	p->index = htonl(d->partition_index);
-	p->data_size = htonl(d->stats.st_size);
-	p->part_size = htonl(d->partition_length);
-	p->baseaddr = htonl(d->partition_baseaddr);
-	p->memaddr = htonl(d->partition_memaddr);
-	p->entryaddr = htonl(d->partition_entryaddr);
+	memset(&p, 0, sizeof(p));
+	strncpy(p.magic, MAGIC_PART, MAGIC_LENGTH);
+	strncpy(p.name, d->partition_name, sizeof(p.name));
+	p.index = htonl(d->partition_index);
+	p.data_size = htonl(d->stats.st_size);
+	p.part_size = htonl(d->partition_length);
+	p.baseaddr = htonl(d->partition_baseaddr);
+	p.memaddr = htonl(d->partition_memaddr);
+	p.entryaddr = htonl(d->partition_entryaddr);
+
+	crc->part = ~0U;
+	ret = fw_write(w, &p, sizeof(p)) ||
+	      fw_write(w, file.data, file.size);
+	fw_file_unmap(&file);
+	if (ret)
+		return -3;
 
-	crc->crc = htonl(crc32(0L, mem, d->stats.st_size + sizeof(part_t)));
-	crc->pad = 0L;
+	pcrc.crc = htonl(~crc->part);
+	pcrc.pad = 0L;
 
-	return 0;
+	return fw_write(w, &pcrc, sizeof(pcrc)) ? -3 : 0;
 }
 
 static void usage(const char* progname)
@@ -319,61 +341,50 @@ static int validate_image_layout(image_info_t* im)
 
 static int build_image(image_info_t* im)
 {
-	char* mem;
-	char* ptr;
-	u_int32_t mem_size;
+	struct image_crc crc;
+	struct fw_writer w;
 	FILE* f;
 	int i;
 
-	// build in-memory buffer
-	mem_size = sizeof(header_t) + sizeof(signature_t);
-	for (i = 0; i < im->part_count; ++i)
+	if ((f = fopen(im->outputfile, "w")) == NULL)
 	{
-		part_data_t* d = &im->parts[i];
-		mem_size += sizeof(part_t) + d->stats.st_size + sizeof(part_crc_t);
+		ERROR("Can not create output file: '%s'\n", im->outputfile);
+		return -10;
 	}
 
-	mem = (char*)calloc(mem_size, 1);
-	if (mem == NULL)
-	{
-		ERROR("Cannot allocate memory chunk of size '%u'\n", mem_size);
-		return -1;
-	}
+	crc.image = ~0U;
+	fw_writer_init(&w, f, image_crc_update, &crc);
 
 	// write header
-	write_header(mem, im->magic, im->version);
-	ptr = mem + sizeof(header_t);
+	if (write_header(&w, im->magic, im->version))
+		goto err_write;
+
 	// write all parts
 	for (i = 0; i < im->part_count; ++i)
 	{
 		part_data_t* d = &im->parts[i];
 		int rc;
-		if ((rc = write_part(ptr, d)) != 0)
+		if ((rc = write_part(&w, &crc, d)) != 0)
 		{
 			ERROR("ERROR: failed writing part %u '%s'\n", i, d->partition_name);
+			fclose(f);
+			unlink(im->outputfile);
+			return -11;
 		}
-		ptr += sizeof(part_t) + d->stats.st_size + sizeof(part_crc_t);
 	}
-	// write signature
-	write_signature(mem, mem_size - sizeof(signature_t));
 
-	// write in-memory buffer into file
-	if ((f = fopen(im->outputfile, "w")) == NULL)
-	{
-		ERROR("Can not create output file: '%s'\n", im->outputfile);
-		return -10;
-	}
-
-	if (fwrite(mem, mem_size, 1, f) != 1)
-	{
-		ERROR("Could not write %d bytes into file: '%s'\n",
-				mem_size, im->outputfile);
-		return -11;
-	}
+	// write signature
+	if (write_signature(&w, &crc) || fflush(f))
+		goto err_write;
 
-	free(mem);
 	fclose(f);
 	return 0;
+
+err_write:
+	ERROR("Could not write into file: '%s'\n", im->outputfile);
+	fclose(f);
+	unlink(im->outputfile);
+	return -11;
 }
 
 
@@ -26,6 +26,7 @@
 #include <netinet/in.h>
 
 #include "md5.h"
+#include "fw-lib.h"
 
 #define ALIGN(x,a) ({ typeof(a) __a = (a); (((x) + __a - 1) & ~(__a - 1)); })
 
@@ -687,10 +688,8 @@ static int check_options(void)
 	return 0;
 }
 
-static void fill_header(char *buf, int len)
+static void fill_header(struct fw_header *hdr)
 {
-	struct fw_header *hdr = (struct fw_header *)buf;
-
 	memset(hdr, 0, sizeof(struct fw_header));
 
 	hdr->version = htonl(HEADER_VERSION_V1);
@@ -717,16 +716,14 @@ static void fill_header(char *buf, int len)
 	hdr->ver_hi = htons(fw_ver_hi);
 	hdr->ver_mid = htons(fw_ver_mid);
 	hdr->ver_lo = htons(fw_ver_lo);
-
-	get_md5(buf, len, hdr->md5sum1);
 }
 
-static int pad_jffs2(char *buf, int currlen)
+static int pad_jffs2(struct fw_writer *w)
 {
 	int len;
 	uint32_t pad_mask;
 
-	len = currlen;
+	len = w->pos;
 	pad_mask = (64 * 1024);
 	while ((len < layout->fw_max_len) && (pad_mask != 0)) {
 		uint32_t mask;
@@ -746,102 +743,109 @@ static int pad_jffs2(char *buf, int currlen)
 				pad_mask &= ~mask;
 		}
 
-		for (i = 0; i < sizeof(jffs2_eof_mark); i++)
-			buf[len + i] = jffs2_eof_mark[i];
+		if (fw_write_pad_to(w, 0xff, len) ||
+		    fw_write(w, jffs2_eof_mark, sizeof(jffs2_eof_mark)))
+			return -1;
 
 		len += sizeof(jffs2_eof_mark);
 	}
 
-	return len;
+	return 0;
 }
 
-static int write_fw(char *data, int len)
+/*
+ * Emit the image through the writer; the same sequence is used to
+ * compute the MD5 sum and to write the file, so the image is never
+ * assembled in memory.
+ */
+static int write_fw_data(struct fw_writer *w, struct fw_header *hdr,
+			 struct fw_file *kernel, struct fw_file *rootfs)
 {
-	FILE *f;
-	int ret = EXIT_FAILURE;
+	if (fw_write(w, hdr, sizeof(struct fw_header)) ||
+	    fw_write(w, kernel->data, kernel->size))
+		return -1;
 
-	f = fopen(ofname, "w");
-	if (f == NULL) {
-		ERRS("could not open \"%s\" for writing", ofname);
-		goto out;
-	}
+	if (!combined) {
+		if (rootfs_align) {
+			if (fw_write_pad_to(w, 0xff,
+					sizeof(struct fw_header) + kernel_len))
+				return -1;
+		} else {
+			if (fw_write_pad_to(w, 0xff, rootfs_ofs))
+				return -1;
+		}
 
-	errno = 0;
-	fwrite(data, len, 1, f);
-	if (errno) {
-		ERRS("unable to write output file");
-		goto out_flush;
+		if (fw_write(w, rootfs->data, rootfs->size))
+			return -1;
+
+		if (add_jffs2_eof && pad_jffs2(w))
+			return -1;
 	}
 
-	DBG("firmware file \"%s\" completed", ofname);
+	if (!strip_padding)
+		return fw_write_pad_to(w, 0xff, layout->fw_max_len);
 
-	ret = EXIT_SUCCESS;
+	return 0;
+}
 
- out_flush:
-	fflush(f);
-	fclose(f);
-	if (ret != EXIT_SUCCESS) {
-		unlink(ofname);
-	}
- out:
-	return ret;
+static void md5_update(void *ctx, const void *buf, size_t len)
+{
+	MD5_Update(ctx, (unsigned char *) buf, len);
 }
 
 static int build_fw(void)
 {
-	int buflen;
-	char *buf;
-	char *p;
+	struct fw_header hdr;
+	struct fw_file kernel, rootfs;
+	struct fw_writer w;
+	MD5_CTX ctx;
+	FILE *f;
 	int ret = EXIT_FAILURE;
-	int writelen = 0;
 
-	buflen = layout->fw_max_len;
+	memset(&rootfs, 0, sizeof(rootfs));
 
-	buf = malloc(buflen);
-	if (!buf) {
-		ERR("no memory for buffer\n");
+	if (fw_file_map(&kernel, kernel_info.file_name)) {
+		ERRS("could not open \"%s\" for reading", kernel_info.file_name);
 		goto out;
 	}
 
-	memset(buf, 0xff, buflen);
-	p = buf + sizeof(struct fw_header);
-	ret = read_to_buf(&kernel_info, p);
-	if (ret)
-		goto out_free_buf;
-
-	writelen = sizeof(struct fw_header) + kernel_len;
-
-	if (!combined) {
-		if (rootfs_align)
-			p = buf + writelen;
-		else
-			p = buf + rootfs_ofs;
+	if (!combined && fw_file_map(&rootfs, rootfs_info.file_name)) {
+		ERRS("could not open \"%s\" for reading", rootfs_info.file_name);
+		goto out_unmap;
+	}
 
-		ret = read_to_buf(&rootfs_info, p);
-		if (ret)
-			goto out_free_buf;
+	fill_header(&hdr);
 
-		if (rootfs_align)
-			writelen += rootfs_info.file_size;
-		else
-			writelen = rootfs_ofs + rootfs_info.file_size;
+	MD5_Init(&ctx);
+	fw_writer_init(&w, NULL, md5_update, &ctx);
+	if (write_fw_data(&w, &hdr, &kernel, &rootfs)) {
+		ERR("invalid image layout");
+		goto out_unmap;
+	}
+	MD5_Final(hdr.md5sum1, &ctx);
 
-		if (add_jffs2_eof)
-			writelen = pad_jffs2(buf, writelen);
+	f = fopen(ofname, "w");
+	if (f == NULL) {
+		ERRS("could not open \"%s\" for writing", ofname);
+		goto out_unmap;
 	}
 
-	if (!strip_padding)
-		writelen = buflen;
+	fw_writer_init(&w, f, NULL, NULL);
+	if (write_fw_data(&w, &hdr, &kernel, &rootfs) || fflush(f)) {
+		ERRS("unable to write output file");
+		fclose(f);
+		unlink(ofname);
+		goto out_unmap;
+	}
+	fclose(f);
 
-	fill_header(buf, writelen);
-	ret = write_fw(buf, writelen);
-	if (ret)
-		goto out_free_buf;
+	DBG("firmware file \"%s\" completed", ofname);
 
 	ret = EXIT_SUCCESS;
 
- out_free_buf:
-	free(buf);
+ out_unmap:
+	fw_file_unmap(&rootfs);
+	fw_file_unmap(&kernel);
  out:
 	return ret;
 }
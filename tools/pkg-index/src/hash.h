@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2015 OpenWrt.org
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ *
+ */
+
+#ifndef __PKG_INDEX_HASH_H
+#define __PKG_INDEX_HASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct md5_ctx {
+	uint32_t state[4];
+	uint64_t len;
+	uint8_t buf[64];
+};
+
+struct sha256_ctx {
+	uint32_t state[8];
+	uint64_t len;
+	uint8_t buf[64];
+};
+
+void md5_init(struct md5_ctx *ctx);
+void md5_update(struct md5_ctx *ctx, const void *data, size_t len);
+void md5_final(struct md5_ctx *ctx, uint8_t *digest);
+
+void sha256_init(struct sha256_ctx *ctx);
+void sha256_update(struct sha256_ctx *ctx, const void *data, size_t len);
+void sha256_final(struct sha256_ctx *ctx, uint8_t *digest);
+
+#endif
@@ -0,0 +1,786 @@
+/*
+ * pkg-index - generate an opkg Packages index
+ *
+ * Copyright (C) 2015 OpenWrt.org
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ *
+ * Produces the same output as scripts/ipkg-make-index.sh, but reads every
+ * package only once: the MD5 and SHA256 sums are computed while the outer
+ * tar.gz is inflated just far enough to pull out control.tar.gz, which is
+ * then unpacked in memory.  Packages are indexed in parallel.
+ *
+ * With -p and -s, the previous Packages file is used as a cache.  The size,
+ * mtime, ctime and inode number of every package are recorded in the stamps
+ * file given with -s, together with the MD5Sum of the entry they belong to.
+ * It should be kept out of the package directory, which gets published.
+ * An entry is only reused if all of them still match
+ * exactly, the entry in the index is the one the stamp was taken for, and
+ * the package was not changed in the same second the stamps were taken
+ * (a later change within that second would not show in the times).
+ */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <zlib.h>
+
+#include "hash.h"
+
+#define BUF_LEN		(64 * 1024)
+#define TAR_BLOCK	512
+
+struct pkg {
+	char *path;
+	struct stat st;
+	char *entry;
+	size_t entry_len;
+	int reused;
+};
+
+struct prev_entry {
+	char *filename;
+	long long size;
+	char *md5sum;
+	char *text;
+	size_t len;
+
+	/* from the stamps file */
+	int stamped;
+	long long mtime, ctime;
+	unsigned long long ino;
+	char stamp_md5sum[33];
+};
+
+struct buf {
+	char *data;
+	size_t len;
+	size_t size;
+};
+
+struct tar_state {
+	const char *want;
+	uint8_t hdr[TAR_BLOCK];
+	size_t hpos;
+	uint64_t left;
+	uint64_t pad;
+	int capture;
+	int done;
+	struct buf data;
+};
+
+struct extract {
+	z_stream z;
+	struct tar_state tar;
+};
+
+static char *progname;
+
+static struct pkg *pkgs;
+static int n_pkgs, max_pkgs;
+static int next_pkg;
+static int failed;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+static struct prev_entry *prev;
+static int n_prev;
+static time_t stamp_time;
+
+#define ERR(fmt, ...) \
+	fprintf(stderr, "%s: " fmt "\n", progname, ## __VA_ARGS__)
+
+static int buf_add(struct buf *b, const void *data, size_t len)
+{
+	char *n;
+
+	if (b->len + len > b->size) {
+		b->size = (b->len + len) * 2 + 256;
+		n = realloc(b->data, b->size);
+		if (!n)
+			return -1;
+		b->data = n;
+	}
+
+	memcpy(b->data + b->len, data, len);
+	b->len += len;
+
+	return 0;
+}
+
+static int buf_str(struct buf *b, const char *str)
+{
+	return buf_add(b, str, strlen(str));
+}
+
+static const char *skip_dot(const char *name)
+{
+	return strncmp(name, "./", 2) ? name : name + 2;
+}
+
+static uint64_t tar_number(const uint8_t *p, int len)
+{
+	uint64_t val = 0;
+	int i;
+
+	/* base-256 encoding used by GNU tar for large values */
+	if (p[0] & 0x80) {
+		val = p[0] & 0x3f;
+		for (i = 1; i < len; i++)
+			val = (val << 8) | p[i];
+		return val;
+	}
+
+	for (i = 0; i < len && (p[i] == ' ' || p[i] == '0'); i++)
+		;
+
+	for (; i < len && p[i] >= '0' && p[i] <= '7'; i++)
+		val = (val << 3) | (p[i] - '0');
+
+	return val;
+}
+
+static void tar_header(struct tar_state *t)
+{
+	char name[TAR_BLOCK];
+	uint8_t type = t->hdr[156];
+	int i, len = 0;
+
+	for (i = 0; i < TAR_BLOCK && !t->hdr[i]; i++)
+		;
+
+	if (i == TAR_BLOCK) {
+		/* end of archive */
+		t->done = 1;
+		return;
+	}
+
+	if (!memcmp(t->hdr + 257, "ustar", 5) && t->hdr[345]) {
+		len = strnlen((char *) t->hdr + 345, 155);
+		memcpy(name, t->hdr + 345, len);
+		name[len++] = '/';
+	}
+
+	i = strnlen((char *) t->hdr, 100);
+	memcpy(name + len, t->hdr, i);
+	name[len + i] = 0;
+
+	t->left = tar_number(t->hdr + 124, 12);
+	t->pad = (TAR_BLOCK - (t->left % TAR_BLOCK)) % TAR_BLOCK;
+	t->capture = (type == '0' || type == 0) &&
+		     !strcmp(skip_dot(name), skip_dot(t->want));
+
+	if (t->capture && !t->left)
+		t->done = 1;
+}
+
+/*
+ * Feed uncompressed tar data, collecting the member named t->want.
+ * Sets t->done once that member is complete or the archive ends.
+ */
+static int tar_feed(struct tar_state *t, const uint8_t *p, size_t len)
+{
+	size_t n;
+
+	while (len && !t->done) {
+		if (t->left) {
+			n = len < t->left ? len : t->left;
+			if (t->capture && buf_add(&t->data, p, n))
+				return -1;
+			t->left -= n;
+			if (!t->left && t->capture)
+				t->done = 1;
+		} else if (t->pad) {
+			n = len < t->pad ? len : t->pad;
+			t->pad -= n;
+		} else {
+			n = TAR_BLOCK - t->hpos;
+			if (n > len)
+				n = len;
+			memcpy(t->hdr + t->hpos, p, n);
+			t->hpos += n;
+			if (t->hpos == TAR_BLOCK) {
+				t->hpos = 0;
+				tar_header(t);
+			}
+		}
+
+		p += n;
+		len -= n;
+	}
+
+	return 0;
+}
+
+static int extract_init(struct extract *x, const char *want)
+{
+	memset(x, 0, sizeof(*x));
+	x->tar.want = want;
+
+	/* gzip only */
+	return inflateInit2(&x->z, 16 + MAX_WBITS) == Z_OK ? 0 : -1;
+}
+
+static int extract_feed(struct extract *x, const void *data, size_t len)
+{
+	uint8_t out[16 * 1024];
+	int ret;
+
+	x->z.next_in = (Bytef *) data;
+	x->z.avail_in = len;
+
+	while (!x->tar.done) {
+		x->z.next_out = out;
+		x->z.avail_out = sizeof(out);
+
+		ret = inflate(&x->z, Z_NO_FLUSH);
+		if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+			return -1;
+
+		if (tar_feed(&x->tar, out, sizeof(out) - x->z.avail_out))
+			return -1;
+
+		if (ret == Z_STREAM_END)
+			x->tar.done = 1;
+		else if (!x->z.avail_in && x->z.avail_out)
+			break;
+	}
+
+	return 0;
+}
+
+static void extract_free(struct extract *x)
+{
+	inflateEnd(&x->z);
+	free(x->tar.data.data);
+}
+
+static void hex(char *out, const uint8_t *data, int len)
+{
+	static const char digits[] = "0123456789abcdef";
+	int i;
+
+	for (i = 0; i < len; i++) {
+		*out++ = digits[data[i] >> 4];
+		*out++ = digits[data[i] & 15];
+	}
+
+	*out = 0;
+}
+
+static int make_entry(struct pkg *p, const struct buf *ctrl,
+		      const char *md5sum, const char *sha256sum)
+{
+	struct buf b = { 0 };
+	const char *line = ctrl->data, *end = ctrl->data + ctrl->len, *nl;
+	char size[32];
+
+	snprintf(size, sizeof(size), "%lld", (long long) p->st.st_size);
+
+	while (line < end) {
+		nl = memchr(line, '\n', end - line);
+		nl = nl ? nl + 1 : end;
+
+		if (nl - line >= 12 && !memcmp(line, "Description:", 12) &&
+		    (buf_str(&b, "Filename: ") ||
+		     buf_str(&b, skip_dot(p->path)) ||
+		     buf_str(&b, "\nSize: ") ||
+		     buf_str(&b, size) ||
+		     buf_str(&b, "\nMD5Sum: ") ||
+		     buf_str(&b, md5sum) ||
+		     buf_str(&b, "\nSHA256sum: ") ||
+		     buf_str(&b, sha256sum) ||
+		     buf_str(&b, "\n")))
+			goto error;
+
+		if (buf_add(&b, line, nl - line))
+			goto error;
+
+		line = nl;
+	}
+
+	if (buf_str(&b, "\n"))
+		goto error;
+
+	p->entry = b.data;
+	p->entry_len = b.len;
+
+	return 0;
+
+error:
+	free(b.data);
+	return -1;
+}
+
+static int index_pkg(struct pkg *p, uint8_t *buf)
+{
+	struct extract outer, inner;
+	struct md5_ctx md5;
+	struct sha256_ctx sha256;
+	uint8_t digest[32];
+	char md5sum[33], sha256sum[65];
+	int fd, ret = -1;
+	ssize_t len;
+
+	fd = open(p->path, O_RDONLY);
+	if (fd < 0) {
+		ERR("cannot open %s: %s", p->path, strerror(errno));
+		return -1;
+	}
+
+	if (extract_init(&outer, "control.tar.gz"))
+		goto out_close;
+
+	md5_init(&md5);
+	sha256_init(&sha256);
+
+	while ((len = read(fd, buf, BUF_LEN)) > 0) {
+		md5_update(&md5, buf, len);
+		sha256_update(&sha256, buf, len);
+
+		if (!outer.tar.done && extract_feed(&outer, buf, len)) {
+			ERR("%s is not a valid package", p->path);
+			goto out_outer;
+		}
+	}
+
+	if (len < 0) {
+		ERR("cannot read %s: %s", p->path, strerror(errno));
+		goto out_outer;
+	}
+
+	if (!outer.tar.capture || outer.tar.left) {
+		ERR("%s does not contain control.tar.gz", p->path);
+		goto out_outer;
+	}
+
+	if (extract_init(&inner, "control"))
+		goto out_outer;
+
+	if (extract_feed(&inner, outer.tar.data.data, outer.tar.data.len) ||
+	    !inner.tar.capture || inner.tar.left) {
+		ERR("%s does not contain a control file", p->path);
+		goto out_inner;
+	}
+
+	md5_final(&md5, digest);
+	hex(md5sum, digest, 16);
+	sha256_final(&sha256, digest);
+	hex(sha256sum, digest, 32);
+
+	ret = make_entry(p, &inner.tar.data, md5sum, sha256sum);
+
+out_inner:
+	extract_free(&inner);
+out_outer:
+	extract_free(&outer);
+out_close:
+	close(fd);
+	return ret;
+}
+
+static void *worker(void *arg)
+{
+	uint8_t *buf = malloc(BUF_LEN);
+	struct pkg *p;
+
+	if (!buf) {
+		failed = 1;
+		return NULL;
+	}
+
+	while (1) {
+		pthread_mutex_lock(&lock);
+		while (next_pkg < n_pkgs && pkgs[next_pkg].reused)
+			next_pkg++;
+		p = (next_pkg < n_pkgs && !failed) ? &pkgs[next_pkg++] : NULL;
+		if (p)
+			fprintf(stderr, "Generating index for package %s\n", p->path);
+		pthread_mutex_unlock(&lock);
+
+		if (!p)
+			break;
+
+		if (index_pkg(p, buf))
+			failed = 1;
+	}
+
+	free(buf);
+	return NULL;
+}
+
+static int add_pkg(const char *path)
+{
+	const char *name = strrchr(path, '/');
+	struct pkg *n;
+	size_t len;
+
+	name = name ? name + 1 : path;
+	len = strcspn(name, "_");
+	if ((len == 6 && !strncmp(name, "kernel", 6)) ||
+	    (len == 4 && !strncmp(name, "libc", 4)))
+		return 0;
+
+	if (n_pkgs == max_pkgs) {
+		max_pkgs = max_pkgs ? max_pkgs * 2 : 256;
+		n = realloc(pkgs, max_pkgs * sizeof(*pkgs));
+		if (!n)
+			return -1;
+		pkgs = n;
+	}
+
+	memset(&pkgs[n_pkgs], 0, sizeof(*pkgs));
+	pkgs[n_pkgs].path = strdup(path);
+	if (!pkgs[n_pkgs].path)
+		return -1;
+
+	if (stat(path, &pkgs[n_pkgs].st)) {
+		ERR("cannot stat %s: %s", path, strerror(errno));
+		return -1;
+	}
+
+	n_pkgs++;
+	return 0;
+}
+
+static int scan_dir(const char *dir)
+{
+	struct dirent *e;
+	struct stat st;
+	char *path;
+	size_t len = strlen(dir);
+	int ret = 0;
+	DIR *d;
+
+	d = opendir(dir);
+	if (!d) {
+		ERR("cannot open %s: %s", dir, strerror(errno));
+		return -1;
+	}
+
+	while (!ret && (e = readdir(d)) != NULL) {
+		if (!strcmp(e->d_name, ".") || !strcmp(e->d_name, ".."))
+			continue;
+
+		path = malloc(len + strlen(e->d_name) + 2);
+		if (!path) {
+			ret = -1;
+			break;
+		}
+
+		sprintf(path, "%s%s%s", dir,
+			(len && dir[len - 1] == '/') ? "" : "/", e->d_name);
+
+		if (lstat(path, &st))
+			ret = -1;
+		else if (S_ISDIR(st.st_mode))
+			ret = scan_dir(path);
+		else if (!fnmatch("*.ipk", e->d_name, 0))
+			ret = add_pkg(path);
+
+		free(path);
+	}
+
+	closedir(d);
+	return ret;
+}
+
+static int cmp_pkg(const void *a, const void *b)
+{
+	return strcmp(((const struct pkg *) a)->path,
+		      ((const struct pkg *) b)->path);
+}
+
+static int cmp_prev(const void *a, const void *b)
+{
+	return strcmp(((const struct prev_entry *) a)->filename,
+		      ((const struct prev_entry *) b)->filename);
+}
+
+static char *field(const char *text, const char *end, const char *name)
+{
+	size_t len = strlen(name);
+	const char *line, *nl;
+
+	for (line = text; line < end; line = nl + 1) {
+		nl = memchr(line, '\n', end - line);
+		if (!nl)
+			nl = end;
+
+		if (nl - line > len && !memcmp(line, name, len))
+			return strndup(line + len, nl - line - len);
+	}
+
+	return NULL;
+}
+
+/*
+ * Load the entries of a previous index. The file is kept in memory, the
+ * entries point into it.
+ */
+static void load_prev(const char *file)
+{
+	struct prev_entry *e;
+	struct stat st;
+	char *data, *text, *end, *size;
+	int fd, max = 0;
+
+	fd = open(file, O_RDONLY);
+	if (fd < 0)
+		return;
+
+	if (fstat(fd, &st) || !st.st_size)
+		goto out;
+
+	data = malloc(st.st_size + 1);
+	if (!data || read(fd, data, st.st_size) != st.st_size) {
+		free(data);
+		goto out;
+	}
+
+	data[st.st_size] = 0;
+
+	for (text = data; *text; text = end + 2) {
+		end = strstr(text, "\n\n");
+		if (!end)
+			break;
+
+		if (n_prev == max) {
+			max = max ? max * 2 : 256;
+			e = realloc(prev, max * sizeof(*prev));
+			if (!e)
+				break;
+			prev = e;
+		}
+
+		e = &prev[n_prev];
+		memset(e, 0, sizeof(*e));
+		e->filename = field(text, end, "Filename: ");
+		e->md5sum = field(text, end, "MD5Sum: ");
+		size = field(text, end, "Size: ");
+		if (!e->filename || !e->md5sum || !size) {
+			free(e->filename);
+			free(e->md5sum);
+			free(size);
+			continue;
+		}
+
+		e->size = strtoll(size, NULL, 10);
+		e->text = text;
+		e->len = end + 2 - text;
+		free(size);
+		n_prev++;
+	}
+
+	qsort(prev, n_prev, sizeof(*prev), cmp_prev);
+
+out:
+	close(fd);
+}
+
+/*
+ * Load the stamps taken when the previous index was written. The first
+ * line holds the time they were taken, then there is one line per package:
+ * <size> <mtime> <ctime> <inode> <md5sum> <filename>
+ */
+static void load_stamps(const char *file)
+{
+	struct prev_entry key, *e;
+	char line[4096], md5sum[33];
+	long long size, mtime, ctime, t;
+	unsigned long long ino;
+	int n, len;
+	FILE *f;
+
+	f = fopen(file, "r");
+	if (!f)
+		return;
+
+	if (!fgets(line, sizeof(line), f) ||
+	    sscanf(line, "pkg-index-stamps 1 %lld", &t) != 1)
+		goto out;
+
+	stamp_time = t;
+
+	while (fgets(line, sizeof(line), f)) {
+		len = strlen(line);
+		if (!len || line[len - 1] != '\n')
+			continue;
+		line[len - 1] = 0;
+
+		if (sscanf(line, "%lld %lld %lld %llu %32s %n",
+			   &size, &mtime, &ctime, &ino, md5sum, &n) != 5 || !line[n])
+			continue;
+
+		key.filename = line + n;
+		e = bsearch(&key, prev, n_prev, sizeof(*prev), cmp_prev);
+		if (!e || e->size != size)
+			continue;
+
+		e->stamped = 1;
+		e->mtime = mtime;
+		e->ctime = ctime;
+		e->ino = ino;
+		strcpy(e->stamp_md5sum, md5sum);
+	}
+
+out:
+	fclose(f);
+}
+
+static int write_stamps(const char *file, time_t now)
+{
+	char tmp[4096], *md5sum;
+	struct pkg *p;
+	FILE *f;
+	int i;
+
+	if (snprintf(tmp, sizeof(tmp), "%s.tmp", file) >= sizeof(tmp))
+		return -1;
+
+	f = fopen(tmp, "w");
+	if (!f)
+		return -1;
+
+	fprintf(f, "pkg-index-stamps 1 %lld\n", (long long) now);
+
+	for (i = 0; i < n_pkgs; i++) {
+		p = &pkgs[i];
+		md5sum = field(p->entry, p->entry + p->entry_len, "MD5Sum: ");
+		if (!md5sum)
+			continue;
+
+		fprintf(f, "%lld %lld %lld %llu %s %s\n",
+			(long long) p->st.st_size, (long long) p->st.st_mtime,
+			(long long) p->st.st_ctime, (unsigned long long) p->st.st_ino,
+			md5sum, skip_dot(p->path));
+		free(md5sum);
+	}
+
+	if (fclose(f) || rename(tmp, file)) {
+		unlink(tmp);
+		return -1;
+	}
+
+	return 0;
+}
+
+static void reuse_prev(struct pkg *p)
+{
+	struct prev_entry key, *e;
+
+	key.filename = (char *) skip_dot(p->path);
+	e = bsearch(&key, prev, n_prev, sizeof(*prev), cmp_prev);
+	if (!e || !e->stamped ||
+	    e->size != p->st.st_size ||
+	    e->mtime != p->st.st_mtime ||
+	    e->ctime != p->st.st_ctime ||
+	    e->ino != p->st.st_ino ||
+	    p->st.st_mtime >= stamp_time ||
+	    p->st.st_ctime >= stamp_time ||
+	    strcmp(e->md5sum, e->stamp_md5sum))
+		return;
+
+	p->entry = e->text;
+	p->entry_len = e->len;
+	p->reused = 1;
+}
+
+static void usage(void)
+{
+	fprintf(stderr,
+		"Usage: %s [-j <jobs>] [-p <previous index> -s <stamps file>] <package_directory>\n",
+		progname);
+	exit(1);
+}
+
+int main(int argc, char **argv)
+{
+	const char *prev_file = NULL, *stamps = NULL;
+	pthread_t *threads;
+	time_t now;
+	long jobs = 0;
+	int ch, i;
+
+	progname = argv[0];
+	now = time(NULL);
+
+	while ((ch = getopt(argc, argv, "j:p:s:")) != -1) {
+		switch (ch) {
+		case 'j':
+			jobs = strtol(optarg, NULL, 0);
+			break;
+		case 'p':
+			prev_file = optarg;
+			break;
+		case 's':
+			stamps = optarg;
+			break;
+		default:
+			usage();
+		}
+	}
+
+	if (optind + 1 != argc || !prev_file != !stamps)
+		usage();
+
+	if (scan_dir(argv[optind]))
+		return 1;
+
+	qsort(pkgs, n_pkgs, sizeof(*pkgs), cmp_pkg);
+
+	if (prev_file) {
+		load_prev(prev_file);
+		load_stamps(stamps);
+		for (i = 0; i < n_pkgs; i++)
+			reuse_prev(&pkgs[i]);
+	}
+
+	if (jobs <= 0)
+		jobs = sysconf(_SC_NPROCESSORS_ONLN);
+	if (jobs <= 0)
+		jobs = 1;
+	if (jobs > n_pkgs)
+		jobs = n_pkgs ? n_pkgs : 1;
+
+	threads = calloc(jobs, sizeof(*threads));
+	if (!threads)
+		return 1;
+
+	for (i = 0; i < jobs; i++) {
+		if (pthread_create(&threads[i], NULL, worker, NULL)) {
+			ERR("cannot create thread");
+			return 1;
+		}
+	}
+
+	for (i = 0; i < jobs; i++)
+		pthread_join(threads[i], NULL);
+
+	if (failed)
+		return 1;
+
+	for (i = 0; i < n_pkgs; i++)
+		fwrite(pkgs[i].entry, 1, pkgs[i].entry_len, stdout);
+
+	if (fflush(stdout))
+		return 1;
+
+	/* a stale stamps file is harmless, the MD5Sum ties it to its index */
+	if (prev_file && write_stamps(stamps, now))
+		ERR("cannot write %s: %s", stamps, strerror(errno));
+
+	return 0;
+}
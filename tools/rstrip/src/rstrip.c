@@ -0,0 +1,541 @@
+/*
+ * rstrip - strip all ELF files in a directory tree
+ *
+ * Copyright (C) 2015 OpenWrt.org
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 as published
+ * by the Free Software Foundation.
+ *
+ * Native replacement for the loop in scripts/rstrip.sh, using the same
+ * environment: executables and shared objects are stripped with $STRIP,
+ * relocatable objects (kernel modules) with $STRIP_KMOD.  ELF files are
+ * recognized by their header and stripped by up to $RSTRIP_JOBS parallel
+ * worker processes (default: number of CPUs).
+ *
+ * If $RSTRIP_CACHE names a directory, stripped outputs are kept there,
+ * keyed by a hash of the strip command, the tools it runs and the
+ * unstripped contents.  A
+ * file that has been stripped before is replaced by the cached output,
+ * and a file that already is a known stripped output is left alone.
+ * Cache entries that have not been used for CACHE_MAX_AGE are removed,
+ * at most once a day.
+ */
+
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <utime.h>
+
+#define EI_NIDENT	16
+#define ET_REL		1
+#define ET_EXEC		2
+#define ET_DYN		3
+
+#define CACHE_MAX_AGE		(14 * 24 * 60 * 60)
+#define CACHE_PRUNE_INTERVAL	(24 * 60 * 60)
+
+enum {
+	TYPE_NONE,
+	TYPE_EXEC,
+	TYPE_SHARED,
+	TYPE_REL,
+};
+
+static const char *type_names[] = {
+	[TYPE_EXEC] = "executable",
+	[TYPE_SHARED] = "shared object",
+	[TYPE_REL] = "relocatable",
+};
+
+struct entry {
+	char *name;
+	unsigned char type;
+};
+
+static char *progname;
+static const char *strip_cmd, *strip_kmod, *cache_dir;
+static uint64_t strip_hash, kmod_hash;
+static int jobs, running;
+
+static int elf_type(const char *path)
+{
+	unsigned char hdr[EI_NIDENT + 2];
+	unsigned int type;
+	int fd, len;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return TYPE_NONE;
+
+	len = read(fd, hdr, sizeof(hdr));
+	close(fd);
+
+	if (len != sizeof(hdr) || memcmp(hdr, "\177ELF", 4))
+		return TYPE_NONE;
+
+	/* EI_DATA: 1 = little endian, 2 = big endian */
+	if (hdr[5] == 1)
+		type = hdr[16] | (hdr[17] << 8);
+	else if (hdr[5] == 2)
+		type = (hdr[16] << 8) | hdr[17];
+	else
+		return TYPE_NONE;
+
+	switch (type) {
+	case ET_EXEC:
+		return TYPE_EXEC;
+	case ET_DYN:
+		return TYPE_SHARED;
+	case ET_REL:
+		return TYPE_REL;
+	default:
+		return TYPE_NONE;
+	}
+}
+
+static char *read_file(const char *path, size_t *len)
+{
+	struct stat st;
+	char *data;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return NULL;
+
+	if (fstat(fd, &st) || !(data = malloc(st.st_size + 1))) {
+		close(fd);
+		return NULL;
+	}
+
+	if (read(fd, data, st.st_size) != st.st_size) {
+		free(data);
+		data = NULL;
+	}
+
+	close(fd);
+	*len = st.st_size;
+
+	return data;
+}
+
+/* write data to a temporary file next to path and rename it over path */
+static int write_file(const char *path, const char *data, size_t len, mode_t mode)
+{
+	char tmp[PATH_MAX];
+	ssize_t r;
+	int fd;
+
+	snprintf(tmp, sizeof(tmp), "%s.rstrip.%d", path, (int) getpid());
+
+	fd = open(tmp, O_WRONLY | O_CREAT | O_EXCL, mode);
+	if (fd < 0)
+		return -1;
+
+	while (len > 0) {
+		r = write(fd, data, len);
+		if (r < 0) {
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		data += r;
+		len -= r;
+	}
+
+	if (len || fchmod(fd, mode)) {
+		close(fd);
+		unlink(tmp);
+		return -1;
+	}
+
+	if (close(fd) || rename(tmp, path)) {
+		unlink(tmp);
+		return -1;
+	}
+
+	return 0;
+}
+
+/* 64 bit FNV-1a */
+static uint64_t hash(uint64_t h, const void *data, size_t len)
+{
+	const unsigned char *p = data;
+
+	while (len--)
+		h = (h ^ *p++) * 0x100000001b3ULL;
+
+	return h;
+}
+
+/* identify a tool by where it is found in $PATH, its size and mtime */
+static uint64_t hash_tool(uint64_t h, const char *name, size_t len)
+{
+	const char *path = getenv("PATH");
+	char file[PATH_MAX];
+	struct stat st;
+	size_t dlen;
+
+	if (!len || len >= sizeof(file))
+		return h;
+
+	if (memchr(name, '/', len) || !path) {
+		snprintf(file, sizeof(file), "%.*s", (int) len, name);
+		if (stat(file, &st))
+			return hash(h, "", 1);
+	} else {
+		while (1) {
+			dlen = strcspn(path, ":");
+			snprintf(file, sizeof(file), "%.*s/%.*s",
+				 dlen ? (int) dlen : 1, dlen ? path : ".",
+				 (int) len, name);
+			if (!stat(file, &st) && S_ISREG(st.st_mode) &&
+			    !access(file, X_OK))
+				break;
+			if (!path[dlen])
+				return hash(h, "", 1);
+			path += dlen + 1;
+		}
+	}
+
+	h = hash(h, file, strlen(file) + 1);
+	h = hash(h, &st.st_size, sizeof(st.st_size));
+	h = hash(h, &st.st_mtime, sizeof(st.st_mtime));
+
+	return h;
+}
+
+/* everything besides the input that affects the output of a strip command */
+static uint64_t cmd_hash(const char *cmd)
+{
+	static const char *env[] = { "CROSS", "NO_RENAME", "KEEP_SYMBOLS" };
+	static const char *cross_tools[] = { "objcopy", "nm" };
+	uint64_t h = 0xcbf29ce484222325ULL;
+	const char *val, *prog;
+	char tool[PATH_MAX];
+	int i;
+
+	h = hash(h, cmd, strlen(cmd) + 1);
+
+	/* the strip binary or script itself */
+	prog = cmd + strspn(cmd, " \t");
+	h = hash_tool(h, prog, strcspn(prog, " \t"));
+
+	for (i = 0; i < sizeof(env) / sizeof(env[0]); i++) {
+		val = getenv(env[i]);
+		if (val)
+			h = hash(h, val, strlen(val));
+		h = hash(h, "", 1);
+	}
+
+	/* used by strip-kmod.sh */
+	val = getenv("CROSS");
+	for (i = 0; val && i < sizeof(cross_tools) / sizeof(cross_tools[0]); i++) {
+		snprintf(tool, sizeof(tool), "%s%s", val, cross_tools[i]);
+		h = hash_tool(h, tool, strlen(tool));
+	}
+
+	return h;
+}
+
+static void cache_key(char *key, uint64_t h, const char *data, size_t len)
+{
+	h = hash(h, data, len);
+
+	sprintf(key, "%016llx-%llx", (unsigned long long) h,
+		(unsigned long long) len);
+}
+
+static int run_strip(const char *cmd, const char *path)
+{
+	char *script;
+	int status;
+	pid_t pid;
+
+	if (asprintf(&script, "%s \"$1\"", cmd) < 0)
+		return -1;
+
+	pid = fork();
+	if (pid < 0)
+		return -1;
+
+	if (!pid) {
+		execl("/bin/sh", "sh", "-c", script, "sh", path, NULL);
+		_exit(127);
+	}
+
+	free(script);
+
+	if (waitpid(pid, &status, 0) != pid)
+		return -1;
+
+	return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static int strip_file(const char *path, int type)
+{
+	const char *cmd = type == TYPE_REL ? strip_kmod : strip_cmd;
+	uint64_t h = type == TYPE_REL ? kmod_hash : strip_hash;
+	char key[64], out_key[64], file[PATH_MAX];
+	char *data = NULL, *out;
+	size_t len, out_len;
+	struct stat st;
+
+	if (!cmd || !*cmd || stat(path, &st))
+		return 0;
+
+	if (cache_dir) {
+		data = read_file(path, &len);
+		if (!data)
+			return 1;
+
+		cache_key(key, h, data, len);
+		free(data);
+
+		/* already a stripped output */
+		snprintf(file, sizeof(file), "%s/%s.stripped", cache_dir, key);
+		if (!utime(file, NULL))
+			return 0;
+
+		/* stripped before, reuse the output */
+		snprintf(file, sizeof(file), "%s/%s", cache_dir, key);
+		data = read_file(file, &len);
+		if (data) {
+			utime(file, NULL);
+			if (write_file(path, data, len, st.st_mode & 07777))
+				fprintf(stderr, "%s: failed to update %s\n", progname, path);
+			free(data);
+			return 0;
+		}
+	}
+
+	if (run_strip(cmd, path)) {
+		fprintf(stderr, "%s: failed to strip %s\n", progname, path);
+		chmod(path, st.st_mode & 07777);
+		return 0;
+	}
+
+	if (chmod(path, st.st_mode & 07777))
+		return 1;
+
+	if (!cache_dir)
+		return 0;
+
+	out = read_file(path, &out_len);
+	if (!out)
+		return 0;
+
+	write_file(file, out, out_len, 0644);
+
+	cache_key(out_key, h, out, out_len);
+	snprintf(file, sizeof(file), "%s/%s.stripped", cache_dir, out_key);
+	close(open(file, O_WRONLY | O_CREAT, 0644));
+
+	free(out);
+	return 0;
+}
+
+/* remove cache entries that have not been used for CACHE_MAX_AGE */
+static void prune_cache(void)
+{
+	char file[PATH_MAX];
+	time_t now = time(NULL);
+	struct dirent *e;
+	struct stat st;
+	DIR *d;
+
+	snprintf(file, sizeof(file), "%s/.pruned", cache_dir);
+	if (!stat(file, &st) && now - st.st_mtime < CACHE_PRUNE_INTERVAL)
+		return;
+
+	close(open(file, O_WRONLY | O_CREAT, 0644));
+	utime(file, NULL);
+
+	d = opendir(cache_dir);
+	if (!d)
+		return;
+
+	while ((e = readdir(d)) != NULL) {
+		if (e->d_name[0] == '.')
+			continue;
+
+		snprintf(file, sizeof(file), "%s/%s", cache_dir, e->d_name);
+		if (!stat(file, &st) && now - st.st_mtime > CACHE_MAX_AGE)
+			unlink(file);
+	}
+
+	closedir(d);
+}
+
+static void reap(void)
+{
+	int status;
+
+	if (wait(&status) > 0)
+		running--;
+}
+
+static void add_file(const char *path, int type)
+{
+	pid_t pid;
+
+	printf("rstrip.sh: %s:%s\n", path, type_names[type]);
+	fflush(stdout);
+
+	while (running >= jobs)
+		reap();
+
+	pid = fork();
+	if (pid < 0) {
+		strip_file(path, type);
+		return;
+	}
+
+	if (!pid)
+		_exit(strip_file(path, type));
+
+	running++;
+}
+
+static int cmp_entry(const void *a, const void *b)
+{
+	return strcmp(((const struct entry *) a)->name,
+		      ((const struct entry *) b)->name);
+}
+
+/*
+ * The directory is read completely before any file in it is handed to a
+ * worker, so that temporary files created by the strip commands are not
+ * picked up as inputs.
+ */
+static void scan(const char *path)
+{
+	struct entry *list = NULL, *tmp;
+	int i, n = 0, size = 0;
+	char sub[PATH_MAX];
+	struct dirent *e;
+	struct stat st;
+	DIR *d;
+
+	if (lstat(path, &st))
+		return;
+
+	if (S_ISREG(st.st_mode)) {
+		i = elf_type(path);
+		if (i != TYPE_NONE)
+			add_file(path, i);
+		return;
+	}
+
+	if (!S_ISDIR(st.st_mode))
+		return;
+
+	d = opendir(path);
+	if (!d)
+		return;
+
+	while ((e = readdir(d)) != NULL) {
+		if (!strcmp(e->d_name, ".") || !strcmp(e->d_name, ".."))
+			continue;
+
+		snprintf(sub, sizeof(sub), "%s/%s", path, e->d_name);
+		if (lstat(sub, &st))
+			continue;
+
+		if (n == size) {
+			size = size ? size * 2 : 16;
+			tmp = realloc(list, size * sizeof(*list));
+			if (!tmp)
+				break;
+			list = tmp;
+		}
+
+		if (S_ISDIR(st.st_mode))
+			list[n].type = TYPE_NONE;
+		else if (S_ISREG(st.st_mode))
+			list[n].type = elf_type(sub);
+		else
+			continue;
+
+		if (!S_ISDIR(st.st_mode) && list[n].type == TYPE_NONE)
+			continue;
+
+		list[n].name = strdup(e->d_name);
+		if (list[n].name)
+			n++;
+	}
+
+	closedir(d);
+
+	qsort(list, n, sizeof(*list), cmp_entry);
+
+	for (i = 0; i < n; i++) {
+		snprintf(sub, sizeof(sub), "%s/%s", path, list[i].name);
+		if (list[i].type == TYPE_NONE)
+			scan(sub);
+		else
+			add_file(sub, list[i].type);
+		free(list[i].name);
+	}
+
+	free(list);
+}
+
+int main(int argc, char **argv)
+{
+	const char *val;
+	int i;
+
+	progname = argv[0];
+
+	strip_cmd = getenv("STRIP");
+	strip_kmod = getenv("STRIP_KMOD");
+
+	if (!strip_cmd || !*strip_cmd) {
+		fprintf(stderr, "%s: strip command not defined (STRIP variable not set)\n",
+			progname);
+		return 1;
+	}
+
+	if (argc < 2) {
+		fprintf(stderr, "%s: no directories / files specified\n", progname);
+		fprintf(stderr, "usage: %s [PATH...]\n", progname);
+		return 1;
+	}
+
+	val = getenv("RSTRIP_JOBS");
+	jobs = val ? atoi(val) : sysconf(_SC_NPROCESSORS_ONLN);
+	if (jobs < 1)
+		jobs = 1;
+
+	val = getenv("RSTRIP_CACHE");
+	if (val && *val && (!mkdir(val, 0755) || errno == EEXIST))
+		cache_dir = val;
+
+	if (cache_dir) {
+		prune_cache();
+		strip_hash = cmd_hash(strip_cmd);
+		if (strip_kmod && *strip_kmod)
+			kmod_hash = cmd_hash(strip_kmod);
+	}
+
+	for (i = 1; i < argc; i++)
+		scan(argv[i]);
+
+	while (running > 0)
+		reap();
+
+	return 0;
+}